@@ -51,6 +51,9 @@ namespace Seeta.AIP
             U8Rgba = 1003,
             U8Bgra = 1004,
             U8Y = 1005,
+            U8Nv12 = 1006,
+            U8Nv21 = 1007,
+            U8I420 = 1008,
         }
 
         [StructLayout(LayoutKind.Sequential)]
@@ -189,6 +192,11 @@ namespace Seeta.AIP
             [MarshalAs(UnmanagedType.FunctionPtr)] public seeta_aip_tag tag;
             [MarshalAs(UnmanagedType.FunctionPtr)] public seeta_aip_get get;
             [MarshalAs(UnmanagedType.FunctionPtr)] public seeta_aip_set set;
+
+            public IntPtr forward_async; // appended entry, not used in C#
+            public IntPtr forward_batch; // appended entry, not used in C#
+            public IntPtr forward_into; // appended entry, not used in C#
+            public IntPtr set_executor; // appended entry, not used in C#
         }
 
         public enum LoadError
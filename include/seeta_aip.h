@@ -45,6 +45,14 @@ enum SEETA_AIP_IMAGE_FORMAT {
     SEETA_AIP_FORMAT_U8BGRA = 1004, ///< byte format for BGRA8888
     SEETA_AIP_FORMAT_U8Y = 1005,    ///< byte format for gray image
 
+    /**
+     * YUV 4:2:0 formats with even width and height, channels is 1.
+     * The Y plane with height x width bytes comes first, so one image has height * width * 3 / 2 bytes.
+     */
+    SEETA_AIP_FORMAT_U8NV12 = 1006, ///< Y plane, then interleaved UV plane
+    SEETA_AIP_FORMAT_U8NV21 = 1007, ///< Y plane, then interleaved VU plane
+    SEETA_AIP_FORMAT_U8I420 = 1008, ///< Y plane, then U plane, then V plane
+
     /**
      * Notice: CHW format may not fully supported, use format above recommended.
      */
@@ -217,6 +225,22 @@ struct SeetaAIPImageData {
     uint32_t channels;              ///< channels of image
 };
 
+/**
+ * \brief ImageData with strides.
+ * The leading members are same as SeetaAIPImageData, so it is readable as SeetaAIPImageData if packed.
+ * Zero strides mean packed, so SeetaAIPImageData with zero strides appended is a valid SeetaAIPImageDataV2.
+ */
+struct SeetaAIPImageDataV2 {
+    int32_t format;                 ///< SEETA_AIP_IMAGE_FORMAT, image format
+    void *data;                     ///< pointer to the first pixel
+    uint32_t number;                ///< number of data
+    uint32_t height;                ///< height of image
+    uint32_t width;                 ///< width of image
+    uint32_t channels;              ///< channels of image
+    uint32_t row_stride;            ///< bytes between two rows, 0 for packed rows
+    uint32_t image_stride;          ///< bytes between two images, 0 for packed images
+};
+
 struct SeetaAIPStruct;
 /**
  * AIP handle
@@ -238,6 +262,7 @@ enum SEETA_AIP_COMMON_ERRORCODE {
     SEETA_AIP_ERROR_MISMATCH_REQUIRED_INPUT_OBJECT = 0x100b,
     SEETA_AIP_ERROR_NULLPTR = 0x100c,
     SEETA_AIP_ERROR_WRITE_READONLY_PROPERTY = 0x100d,
+    SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH = 0x100e,
 };
 
 /**
@@ -303,6 +328,159 @@ typedef int32_t SEETA_AIP_CALL seeta_aip_forward(
         struct SeetaAIPImageData **result_images,
         uint32_t *result_images_size);
 
+/**
+ * Completion callback of seeta_aip_forward_async
+ * @param [in] userdata the userdata given in seeta_aip_forward_async
+ * @param [in] errcode error code, zero for succeed.
+ * @param [in] result_objects
+ * @param [in] result_objects_size
+ * @param [in] result_images
+ * @param [in] result_images_size
+ * @note all the results are borrowed value, only valid in callback, copy them if needed after callback
+ * @note if errcode is not zero, seeta_aip_error(aip, -1) returns the error message inside callback
+ * @note DO NOT free the aip inside callback
+ */
+typedef void SEETA_AIP_CALL seeta_aip_forward_callback(
+        void *userdata,
+        int32_t errcode,
+        const struct SeetaAIPObject *result_objects, uint32_t result_objects_size,
+        const struct SeetaAIPImageData *result_images, uint32_t result_images_size);
+
+/**
+ * Submit forward request, return immediately. callback will be called in AIP's worker thread once finished.
+ * @param [in] aip The AIP Handle
+ * @param [in] method_id
+ * @param [in] images
+ * @param [in] images_size
+ * @param [in] objects
+ * @param [in] objects_size
+ * @param [in] callback called once the request finished, succeed or not
+ * @param [in] userdata passed to callback
+ * @return error code, zero for succeed submitted.
+ * @note the arrays of images and objects are copied, but the data they pointed must be kept until callback called
+ * @note requests on same aip are processed in submitted order, and serialized with seeta_aip_forward
+ * @note each request has its own result, the borrowed result of seeta_aip_forward is not overwritten by requests
+ * @note callback will not be called if submit failed
+ * @note seeta_aip_free waits all submitted requests finished
+ */
+typedef int32_t SEETA_AIP_CALL seeta_aip_forward_async(
+        SeetaAIPHandle aip,
+        uint32_t method_id,
+        const struct SeetaAIPImageData *images, uint32_t images_size,
+        const struct SeetaAIPObject *objects, uint32_t objects_size,
+        seeta_aip_forward_callback *callback, void *userdata);
+
+/**
+ * \brief one request of seeta_aip_forward_batch, same as arguments of seeta_aip_forward
+ */
+struct SeetaAIPForwardRequest {
+    uint32_t method_id;
+    const struct SeetaAIPImageData *images;
+    uint32_t images_size;
+    const struct SeetaAIPObject *objects;
+    uint32_t objects_size;
+};
+
+/**
+ * \brief result of each request in seeta_aip_forward_batch
+ */
+struct SeetaAIPForwardResult {
+    struct SeetaAIPObject *objects;
+    uint32_t objects_size;
+    struct SeetaAIPImageData *images;
+    uint32_t images_size;
+};
+
+/**
+ * Forward many independent requests in one call.
+ * @param [in] aip The AIP Handle
+ * @param [in] requests
+ * @param [in] requests_size
+ * @param [out] results array with requests_size results, each result is matched to the request in same index
+ * @return error code, zero for succeed. if any request failed, the whole batch failed.
+ * @note all the return value should be borrowed value, no need to free outside
+ */
+typedef int32_t SEETA_AIP_CALL seeta_aip_forward_batch(
+        SeetaAIPHandle aip,
+        const struct SeetaAIPForwardRequest *requests, uint32_t requests_size,
+        struct SeetaAIPForwardResult **results);
+
+/**
+ * Forward into caller provided buffers, to avoid copying result images.
+ * @param [in] aip The AIP Handle
+ * @param [in] method_id
+ * @param [in] images
+ * @param [in] images_size
+ * @param [in] objects
+ * @param [in] objects_size
+ * @param [in,out] result_objects points to caller array, or NULL array to get borrowed array
+ * @param [in] result_objects_capacity size of caller array
+ * @param [out] result_objects_size number of result objects
+ * @param [in,out] result_images points to caller pre-allocated images, or NULL array to get borrowed array.
+ *                 each format, shape and data describe a buffer, NULL data to get borrowed image.
+ * @param [in] result_images_capacity size of caller array
+ * @param [out] result_images_size number of result images
+ * @return error code, zero for succeed.
+ *         SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH if number of results exceeds caller array's capacity,
+ *         or any result image not fits its buffer, with same format and enough memory.
+ * @note if i-th result image fits i-th caller buffer, it is written into buffer.
+ * @note if SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH returned, the result sizes are set to needed sizes,
+ *       each descriptor within capacity is set to needed format and shape, with data unchanged.
+ * @note data pointed by result objects are borrowed value, no need to free outside
+ */
+typedef int32_t SEETA_AIP_CALL seeta_aip_forward_into(
+        SeetaAIPHandle aip,
+        uint32_t method_id,
+        const struct SeetaAIPImageData *images, uint32_t images_size,
+        const struct SeetaAIPObject *objects, uint32_t objects_size,
+        struct SeetaAIPObject **result_objects, uint32_t result_objects_capacity, uint32_t *result_objects_size,
+        struct SeetaAIPImageData **result_images, uint32_t result_images_capacity, uint32_t *result_images_size);
+
+/**
+ * Task run by executor, process items in [first, last).
+ * @param [in] data userdata passed to parallel_for
+ * @param [in] first
+ * @param [in] last
+ * @note task must not throw
+ */
+typedef void SEETA_AIP_CALL seeta_aip_executor_task(void *data, int32_t first, int32_t last);
+
+/**
+ * Run `task` over [begin, end) in chunks, return after all items done.
+ * @param [in] context executor context
+ * @param [in] begin first item
+ * @param [in] end last item (not included)
+ * @param [in] threads most threads used at same time, caller included, 0 for all threads of executor
+ * @param [in] task
+ * @param [in] data userdata passed to task
+ */
+typedef void SEETA_AIP_CALL seeta_aip_executor_parallel_for(
+        void *context, int32_t begin, int32_t end, int32_t threads,
+        seeta_aip_executor_task *task, void *data);
+
+/**
+ * @param [in] context executor context
+ * @return most threads could run tasks at same time, caller included
+ */
+typedef int32_t SEETA_AIP_CALL seeta_aip_executor_concurrency(void *context);
+
+/**
+ * \brief executor provided by host, shared with AIPs so one process has one bounded set of worker threads
+ */
+struct SeetaAIPExecutor {
+    void *context;
+    seeta_aip_executor_parallel_for *parallel_for;
+    seeta_aip_executor_concurrency *concurrency;
+};
+
+/**
+ * Share host's executor with AIP, then image processing in AIP runs on it.
+ * @param [in] aip The AIP Handle
+ * @param [in] executor NULL for AIP's own threads. Must be valid until AIP freed or another executor set.
+ * @return error code, zero for succeed.
+ */
+typedef int32_t SEETA_AIP_CALL seeta_aip_set_executor(SeetaAIPHandle aip, const struct SeetaAIPExecutor *executor);
+
 /**
  * @param [in] aip The AIP Handle
  * @return C-style array of C-style string, end with NULL, example {"number_threads", "min_face_size", NULL}
@@ -398,6 +576,14 @@ struct SeetaAIP {
     seeta_aip_tag *tag;         ///< get readable tag
     seeta_aip_get *get;         ///< get AIP's property
     seeta_aip_set *set;         ///< set AIP's property
+
+    /**
+     * Following entries are appended after version 2, could be NULL if AIP not support.
+     */
+    seeta_aip_forward_async *forward_async; ///< submit forward request, result returned by callback
+    seeta_aip_forward_batch *forward_batch; ///< forward many requests in one call
+    seeta_aip_forward_into *forward_into;   ///< forward into caller provided buffers
+    seeta_aip_set_executor *set_executor;   ///< share host's executor
 };
 
 enum SEETA_AIP_LOAD_ERROR {
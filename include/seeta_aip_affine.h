@@ -7,6 +7,10 @@
 
 #include "seeta_aip_graphics2d.h"
 #include "seeta_aip_struct.h"
+#include "seeta_aip_executor.h"
+#include "seeta_aip_simd.h"
+#include "seeta_aip_resize.h"
+#include "seeta_aip_rotate.h"
 
 #include <iostream>
 
@@ -36,7 +40,7 @@ namespace seeta {
              * @param height
              * @return
              */
-            bool GetSampleRatio(
+            static inline bool GetSampleRatio(
                     LineSampleRatio *ratio,
                     float x, float y, int32_t width, int32_t height) {
                 *ratio = LineSampleRatio();
@@ -48,7 +52,7 @@ namespace seeta {
                 if (x < 0) {
                     ratio->r1 = ratio->r3 = 1 + x;
                 } else if (x >= float(width - 1)) {
-                    ratio->r0 = ratio->r2 = float(width + 1) - x;
+                    ratio->r0 = ratio->r2 = float(width) - x;
                 } else {
                     auto left = int32_t(floorf(x));
                     auto right = left + 1;
@@ -62,7 +66,7 @@ namespace seeta {
                     ratio->r3 *= r23;
                     ratio->r0 = ratio->r1 = 0;
                 } else if (y >= float(height - 1)) {
-                    auto r01 = float(height + 1) - y;
+                    auto r01 = float(height) - y;
                     ratio->r0 *= r01;
                     ratio->r1 *= r01;
                     ratio->r2 = ratio->r3 = 0;
@@ -86,138 +90,379 @@ namespace seeta {
             }
         }
 
-        static inline void sample_uint8_pixel(
-                SeetaAIPImageData image,
-                float x, float y, uint8_t *out,
-                uint32_t out_shift) {
-            auto N = int32_t(image.number);
-            auto H = int32_t(image.height);
-            auto W = int32_t(image.width);
-            auto C = int32_t(image.channels);
-
-            _::LineSampleRatio ratio;
-            bool need_sample = _::GetSampleRatio(&ratio, x, y, W, H);
-            if (!need_sample) {
-                for (decltype(N) n = 0; n < N; ++n) {
-                    std::memset(out, 0, C);
-                    out += out_shift;
+        namespace _ {
+            /**
+             * Planes sampled by affine, each plane has `channels` interleaved channels.
+             * HWC image is `number` planes, CHW image is `number * channels` planes of 1 channel.
+             */
+            struct AffinePlanes {
+                const uint8_t *data;
+                int32_t number;         ///< number of planes
+                size_t image_stride;    ///< bytes between planes
+                size_t row_stride;      ///< bytes between rows
+                int32_t width;
+                int32_t height;
+                int32_t channels;
+            };
+
+            /**
+             * @return image as `number` planes of `image.channels` channels
+             */
+            static inline AffinePlanes image_planes(const ImageView &image) {
+                AffinePlanes planes = {reinterpret_cast<const uint8_t *>(image.data),
+                                       int32_t(image.number),
+                                       ImageData::GetImageStride(image),
+                                       ImageData::GetRowStride(image),
+                                       int32_t(image.width), int32_t(image.height), int32_t(image.channels)};
+                return planes;
+            }
+
+            /**
+             * @param image packed if CHW format
+             * @return image as planes, each channel of CHW image is one plane
+             */
+            static inline AffinePlanes affine_planes(const ImageView &image) {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                auto planes = image_planes(image);
+                planes.channels = int32_t(ImageData::GetChannels(format, image.channels));
+                if ((format & 0xffff0000) == 0x80000) {
+                    planes.number *= planes.channels;
+                    planes.channels = 1;
+                    planes.row_stride = size_t(planes.width) * ImageData::GetElementWidth(format);
+                    planes.image_stride = planes.row_stride * size_t(planes.height);
                 }
-                return;
+                return planes;
+            }
+
+            /**
+             * Round to nearest, not truncate, so byte results match fixed point fast path within one.
+             */
+            static inline void store_sample(uint8_t *out, float p) {
+                *out = clamp_to<uint8_t>(0, 255, p + 0.5f);
+            }
+
+            static inline void store_sample(float *out, float p) {
+                *out = p;
             }
 
-            auto left = int32_t(floorf(x));
-            auto top = int32_t(floorf(y));
-
-            auto p0 = reinterpret_cast<uint8_t *>(image.data) + (top * W + left) * C;
-            auto next_image_shift = H * W * C;
-            auto next_line_shift = W * C;
-            for (decltype(N) n = 0; n < N; ++n) {
-                auto p1 = p0 + C;
-                auto p2 = p0 + next_line_shift;
-                auto p3 = p2 + C;
-                for (decltype(C) c = 0; c < C; ++c) {
-                    auto p = (ratio.r0 == 0 ? 0 : float(p0[c]) * ratio.r0) +
-                            (ratio.r1 == 0 ? 0 : float(p1[c]) * ratio.r1) +
-                            (ratio.r2 == 0 ? 0 : float(p2[c]) * ratio.r2) +
-                            (ratio.r3 == 0 ? 0 : float(p3[c]) * ratio.r3);
-                    out[c] = _::clamp_to<uint8_t>(0, 255, p);
+            /**
+             * Bilinear sample pixel (x, y) of each plane, pixels outside fade to 0 within 1 pixel.
+             * @param out_shift elements between output planes
+             */
+            template<typename T>
+            static inline void sample_linear_pixel(const AffinePlanes &src, float x, float y, T *out,
+                                                   size_t out_shift) {
+                auto C = src.channels;
+                LineSampleRatio ratio;
+                if (!GetSampleRatio(&ratio, x, y, src.width, src.height)) {
+                    for (int32_t n = 0; n < src.number; ++n, out += out_shift) {
+                        std::fill(out, out + C, T(0));
+                    }
+                    return;
+                }
+
+                auto left = int32_t(floorf(x));
+                auto top = int32_t(floorf(y));
+
+                // neighbors with 0 ratio are outside image, never read
+                auto p0 = src.data + int64_t(top) * int64_t(src.row_stride) + int64_t(left) * C * int64_t(sizeof(T));
+                for (int32_t n = 0; n < src.number; ++n, p0 += src.image_stride, out += out_shift) {
+                    auto t0 = reinterpret_cast<const T *>(p0);
+                    auto t1 = t0 + C;
+                    auto t2 = reinterpret_cast<const T *>(p0 + src.row_stride);
+                    auto t3 = t2 + C;
+                    for (decltype(C) c = 0; c < C; ++c) {
+                        auto p = (ratio.r0 == 0 ? 0 : float(t0[c]) * ratio.r0) +
+                                 (ratio.r1 == 0 ? 0 : float(t1[c]) * ratio.r1) +
+                                 (ratio.r2 == 0 ? 0 : float(t2[c]) * ratio.r2) +
+                                 (ratio.r3 == 0 ? 0 : float(t3[c]) * ratio.r3);
+                        store_sample(out + c, p);
+                    }
+                }
+            }
 
+            /**
+             * Copy pixel (x, y) of each plane, 0 if outside.
+             * @param out_shift elements between output planes
+             */
+            template<typename T>
+            static inline void sample_nearest_pixel(const AffinePlanes &src, int64_t x, int64_t y, T *out,
+                                                    size_t out_shift) {
+                auto C = src.channels;
+                if (x < 0 || x >= src.width || y < 0 || y >= src.height) {
+                    for (int32_t n = 0; n < src.number; ++n, out += out_shift) {
+                        std::fill(out, out + C, T(0));
+                    }
+                    return;
+                }
+                auto p0 = src.data + size_t(y) * src.row_stride + size_t(x) * C * sizeof(T);
+                for (int32_t n = 0; n < src.number; ++n, p0 += src.image_stride, out += out_shift) {
+                    std::memcpy(out, p0, C * sizeof(T));
                 }
-                p0 += next_image_shift;
-                out += out_shift;
             }
         }
 
         static inline void sample_uint8_pixel(
-                SeetaAIPImageData image,
+                const ImageView &image,
+                float x, float y, uint8_t *out,
+                uint32_t out_shift) {
+            auto src = _::image_planes(image);
+            _::sample_linear_pixel(src, x, y, out, out_shift);
+        }
+
+        static inline void sample_uint8_pixel(
+                const ImageView &image,
                 int x, int y, uint8_t *out,
                 uint32_t out_shift) {
-            auto N = int32_t(image.number);
-            auto H = int32_t(image.height);
-            auto W = int32_t(image.width);
-            auto C = int32_t(image.channels);
-
-            if (x < 0 || x >= W || y < 0 || y >= H) {
-                for (decltype(N) n = 0; n < N; ++n) {
-                    std::memset(out, 0, C);
-                    out += out_shift;
+            auto src = _::image_planes(image);
+            _::sample_nearest_pixel(src, x, y, out, out_shift);
+        }
+
+        namespace _ {
+            static const double fixed_one = 4294967296.0;   ///< 1 in 32.32 fixed point
+
+            static inline int64_t to_fixed(double x) {
+                return int64_t(std::floor(x * fixed_one + 0.5));
+            }
+
+            static inline int32_t lerp_q15(int32_t a, int32_t b, int32_t w) {
+                return a + (((b - a) * w + (1 << 14)) >> 15);
+            }
+
+            /**
+             * Bilinear sample `N` pixels along one row with 32.32 fixed point position and 15 bits weights,
+             * 2x2 neighbors of every pixel must be inside image.
+             */
+            template<int C>
+            static inline void affine_row_uint8(const uint8_t *src, size_t row_stride, uint8_t *dst, int32_t N,
+                                                int32_t channels, int64_t X, int64_t Y, int64_t A, int64_t D) {
+                const int32_t step = C > 0 ? C : channels;
+                for (int32_t i = 0; i < N; ++i, X += A, Y += D, dst += step) {
+                    auto wx = int32_t((X >> 17) & 0x7fff);
+                    auto wy = int32_t((Y >> 17) & 0x7fff);
+                    auto p00 = src + size_t(Y >> 32) * row_stride + size_t(X >> 32) * step;
+                    auto p10 = p00 + row_stride;
+                    for (int32_t c = 0; c < step; ++c) {
+                        auto top = lerp_q15(p00[c], p00[c + step], wx);
+                        auto bottom = lerp_q15(p10[c], p10[c + step], wx);
+                        dst[c] = uint8_t(lerp_q15(top, bottom, wy));
+                    }
+                }
+            }
+
+            static inline void affine_row_uint8(const uint8_t *src, size_t row_stride, uint8_t *dst, int32_t N,
+                                                int32_t channels, int64_t X, int64_t Y, int64_t A, int64_t D) {
+                switch (channels) {
+                    case 1: affine_row_uint8<1>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                    case 3: affine_row_uint8<3>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                    case 4: affine_row_uint8<4>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                    default: affine_row_uint8<0>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                }
+            }
+
+            /**
+             * Float version of affine_row_uint8, weights are fraction bits of position.
+             */
+            template<int C>
+            static inline void affine_row_float(const uint8_t *src, size_t row_stride, float *dst, int32_t N,
+                                                int32_t channels, int64_t X, int64_t Y, int64_t A, int64_t D) {
+                const int32_t step = C > 0 ? C : channels;
+                const float fraction = float(1.0 / fixed_one);
+                for (int32_t i = 0; i < N; ++i, X += A, Y += D, dst += step) {
+                    auto wx = float(uint32_t(X)) * fraction;
+                    auto wy = float(uint32_t(Y)) * fraction;
+                    auto p00 = reinterpret_cast<const float *>(src + size_t(Y >> 32) * row_stride) +
+                               size_t(X >> 32) * step;
+                    auto p10 = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(p00) + row_stride);
+                    for (int32_t c = 0; c < step; ++c) {
+                        auto top = p00[c] + (p00[c + step] - p00[c]) * wx;
+                        auto bottom = p10[c] + (p10[c + step] - p10[c]) * wx;
+                        dst[c] = top + (bottom - top) * wy;
+                    }
                 }
-                return;
             }
 
-            auto p0 = &reinterpret_cast<uint8_t *>(image.data)[((y * W) + x) * C];
-            auto next_image_shift = H * W * C;
-            auto next_line_shift = W * C;
-            for (decltype(N) n = 0; n < N; ++n) {
-                for (decltype(C) c = 0; c < C; ++c) {
-                    out[c] = p0[c];
+            static inline void affine_row_float(const uint8_t *src, size_t row_stride, float *dst, int32_t N,
+                                                int32_t channels, int64_t X, int64_t Y, int64_t A, int64_t D) {
+                switch (channels) {
+                    case 1: affine_row_float<1>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                    case 3: affine_row_float<3>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                    case 4: affine_row_float<4>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                    default: affine_row_float<0>(src, row_stride, dst, N, channels, X, Y, A, D); break;
+                }
+            }
+
+            /**
+             * Bilinear sample output row `j` of all planes, first pixel is (left, j).
+             * Source position steps linearly along output row, so positions are accumulated in 32.32 fixed point.
+             * Pixels with all 2x2 neighbors inside source run `row(plane, out, N, X, Y, A, D)`,
+             * border pixels use exact sampling.
+             * @param out_shift elements between output planes
+             */
+            template<typename T, typename ROW>
+            static inline void affine_linear_row(const float *M, const AffinePlanes &src, T *out, size_t out_shift,
+                                                 int32_t left, int32_t j, int32_t width, ROW row) {
+                auto C = src.channels;
+                auto A = to_fixed(M[0]);
+                auto D = to_fixed(M[3]);
+                auto X = to_fixed(double(M[0]) * left + double(M[1]) * j + double(M[2]));
+                auto Y = to_fixed(double(M[3]) * left + double(M[4]) * j + double(M[5]));
+                auto SRC_W = int64_t(src.width);
+                auto SRC_H = int64_t(src.height);
+                auto inside = [&](int64_t px, int64_t py) {
+                    return px >= 0 && py >= 0 && (px >> 32) < SRC_W - 1 && (py >> 32) < SRC_H - 1;
+                };
+                auto exact = [&](int32_t i) {
+                    auto px = X + int64_t(i) * A;
+                    auto py = Y + int64_t(i) * D;
+                    sample_linear_pixel(src, float(double(px) / fixed_one), float(double(py) / fixed_one),
+                                        out + size_t(i) * C, out_shift);
+                };
+                // inside pixels of one row are continuous, because both source image and row are convex
+                int32_t begin = 0;
+                while (begin < width && !inside(X + begin * A, Y + begin * D)) exact(begin++);
+                int32_t end = width;
+                while (end > begin && !inside(X + (end - 1) * A, Y + (end - 1) * D)) exact(--end);
+                if (begin >= end) return;
+                auto X0 = X + begin * A;
+                auto Y0 = Y + begin * D;
+                for (int32_t n = 0; n < src.number; ++n) {
+                    row(src.data + size_t(n) * src.image_stride,
+                        out + size_t(n) * out_shift + size_t(begin) * C, end - begin, X0, Y0, A, D);
+                }
+            }
+
+            /**
+             * Sample output row `j` of BYTE planes bilinearly, first pixel is (left, j).
+             * @param out_shift elements between output planes
+             */
+            static inline void affine_row(const float *M, const AffinePlanes &src, uint8_t *out, size_t out_shift,
+                                          int32_t left, int32_t j, int32_t width) {
+                auto C = src.channels;
+                auto row_stride = src.row_stride;
+                auto image_bytes = (int64_t(src.height) - 1) * int64_t(row_stride) + int64_t(src.width) * C;
+                auto kernels = simd::affine_kernels();
+                simd::AffineRowKernel kernel = nullptr;
+                if (kernels && image_bytes < INT32_MAX) {
+                    kernel = C == 3 ? kernels->c3 : (C == 4 ? kernels->c4 : nullptr);
+                }
+                affine_linear_row(M, src, out, out_shift, left, j, width,
+                                  [&](const uint8_t *plane, uint8_t *dst, int32_t N,
+                                      int64_t X, int64_t Y, int64_t A, int64_t D) {
+                                      int32_t done = 0;
+                                      if (kernel) {
+                                          done = kernel(plane, int32_t(row_stride), int32_t(image_bytes),
+                                                        dst, N, X, Y, A, D);
+                                      }
+                                      affine_row_uint8(plane, row_stride, dst + size_t(done) * C, N - done,
+                                                       C, X + done * A, Y + done * D, A, D);
+                                  });
+            }
+
+            /**
+             * Sample output row `j` of FLOAT32 planes bilinearly, first pixel is (left, j).
+             * @param out_shift elements between output planes
+             */
+            static inline void affine_row(const float *M, const AffinePlanes &src, float *out, size_t out_shift,
+                                          int32_t left, int32_t j, int32_t width) {
+                auto C = src.channels;
+                auto row_stride = src.row_stride;
+                affine_linear_row(M, src, out, out_shift, left, j, width,
+                                  [&](const uint8_t *plane, float *dst, int32_t N,
+                                      int64_t X, int64_t Y, int64_t A, int64_t D) {
+                                      affine_row_float(plane, row_stride, dst, N, C, X, Y, A, D);
+                                  });
+            }
+
+            /**
+             * Sample output row `j` of INT32 planes with nearest pixel, first pixel is (left, j).
+             * @param out_shift elements between output planes
+             */
+            static inline void affine_row(const float *M, const AffinePlanes &src, int32_t *out, size_t out_shift,
+                                          int32_t left, int32_t j, int32_t width) {
+                auto C = src.channels;
+                auto A = to_fixed(M[0]);
+                auto D = to_fixed(M[3]);
+                auto half = to_fixed(0.5);
+                auto X = to_fixed(double(M[0]) * left + double(M[1]) * j + double(M[2])) + half;
+                auto Y = to_fixed(double(M[3]) * left + double(M[4]) * j + double(M[5])) + half;
+                for (int32_t i = 0; i < width; ++i, X += A, Y += D) {
+                    sample_nearest_pixel(src, X >> 32, Y >> 32, out + size_t(i) * C, out_shift);
+                }
+            }
+
+            /**
+             * Affine of all planes into packed planes of `width x height`.
+             */
+            template<typename T>
+            static inline void affine_sample_planes(const Executor &threads, const float *M, const AffinePlanes &src,
+                                             T *out, int32_t left, int32_t top, int32_t width, int32_t height) {
+                auto out_shift = size_t(width) * height * src.channels;
+                parallel_for(threads, top, top + height, [&](int32_t j) {
+                    affine_row(M, src, out + size_t(j - top) * width * src.channels, out_shift, left, j, width);
+                });
+            }
+
+            /**
+             * Check image could be sampled by affine.
+             */
+            static inline void affine_check(const ImageView &image) {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                auto type = ImageData::GetType(format);
+                if (ImageData::IsYUV420(format)) {
+                    throw Exception(std::string("AIP image affine not support YUV format, got ") +
+                                    format_string(format));
+                }
+                if (type != SEETA_AIP_VALUE_BYTE && type != SEETA_AIP_VALUE_FLOAT32 && type != SEETA_AIP_VALUE_INT32) {
+                    throw Exception(
+                            std::string("AIP image affine only support BYTE, FLOAT32 or INT32 type, got ") +
+                            type_string(format));
+                }
+                if ((format & 0xffff0000) == 0x80000 && !ImageData::IsPacked(image)) {
+                    throw Exception("Strided image only support HWC format.");
                 }
-                p0 += next_image_shift;
-                out += out_shift;
             }
         }
 
         /**
          * apply affine on given image
-         * @param threads using computing threads. must enable OpenMP
+         * @param threads executor running kernels, or number of threads
          * @param M affine 3x3 matrix
-         * @param image source image
+         * @param image source image, could be strided HWC view.
+         *              BYTE and FLOAT32 are bilinear sampled, INT32 (labels or indices) is nearest sampled.
          * @param x sample dest image start x
          * @param y sample dest image start y
          * @param width sample dest image width
          * @param height sample dest image height
          * @return image with same format with source image, shape `width x height`
-         * @note src = M * dst.
+         * @note src = M * dst. CHW image is sampled plane by plane.
+         * @note BYTE results are rounded to nearest. Older versions truncated them,
+         *       so values may be one larger than before.
          */
         static seeta::aip::ImageData affine_sample2d(
-                int threads, const float *M, SeetaAIPImageData image,
+                const Executor &threads, const float *M, ImageView image,
                 int x, int y, int width, int height) {
             auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
             auto type = ImageData::GetType(format);
-            auto channels = ImageData::GetChannels(format, image.channels);
-            if (type != SEETA_AIP_VALUE_BYTE) {
-                throw Exception(
-                        std::string("AIP image affine only support BYTE type, got ") + type_string(format));
-            }
-            image.channels = channels;  // fix channels if not mismatched.
-            auto src = image;
-            bool is_chw = (format & 0xffff0000) == 0x80000;
-            if (is_chw) {
-                // trans image to hwc format to sample
-                src.format = SEETA_AIP_FORMAT_U8RAW;
-                src.number = src.number * src.channels;
-                src.channels = 1;
-            }
-            // loop to sample
+            _::affine_check(image);
+            image.channels = ImageData::GetChannels(format, image.channels);  // fix channels if not mismatched.
+            auto src = _::affine_planes(image);
+
             seeta::aip::ImageData dst(format, image.number,
                                       width, height, image.channels);
-            auto out = dst.data<uint8_t>();
-            auto out_shift = is_chw
-                    ? dst.width() * dst.height()
-                    : dst.width() * dst.height() * dst.channels();
-
-            auto H = int(dst.height());
-            auto W = int(dst.width());
-            auto C = int(src.channels);
-
-            auto top = y;
-            auto bottom = y + H;
-            auto left = x;
-            auto right = x + W;
-
-            Trans2D<float> T;
-            std::memcpy(T.data(), M, 9 * sizeof(float));
-
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-            for (decltype(bottom) j = top; j < bottom; ++j) {
-                for (decltype(right) i = left; i < right; ++i) {
-                    Vec3D<float> p(i, j);
-                    auto local_out = &out[(j * W + i) * C];
-                    p = transform(T, p);
-                    sample_uint8_pixel(src, p.x(), p.y(), local_out, out_shift);
-                }
+            if (dst.bytes() == 0 || src.number == 0) return dst;
+
+            switch (type) {
+                default:
+                case SEETA_AIP_VALUE_BYTE:
+                    _::affine_sample_planes(threads, M, src, dst.data<uint8_t>(), x, y, width, height);
+                    break;
+                case SEETA_AIP_VALUE_FLOAT32:
+                    _::affine_sample_planes(threads, M, src, dst.data<float>(), x, y, width, height);
+                    break;
+                case SEETA_AIP_VALUE_INT32:
+                    _::affine_sample_planes(threads, M, src, dst.data<int32_t>(), x, y, width, height);
+                    break;
             }
 
             return dst;
@@ -225,105 +470,61 @@ namespace seeta {
 
         /**
          *
-         * @param threads using computing threads. must enable OpenMP
-         * @param image source image
+         * @param threads executor running kernels, or number of threads
+         * @param image source image, BYTE or FLOAT32 type, could be strided HWC view
          * @param width resized image width
          * @param height resized image height
+         * @param method RESIZE_LINEAR or RESIZE_AREA, area averaging avoids aliasing of large downscale
          * @return resize image `width x height`
+         * @note BYTE results are rounded to nearest, older versions truncated them, see affine_sample2d.
          */
         static seeta::aip::ImageData resize(
-                int threads, SeetaAIPImageData image, int width, int height) {
-            float scale_x = static_cast<float>(image.width) / width;
-            float scale_y = static_cast<float>(image.height) / height;
-            float bias_x = scale_x / 2 - 0.5f;
-            float bias_y = scale_y / 2 - 0.5f;
-
-            float M[] = {
-                    scale_x, 0, bias_x,
-                    0, scale_y, bias_y,
-                    0, 0, 1,
-            };
-
-            return affine_sample2d(threads, M, image, 0, 0, width, height);
+                const Executor &threads, ImageView image, int width, int height,
+                ResizeMethod method = RESIZE_LINEAR) {
+            return resize2d(threads, image, width, height, method);
         }
 
         /**
          *
-         * @param threads using computing threads. must enable OpenMP
-         * @param image source image
+         * @param threads executor running kernels, or number of threads
+         * @param image source image, BYTE or FLOAT32 type, could be strided HWC view
          * @param scale_x resized image width
          * @param scale_y resized image height
+         * @param method RESIZE_LINEAR or RESIZE_AREA
          * @return resize image `image.width*scale_x x image.height*scale_y`
+         * @note BYTE results are rounded to nearest, older versions truncated them, see affine_sample2d.
          */
         static seeta::aip::ImageData scale(
-                int threads, SeetaAIPImageData image, float scale_x, float scale_y) {
-            float bias_x = 0.5f / scale_x - 0.5f;
-            float bias_y = 0.5f / scale_y - 0.5f;
-
-            float M[] = {
-                    1 / scale_x, 0, bias_x,
-                    0, 1 / scale_y, bias_y,
-                    0, 0, 1,
-            };
-
+                const Executor &threads, ImageView image, float scale_x, float scale_y,
+                ResizeMethod method = RESIZE_LINEAR) {
             auto width = int(roundf(image.width * scale_x));
             auto height = int(roundf(image.height * scale_y));
 
-            return affine_sample2d(threads, M, image, 0, 0, width, height);
+            return resize2d(threads, image, width, height, method);
         }
 
-        static seeta::aip::ImageData flip_x(int threads, SeetaAIPImageData image) {
-            float M[] = {
-                    -1, 0, float(image.width - 1),
-                    0, 1, 0,
-                    0, 0, 1,
-            };
-
-            return affine_sample2d(threads, M, image, 0, 0, image.width, image.height);
+        static seeta::aip::ImageData flip_x(const Executor &threads, ImageView image) {
+            return flip_image(threads, image, true, false);
         }
 
-        static seeta::aip::ImageData flip_y(int threads, SeetaAIPImageData image) {
-            float M[] = {
-                    1, 0, 0,
-                    0, -1, float(image.height - 1),
-                    0, 0, 1,
-            };
-
-            return affine_sample2d(threads, M, image, 0, 0, image.width, image.height);
+        static seeta::aip::ImageData flip_y(const Executor &threads, ImageView image) {
+            return flip_image(threads, image, false, true);
         }
 
-        static seeta::aip::ImageData flip_xy(int threads, SeetaAIPImageData image) {
-            float M[] = {
-                    -1, 0, float(image.width - 1),
-                    0, -1, float(image.height - 1),
-                    0, 0, 1,
-            };
-
-            return affine_sample2d(threads, M, image, 0, 0, image.width, image.height);
+        static seeta::aip::ImageData flip_xy(const Executor &threads, ImageView image) {
+            return flip_image(threads, image, true, true);
         }
 
-        static seeta::aip::ImageData rotate_180(int threads, SeetaAIPImageData image) {
-            return flip_xy(threads, image);
+        static seeta::aip::ImageData rotate_180(const Executor &threads, ImageView image) {
+            return rotate_image(threads, image, 180);
         }
 
-        static seeta::aip::ImageData rotate_left_90(int threads, SeetaAIPImageData image) {
-            float M[] = {
-                    0, -1, float(image.width - 1),
-                    1, 0, 0,
-                    0, 0, 1,
-            };
-
-            return affine_sample2d(threads, M, image, 0, 0, image.height, image.width);
+        static seeta::aip::ImageData rotate_left_90(const Executor &threads, ImageView image) {
+            return rotate_image(threads, image, 90);
         }
 
-        static seeta::aip::ImageData rotate_right_90(int threads, SeetaAIPImageData image) {
-            float M[] = {
-                    0, 1, 0,
-                    -1, 0, float(image.height - 1),
-                    0, 0, 1,
-            };
-
-            return affine_sample2d(threads, M, image, 0, 0, image.height, image.width);
+        static seeta::aip::ImageData rotate_right_90(const Executor &threads, ImageView image) {
+            return rotate_image(threads, image, -90);
         }
     }
 }
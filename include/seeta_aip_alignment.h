@@ -6,6 +6,7 @@
 #define SEETA_AIP_SEETA_AIP_ALIGNMENT_H
 
 #include "seeta_aip_graphics2d.h"
+#include "seeta_aip_affine.h"
 
 #include <vector>
 #include <cfloat>
@@ -103,6 +104,167 @@ namespace seeta {
             alignment2d(src_data.data(), dst_data.data(), int(N), M.data());
             return M;
         }
+
+        namespace _ {
+            /**
+             * Sample output row `j` of one crop, output could be in other layout than source planes.
+             * @param chw if output is planar
+             * @param buffer `width * channels` elements, used when layout changed
+             */
+            template<typename T>
+            static inline void alignment_crop_row(const float *M, const AffinePlanes &src, bool chw, T *out,
+                                                  int32_t j, int32_t width, int32_t height, int32_t channels,
+                                                  T *buffer) {
+                auto plane = size_t(width) * height;
+                auto source_chw = src.channels != channels;
+                if (chw == source_chw) {
+                    affine_row(M, src, out + size_t(j) * width * src.channels, plane, 0, j, width);
+                    return;
+                }
+                if (chw) {
+                    affine_row(M, src, buffer, 0, 0, j, width);
+                    for (int32_t c = 0; c < channels; ++c) {
+                        auto out_row = out + c * plane + size_t(j) * width;
+                        for (int32_t i = 0; i < width; ++i) out_row[i] = buffer[i * channels + c];
+                    }
+                } else {
+                    affine_row(M, src, buffer, width, 0, j, width);
+                    auto out_row = out + size_t(j) * width * channels;
+                    for (int32_t i = 0; i < width; ++i) {
+                        for (int32_t c = 0; c < channels; ++c) out_row[i * channels + c] = buffer[c * width + i];
+                    }
+                }
+            }
+
+            template<typename T>
+            static inline void alignment_crop(const Executor &threads, const std::vector<float> &transforms,
+                                              const std::vector<char> &aligned, const AffinePlanes &src,
+                                              const SeetaAIPImageData &output, bool chw, int32_t channels) {
+                auto width = int32_t(output.width);
+                auto height = int32_t(output.height);
+                auto crop = size_t(width) * height * channels;
+                auto data = reinterpret_cast<T *>(output.data);
+                parallel_range(threads, 0, int32_t(output.number) * height, [&](int32_t first, int32_t last) {
+                    std::vector<T> buffer(size_t(width) * channels);
+                    for (auto i = first; i < last; ++i) {
+                        auto n = i / height;
+                        auto j = i % height;
+                        auto out = data + n * crop;
+                        if (!aligned[n]) {
+                            auto row = size_t(width) * (chw ? 1 : channels);
+                            for (int32_t c = 0; c < (chw ? channels : 1); ++c) {
+                                std::fill(out + c * size_t(width) * height + j * row,
+                                          out + c * size_t(width) * height + (j + 1) * row, T(0));
+                            }
+                            continue;
+                        }
+                        alignment_crop_row(&transforms[n * 9], src, chw, out, j, width, height, channels,
+                                           buffer.data());
+                    }
+                });
+            }
+        }
+
+        /**
+         * Align and crop every object into one batch, all crops are sampled in one parallel pass.
+         * @param threads executor running kernels, or number of threads
+         * @param image source image, number must be 1, could be strided HWC view
+         * @param objects N objects, landmarks of each shape are aligned to `points`
+         * @param N number of objects
+         * @param points template landmarks in crop coordinate, length `size * 2`
+         * @param size number of template landmarks, each shape must have same number of landmarks
+         * @param output caller provided batch, like NCHW input of network. Number must be N, width and height
+         *     are crop size. Format must be image's format in HWC or CHW layout, like CHW_U8BGR for U8BGR image.
+         * @param transforms optional N * 9 floats, set to transform of each object, src = M * crop.
+         *     Object can not be aligned gets all 0 crop and all 0 transform.
+         * @return number of objects aligned
+         */
+        static inline int32_t alignment_crop(const Executor &threads, const ImageView &image,
+                                             const SeetaAIPObject *objects, int32_t N,
+                                             const float *points, int32_t size,
+                                             const SeetaAIPImageData &output, float *transforms = nullptr) {
+            auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+            auto output_format = SEETA_AIP_IMAGE_FORMAT(output.format);
+            _::affine_check(image);
+            if (image.number != 1) {
+                throw Exception("Alignment crop only support one image, got number " + std::to_string(image.number));
+            }
+            if (int32_t(output.number) != N) {
+                throw Exception("Alignment crop output number must be " + std::to_string(N));
+            }
+            auto channels = int32_t(ImageData::GetChannels(format, image.channels));
+            if ((output_format & 0xffff) != (format & 0xffff)
+                || int32_t(ImageData::GetChannels(output_format, output.channels)) != channels) {
+                throw Exception(std::string("Alignment crop output must be ") + format_string(format) +
+                                " in HWC or CHW layout, got " + format_string(output_format));
+            }
+
+            std::vector<float> M(size_t(N) * 9, 0.0f);
+            std::vector<char> aligned(N, 0);
+            int32_t count = 0;
+            std::vector<float> landmarks(size_t(size) * 2);
+            for (int32_t n = 0; n < N; ++n) {
+                auto &shape = objects[n].shape;
+                if (int32_t(shape.landmarks.size) != size) {
+                    throw Exception("Alignment crop need " + std::to_string(size) + " landmarks, object " +
+                                    std::to_string(n) + " has " + std::to_string(shape.landmarks.size));
+                }
+                for (int32_t i = 0; i < size; ++i) {
+                    landmarks[i * 2] = shape.landmarks.data[i].x;
+                    landmarks[i * 2 + 1] = shape.landmarks.data[i].y;
+                }
+                if (alignment2d(landmarks.data(), points, size, &M[n * 9])) {
+                    aligned[n] = 1;
+                    ++count;
+                } else {
+                    std::fill(&M[n * 9], &M[n * 9] + 9, 0.0f);
+                }
+            }
+            if (transforms) std::copy(M.begin(), M.end(), transforms);
+            if (N == 0 || output.width == 0 || output.height == 0) return count;
+
+            auto src = _::affine_planes(image);
+            auto chw = (output_format & 0xffff0000) == 0x80000;
+            switch (ImageData::GetType(format)) {
+                default:
+                case SEETA_AIP_VALUE_BYTE:
+                    _::alignment_crop<uint8_t>(threads, M, aligned, src, output, chw, channels);
+                    break;
+                case SEETA_AIP_VALUE_FLOAT32:
+                    _::alignment_crop<float>(threads, M, aligned, src, output, chw, channels);
+                    break;
+                case SEETA_AIP_VALUE_INT32:
+                    _::alignment_crop<int32_t>(threads, M, aligned, src, output, chw, channels);
+                    break;
+            }
+            return count;
+        }
+
+        /**
+         * @param threads executor running kernels, or number of threads
+         * @param image source image, number must be 1, could be strided HWC view
+         * @param objects landmarks of each shape are aligned to `points`
+         * @param points template landmarks in crop coordinate
+         * @param format output format, image's format in HWC or CHW layout
+         * @param width crop width
+         * @param height crop height
+         * @return batch of crops, object can not be aligned gets all 0 crop
+         */
+        static inline ImageData alignment_crop(const Executor &threads, const ImageView &image,
+                                               const std::vector<SeetaAIPObject> &objects,
+                                               const std::vector<Vec2D<float>> &points,
+                                               SEETA_AIP_IMAGE_FORMAT format, int32_t width, int32_t height) {
+            std::vector<float> template_points(points.size() * 2);
+            for (size_t i = 0; i < points.size(); ++i) {
+                template_points[i * 2] = points[i][0];
+                template_points[i * 2 + 1] = points[i][1];
+            }
+            ImageData batch(format, uint32_t(objects.size()), width, height,
+                            ImageData::GetChannels(SEETA_AIP_IMAGE_FORMAT(image.format), image.channels));
+            alignment_crop(threads, image, objects.data(), int32_t(objects.size()),
+                           template_points.data(), int32_t(points.size()), batch);
+            return batch;
+        }
     }
 }
 
@@ -7,10 +7,13 @@
 
 #include <memory>
 #include <iostream>
+#include <future>
+#include <algorithm>
 
 #include "seeta_aip.h"
 #include "seeta_aip_dll.h"
 #include "seeta_aip_struct.h"
+#include "seeta_aip_executor.h"
 
 namespace seeta {
     namespace aip {
@@ -129,6 +132,14 @@ namespace seeta {
                 } objects;
             };
 
+            /**
+             * Owned result, used by forward_async
+             */
+            struct Output {
+                std::vector<ImageData> images;
+                std::vector<Object> objects;
+            };
+
             Instance(const Instance &) = delete;
 
             Instance &operator=(const Instance &) = delete;
@@ -244,6 +255,20 @@ namespace seeta {
 
             SeetaAIPHandle handle() const { return m_handle; }
 
+            /**
+             * Share executor with AIP, so image processing in AIP runs on host's worker threads.
+             * The executor is kept by this instance. Ignored if AIP has no set_executor entry.
+             * @param executor executor to share, Executor() to let AIP use its own threads
+             * @return if AIP supports shared executor
+             */
+            bool set_executor(const Executor &executor) {
+                if (m_aip.set_executor == nullptr) return false;
+                auto errcode = m_aip.set_executor(m_handle, executor.raw());
+                if (errcode) throw Exception(errcode, m_aip.error(m_handle, errcode));
+                m_executor = executor;
+                return true;
+            }
+
             void dispose() {
                 if (m_handle) {
                     m_aip.free(m_handle);
@@ -273,6 +298,17 @@ namespace seeta {
                 return result;
             }
 
+            /**
+             * @param format image format
+             * @return if package declared accepting input images in `format` directly
+             */
+            bool accept_format(SEETA_AIP_IMAGE_FORMAT format) {
+                auto name = accept_format_property(format);
+                auto names = property();
+                if (std::find(names.begin(), names.end(), name) == names.end()) return false;
+                return getd(name) != 0;
+            }
+
             void setd(const std::string &name, double value) {
                 auto errcode = m_aip.setd(m_handle, name.c_str(), value);
                 if (errcode) throw Exception(errcode, m_aip.error(m_handle, errcode));
@@ -326,6 +362,14 @@ namespace seeta {
                                objects.data(), uint32_t(objects.size()));
             }
 
+            /**
+             * AIP entries take SeetaAIPImageData, which has no strides.
+             * So strided views, like ImageData::roi, are exported as packed copies of their pixels,
+             * each view packs once at its first export and keeps the copy, see ImageData::exporter.
+             * Pass ImageData::compact() to control when the copy happens.
+             * @param array images to be passed to AIP
+             * @return descriptors of packed pixels
+             */
             static std::vector<SeetaAIPImageData> Convert(const std::vector<ImageData> &array) {
                 std::vector<SeetaAIPImageData> cvt;
                 cvt.reserve(array.size());
@@ -344,6 +388,9 @@ namespace seeta {
                 return cvt;
             }
 
+            /**
+             * @note strided views in images are packed before passed to AIP, see Convert
+             */
             Result forward(uint32_t method_id,
                            const std::vector<ImageData> &images,
                            const std::vector<Object> &objects) {
@@ -399,6 +446,182 @@ namespace seeta {
                 return forward(method_id, std::vector<SeetaAIPImageData>(), objects);
             }
 
+            /**
+             * Forward into caller pre-allocated images.
+             * If result image fits the buffer, with same format and enough memory, it is written into buffer.
+             * Buffer with nullptr data, or empty outputs, gets borrowed result image.
+             * @param method_id
+             * @param images
+             * @param objects
+             * @param [in,out] outputs pre-allocated images, resized to the number of result images
+             * @return result, images point to outputs, objects are borrowed value.
+             * @throw Exception(SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH) if more result images than outputs,
+             *        or any result image not fits its buffer. Then outputs are resized to the number of result
+             *        images, each given buffer is set to needed format and shape, so caller could allocate again.
+             */
+            Result forward_into(uint32_t method_id,
+                                const std::vector<SeetaAIPImageData> &images,
+                                const std::vector<SeetaAIPObject> &objects,
+                                std::vector<SeetaAIPImageData> &outputs) {
+                Result result;
+                auto capacity = uint32_t(outputs.size());
+                SeetaAIPImageData *result_images = capacity ? outputs.data() : nullptr;
+                uint32_t result_images_size = 0;
+                int32_t errcode = 0;
+                if (m_aip.forward_into == nullptr) {
+                    auto borrowed = forward(method_id, images, objects);
+                    result.objects.data = borrowed.objects.data;
+                    result.objects.size = borrowed.objects.size;
+                    result_images_size = borrowed.images.size;
+                    if (!capacity) result_images = borrowed.images.data;
+                    if (capacity && result_images_size > capacity) errcode = SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH;
+                    // copy data for AIP not written into buffer.
+                    for (uint32_t i = 0; i < result_images_size && i < capacity; ++i) {
+                        auto image = borrowed.images.data[i];
+                        auto &buffer = outputs[i];
+                        if (buffer.data == nullptr) {
+                            // borrowed
+                        } else if (ImageData::Fits(buffer, image)) {
+                            std::memcpy(buffer.data, image.data, ImageData::GetBytes(image));
+                            image.data = buffer.data;
+                        } else {
+                            errcode = SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH;
+                            image.data = buffer.data;
+                        }
+                        buffer = image;
+                    }
+                } else {
+                    errcode = m_aip.forward_into(m_handle, method_id,
+                                                 images.data(), uint32_t(images.size()),
+                                                 objects.data(), uint32_t(objects.size()),
+                                                 &result.objects.data, 0, &result.objects.size,
+                                                 &result_images, capacity, &result_images_size);
+                    if (errcode && errcode != SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH) {
+                        throw Exception(errcode, m_aip.error(m_handle, errcode));
+                    }
+                }
+                if (!capacity) outputs.assign(result_images, result_images + result_images_size);
+                outputs.resize(result_images_size);
+                if (errcode) throw Exception(errcode, "Output buffer not enough.");
+                result.images.data = outputs.data();
+                result.images.size = uint32_t(outputs.size());
+                return result;
+            }
+
+            using Request = SeetaAIPForwardRequest;
+
+            /**
+             * Forward many independent requests in one call.
+             * If the AIP has no forward_batch entry, each request is forwarded in turn.
+             * @param requests
+             * @return result of each request, borrowed value, valid until next forward.
+             */
+            std::vector<Result> forward_batch(const std::vector<Request> &requests) {
+                std::vector<Result> results(requests.size());
+                if (m_aip.forward_batch == nullptr) {
+                    // keep owned results, as each forward overwrites the borrowed one
+                    m_batch_output.resize(requests.size());
+                    m_batch_images.resize(requests.size());
+                    m_batch_objects.resize(requests.size());
+                    for (size_t i = 0; i < requests.size(); ++i) {
+                        auto &request = requests[i];
+                        auto result = forward(request.method_id,
+                                              request.images, request.images_size,
+                                              request.objects, request.objects_size);
+                        auto &output = m_batch_output[i];
+                        output.images.resize(result.images.size);
+                        for (uint32_t j = 0; j < result.images.size; ++j) {
+                            output.images[j].raw(result.images.data[j]);
+                        }
+                        output.objects.resize(result.objects.size);
+                        for (uint32_t j = 0; j < result.objects.size; ++j) {
+                            output.objects[j].raw(result.objects.data[j]);
+                        }
+                        m_batch_images[i] = Convert(output.images);
+                        m_batch_objects[i] = Convert(output.objects);
+                        results[i].images.data = m_batch_images[i].data();
+                        results[i].images.size = uint32_t(m_batch_images[i].size());
+                        results[i].objects.data = m_batch_objects[i].data();
+                        results[i].objects.size = uint32_t(m_batch_objects[i].size());
+                    }
+                    return results;
+                }
+                SeetaAIPForwardResult *c_results = nullptr;
+                auto errcode = m_aip.forward_batch(m_handle,
+                                                   requests.data(), uint32_t(requests.size()),
+                                                   &c_results);
+                if (errcode) throw Exception(errcode, m_aip.error(m_handle, errcode));
+                for (size_t i = 0; i < requests.size(); ++i) {
+                    results[i].images.data = c_results[i].images;
+                    results[i].images.size = c_results[i].images_size;
+                    results[i].objects.data = c_results[i].objects;
+                    results[i].objects.size = c_results[i].objects_size;
+                }
+                return results;
+            }
+
+            /**
+             * Submit forward request, the returned future is ready once AIP finished.
+             * Requests on same instance are processed in order.
+             * If the AIP has no forward_async entry, the request is processed before return.
+             * @param method_id
+             * @param images kept by this request until finished, strided views are packed, see Convert
+             * @param objects kept by this request until finished
+             * @return future of owned result, get() throws Exception if forward failed
+             */
+            std::future<Output> forward_async(uint32_t method_id,
+                                              const std::vector<ImageData> &images,
+                                              const std::vector<Object> &objects) {
+                std::unique_ptr<AsyncContext> context(new AsyncContext);
+                context->images = images;
+                context->objects = objects;
+                context->c_images = Convert(context->images);
+                context->c_objects = Convert(context->objects);
+                context->aip = m_aip;
+                context->handle = m_handle;
+                auto future = context->promise.get_future();
+
+                if (m_aip.forward_async == nullptr) {
+                    auto &c_images = context->c_images;
+                    auto &c_objects = context->c_objects;
+                    try {
+                        auto result = forward(method_id, c_images, c_objects);
+                        AsyncCallback(context.release(), 0,
+                                      result.objects.data, result.objects.size,
+                                      result.images.data, result.images.size);
+                    } catch (...) {
+                        context->promise.set_exception(std::current_exception());
+                    }
+                    return future;
+                }
+
+                auto errcode = m_aip.forward_async(m_handle, method_id,
+                                                   context->c_images.data(), uint32_t(context->c_images.size()),
+                                                   context->c_objects.data(), uint32_t(context->c_objects.size()),
+                                                   AsyncCallback, context.get());
+                if (errcode) throw Exception(errcode, m_aip.error(m_handle, errcode));
+                context.release();  // released in callback
+                return future;
+            }
+
+            std::future<Output> forward_async(uint32_t method_id,
+                                              const std::vector<ImageData> &images) {
+                return forward_async(method_id, images, std::vector<Object>());
+            }
+
+            std::future<Output> forward_async(uint32_t method_id, const ImageData &image) {
+                return forward_async(method_id, std::vector<ImageData>({image}), std::vector<Object>());
+            }
+
+            std::future<Output> forward_async(uint32_t method_id,
+                                              const ImageData &image, const std::vector<Object> &objects) {
+                return forward_async(method_id, std::vector<ImageData>({image}), objects);
+            }
+
+            std::future<Output> forward_async(uint32_t method_id, const std::vector<Object> &objects) {
+                return forward_async(method_id, std::vector<ImageData>(), objects);
+            }
+
             const char *c_tag(uint32_t method_id, uint32_t label_index, int32_t label_value) {
                 return m_aip.tag(m_handle, method_id, label_index, label_value);
             }
@@ -410,9 +633,47 @@ namespace seeta {
             }
 
         private:
+            struct AsyncContext {
+                std::promise<Output> promise;
+                std::vector<ImageData> images;
+                std::vector<Object> objects;
+                std::vector<SeetaAIPImageData> c_images;
+                std::vector<SeetaAIPObject> c_objects;
+                SeetaAIP aip;
+                SeetaAIPHandle handle;
+            };
+
+            static void SEETA_AIP_CALL AsyncCallback(
+                    void *userdata,
+                    int32_t errcode,
+                    const struct SeetaAIPObject *result_objects, uint32_t result_objects_size,
+                    const struct SeetaAIPImageData *result_images, uint32_t result_images_size) {
+                std::unique_ptr<AsyncContext> context(static_cast<AsyncContext *>(userdata));
+                try {
+                    if (errcode) throw Exception(errcode, context->aip.error(context->handle, -1));
+                    Output output;
+                    output.images.resize(result_images_size);
+                    for (uint32_t i = 0; i < result_images_size; ++i) {
+                        output.images[i].raw(result_images[i]);
+                    }
+                    output.objects.resize(result_objects_size);
+                    for (uint32_t i = 0; i < result_objects_size; ++i) {
+                        output.objects[i].raw(result_objects[i]);
+                    }
+                    context->promise.set_value(std::move(output));
+                } catch (...) {
+                    context->promise.set_exception(std::current_exception());
+                }
+            }
+
             SeetaAIP m_aip = {};
+            Executor m_executor;
             SeetaAIPHandle m_handle = nullptr;
             std::shared_ptr<Engine> m_engine;
+
+            std::vector<Output> m_batch_output;
+            std::vector<std::vector<SeetaAIPImageData>> m_batch_images;
+            std::vector<std::vector<SeetaAIPObject>> m_batch_objects;
         };
     }
 }
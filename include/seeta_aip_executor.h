@@ -0,0 +1,328 @@
+#ifndef SEETA_AIP_SEETA_AIP_EXECUTOR_H
+#define SEETA_AIP_SEETA_AIP_EXECUTOR_H
+
+#include "seeta_aip.h"
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+namespace seeta {
+    namespace aip {
+        /**
+         * Persistent worker threads running parallel_for jobs.
+         * Each job is cut into chunks, the caller and idle workers keep claiming chunks of the job until none left,
+         * so threads finishing early steal the chunks of busy ones.
+         * The caller always works on its own job, so nested parallel_for never dead locks.
+         */
+        class ThreadPool {
+        public:
+            using self = ThreadPool;
+
+            /**
+             * @param workers number of worker threads, caller thread not included
+             */
+            explicit ThreadPool(int workers) {
+                for (int i = 0; i < workers; ++i) {
+                    m_workers.emplace_back([this]() { loop(); });
+                }
+            }
+
+            ~ThreadPool() {
+                {
+                    std::unique_lock<std::mutex> _locker(m_mutex);
+                    m_stopped = true;
+                }
+                m_cond.notify_all();
+                for (auto &worker : m_workers) worker.join();
+            }
+
+            ThreadPool(const self &) = delete;
+
+            self &operator=(const self &) = delete;
+
+            /**
+             * @return most threads could run one job at same time, caller included
+             */
+            int32_t concurrency() const { return int32_t(m_workers.size()) + 1; }
+
+            /**
+             * Run task over [begin, end), return after all items done.
+             * @param begin first item
+             * @param end last item (not included)
+             * @param threads most threads used, caller included, 0 for concurrency()
+             * @param task must not throw
+             * @param data userdata passed to task
+             */
+            void parallel_for(int32_t begin, int32_t end, int32_t threads,
+                              seeta_aip_executor_task *task, void *data) {
+                if (end <= begin) return;
+                auto items = end - begin;
+                if (threads <= 0 || threads > concurrency()) threads = concurrency();
+                if (threads > items) threads = items;
+                if (threads <= 1) {
+                    task(data, begin, end);
+                    return;
+                }
+
+                auto job = std::make_shared<Job>();
+                job->task = task;
+                job->data = data;
+                job->next = begin;
+                job->end = end;
+                // several chunks for each thread, so uneven rows could be balanced by stealing
+                job->chunk = std::max<int32_t>(1, items / (threads * 4));
+                job->helpers = threads - 1;
+                job->remaining = items;
+                {
+                    std::unique_lock<std::mutex> _locker(m_mutex);
+                    m_jobs.push_back(job);
+                }
+                for (int32_t i = 1; i < threads; ++i) m_cond.notify_one();
+
+                run(*job);
+                {
+                    std::unique_lock<std::mutex> _locker(job->mutex);
+                    job->cond.wait(_locker, [&]() { return job->remaining == 0; });
+                }
+                {
+                    std::unique_lock<std::mutex> _locker(m_mutex);
+                    auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+                    if (it != m_jobs.end()) m_jobs.erase(it);
+                }
+            }
+
+            /**
+             * @return C interface of this pool, valid while pool alive
+             */
+            SeetaAIPExecutor raw() {
+                SeetaAIPExecutor executor;
+                executor.context = this;
+                executor.parallel_for = ParallelFor;
+                executor.concurrency = Concurrency;
+                return executor;
+            }
+
+            /**
+             * Default pool of this module, created at first use, with one thread for each CPU core.
+             * Each shared library has its own default pool, share one by SeetaAIPExecutor to bound threads.
+             */
+            static std::shared_ptr<self> Global() {
+                static std::shared_ptr<self> pool = std::make_shared<self>(
+                        int(std::max<unsigned>(std::thread::hardware_concurrency(), 1)) - 1);
+                return pool;
+            }
+
+        private:
+            struct Job {
+                seeta_aip_executor_task *task = nullptr;
+                void *data = nullptr;
+                std::atomic<int32_t> next;
+                int32_t end = 0;
+                int32_t chunk = 1;
+                int32_t helpers = 0;    ///< workers could still join, guarded by pool's mutex
+                std::atomic<int32_t> remaining;
+                std::mutex mutex;
+                std::condition_variable cond;
+            };
+
+            static void SEETA_AIP_CALL ParallelFor(void *context, int32_t begin, int32_t end, int32_t threads,
+                                                   seeta_aip_executor_task *task, void *data) {
+                static_cast<self *>(context)->parallel_for(begin, end, threads, task, data);
+            }
+
+            static int32_t SEETA_AIP_CALL Concurrency(void *context) {
+                return static_cast<self *>(context)->concurrency();
+            }
+
+            static void run(Job &job) {
+                while (true) {
+                    auto first = job.next.fetch_add(job.chunk);
+                    if (first >= job.end) break;
+                    auto last = std::min(first + job.chunk, job.end);
+                    job.task(job.data, first, last);
+                    auto count = last - first;
+                    if (job.remaining.fetch_sub(count) == count) {
+                        std::unique_lock<std::mutex> _locker(job.mutex);
+                        job.cond.notify_all();
+                    }
+                }
+            }
+
+            /**
+             * Find job still has chunks and helpers, drop all claimed jobs. Must lock m_mutex.
+             */
+            std::shared_ptr<Job> pick() {
+                std::shared_ptr<Job> picked;
+                for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+                    auto &job = *it;
+                    if (job->next >= job->end) {
+                        it = m_jobs.erase(it);
+                        continue;
+                    }
+                    if (!picked && job->helpers > 0) {
+                        --job->helpers;
+                        picked = job;
+                    }
+                    ++it;
+                }
+                return picked;
+            }
+
+            void loop() {
+                while (true) {
+                    std::shared_ptr<Job> job;
+                    {
+                        std::unique_lock<std::mutex> _locker(m_mutex);
+                        m_cond.wait(_locker, [&]() { return m_stopped || (job = pick()) != nullptr; });
+                        if (!job) return;
+                    }
+                    run(*job);
+                }
+            }
+
+            std::vector<std::thread> m_workers;
+            std::deque<std::shared_ptr<Job>> m_jobs;
+            std::mutex m_mutex;
+            std::condition_variable m_cond;
+            bool m_stopped = false;
+        };
+
+        /**
+         * Handle of executor used by image kernels, cheap to copy.
+         * Built from int for compatibility, which means at most `threads` threads of default pool.
+         */
+        class Executor {
+        public:
+            using self = Executor;
+
+            /**
+             * Kernels taking `int threads` used to run serially, as OpenMP was never enabled in build.
+             * Now threads > 1 really runs in parallel, on ThreadPool::Global() started at first use,
+             * which has one thread for each CPU core and lives until process exits.
+             * @param threads most threads used, caller included, 1 or less means running in caller only
+             */
+            Executor(int threads = 1)
+                    : m_threads(threads) {
+                if (threads > 1) bind(ThreadPool::Global());
+            }
+
+            /**
+             * @param pool
+             * @param threads most threads used, caller included, 0 for all threads of pool
+             */
+            Executor(std::shared_ptr<ThreadPool> pool, int threads = 0)
+                    : m_threads(threads) {
+                if (pool) bind(pool);
+            }
+
+            /**
+             * Use executor shared by host, it must be valid while this handle used.
+             * @param executor
+             * @param threads most threads used, caller included, 0 for all threads of executor
+             */
+            explicit Executor(const SeetaAIPExecutor &executor, int threads = 0)
+                    : m_raw(executor), m_threads(threads) {}
+
+            /**
+             * @return most threads used at same time, caller included
+             */
+            int32_t size() const {
+                if (!m_raw.parallel_for) return 1;
+                auto concurrency = m_raw.concurrency ? m_raw.concurrency(m_raw.context) : 1;
+                return m_threads > 0 ? std::min(m_threads, concurrency) : concurrency;
+            }
+
+            /**
+             * @return C interface to share with AIP, nullptr if running in caller only
+             */
+            const SeetaAIPExecutor *raw() const {
+                return m_raw.parallel_for ? &m_raw : nullptr;
+            }
+
+            /**
+             * @return same executor using at most `threads` threads
+             */
+            self limit(int threads) const {
+                self limited = *this;
+                limited.m_threads = threads;
+                return limited;
+            }
+
+            /**
+             * Run func(first, last) over chunks of [begin, end), return after all done.
+             * The first exception thrown by func is thrown again here, remaining chunks are skipped.
+             */
+            template<typename FUNC>
+            void parallel_range(int32_t begin, int32_t end, FUNC func) const {
+                if (end <= begin) return;
+                if (end - begin == 1 || size() <= 1) {
+                    func(begin, end);
+                    return;
+                }
+                TaskContext<FUNC> context(func);
+                m_raw.parallel_for(m_raw.context, begin, end, m_threads, Task<FUNC>, &context);
+                if (context.error) std::rethrow_exception(context.error);
+            }
+
+        private:
+            template<typename FUNC>
+            struct TaskContext {
+                explicit TaskContext(FUNC &func) : func(func) {}
+
+                FUNC &func;
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+                std::mutex mutex;
+            };
+
+            template<typename FUNC>
+            static void SEETA_AIP_CALL Task(void *data, int32_t first, int32_t last) {
+                auto context = static_cast<TaskContext<FUNC> *>(data);
+                if (context->failed) return;
+                try {
+                    context->func(first, last);
+                } catch (...) {
+                    std::unique_lock<std::mutex> _locker(context->mutex);
+                    if (!context->error) context->error = std::current_exception();
+                    context->failed = true;
+                }
+            }
+
+            void bind(const std::shared_ptr<ThreadPool> &pool) {
+                m_pool = pool;
+                m_raw = pool->raw();
+            }
+
+            SeetaAIPExecutor m_raw = {};
+            int32_t m_threads = 1;
+            std::shared_ptr<ThreadPool> m_pool;
+        };
+
+        /**
+         * Run func(first, last) over chunks of [begin, end) on executor.
+         */
+        template<typename FUNC>
+        static inline void parallel_range(const Executor &executor, int32_t begin, int32_t end, FUNC func) {
+            executor.parallel_range(begin, end, func);
+        }
+
+        /**
+         * Run func(i) for each i in [begin, end) on executor, like `#pragma omp parallel for`.
+         */
+        template<typename FUNC>
+        static inline void parallel_for(const Executor &executor, int32_t begin, int32_t end, FUNC func) {
+            executor.parallel_range(begin, end, [&](int32_t first, int32_t last) {
+                for (auto i = first; i < last; ++i) func(i);
+            });
+        }
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_EXECUTOR_H
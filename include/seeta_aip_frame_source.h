@@ -0,0 +1,402 @@
+#ifndef SEETA_AIP_SEETA_AIP_FRAME_SOURCE_H
+#define SEETA_AIP_SEETA_AIP_FRAME_SOURCE_H
+
+#include "seeta_aip_image_io.h"
+#include "seeta_aip_mapped_file.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <cstring>
+#include <cstdlib>
+
+namespace seeta {
+    namespace aip {
+        namespace _ {
+            /**
+             * Frames of one file, all in same format and size.
+             */
+            struct FrameStream {
+                SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RAW;
+                uint32_t width = 0;
+                uint32_t height = 0;
+                uint32_t channels = 0;
+                double fps = 0;
+                std::function<bool(ImageData &)> read;  ///< fill next frame, false at end of file
+            };
+
+            /**
+             * Slots of frame source, shared with frames given out, so slots could outlive the source.
+             */
+            struct FrameRing {
+                std::vector<ImageData> slots;
+                std::deque<size_t> free;        ///< slots neither filled nor held by caller
+                std::deque<size_t> ready;       ///< filled slots in order of frames
+                bool filling = false;           ///< reader is filling a slot taken from free
+                bool finished = false;          ///< reader got end of file or error
+                bool stopped = false;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable cond;
+            };
+
+            static inline std::shared_ptr<MappedFile> map_frames(const std::string &filename) {
+                auto file = std::make_shared<MappedFile>(filename);
+                if (file->empty()) throw Exception("Can not open frames file: " + filename);
+                return file;
+            }
+
+            /**
+             * @param data JPEG begins with SOI at pos
+             * @return end of JPEG after EOI, 0 if not complete
+             */
+            static inline size_t jpeg_end(const uint8_t *data, size_t size, size_t pos) {
+                pos += 2;
+                while (pos + 2 <= size) {
+                    if (data[pos] != 0xFF) return 0;
+                    auto marker = data[pos + 1];
+                    if (marker == 0xFF) {
+                        ++pos;  // fill byte
+                        continue;
+                    }
+                    if (marker == 0xD9) return pos + 2;
+                    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+                        pos += 2;
+                        continue;
+                    }
+                    if (pos + 4 > size) return 0;
+                    pos += 2 + ((size_t(data[pos + 2]) << 8) | data[pos + 3]);
+                    if (marker != 0xDA) continue;
+                    // entropy coded data, ends at marker other than stuffed 0xFF00 and restarts
+                    while (pos + 1 < size && !(data[pos] == 0xFF && data[pos + 1] != 0x00
+                                               && (data[pos + 1] < 0xD0 || data[pos + 1] > 0xD7))) {
+                        ++pos;
+                    }
+                }
+                return 0;
+            }
+
+            /**
+             * @return position of next SOI from pos, size if none
+             */
+            static inline size_t jpeg_begin(const uint8_t *data, size_t size, size_t pos) {
+                for (; pos + 3 <= size; ++pos) {
+                    if (data[pos] == 0xFF && data[pos + 1] == 0xD8 && data[pos + 2] == 0xFF) return pos;
+                }
+                return size;
+            }
+        }
+
+        /**
+         * Sequential frames read from video file, for replaying and load testing AIPs.
+         * Frames are read into a preallocated ring of images, optionally by a background read-ahead thread.
+         * Each frame given out holds its slot of ring, the slot is reused after all copies of frame released.
+         * Open failures and bad headers are thrown, frames are read until end of file or first broken frame.
+         */
+        class FrameSource {
+        public:
+            using self = FrameSource;
+
+            ~FrameSource() {
+                {
+                    std::unique_lock<std::mutex> _locker(m_ring->mutex);
+                    m_ring->stopped = true;
+                }
+                m_ring->cond.notify_all();
+                if (m_thread.joinable()) m_thread.join();
+            }
+
+            FrameSource(const self &) = delete;
+
+            self &operator=(const self &) = delete;
+
+            /**
+             * Open YUV4MPEG2 file, 8-bit 4:2:0 frames are U8I420, mono frames are U8Y.
+             * @param filename y4m file
+             * @param ring number of preallocated frames
+             * @param read_ahead read frames in background thread
+             * @return frame source
+             */
+            static std::shared_ptr<self> Y4M(const std::string &filename, int ring = 4, bool read_ahead = true) {
+                auto file = _::map_frames(filename);
+                auto data = reinterpret_cast<const char *>(file->data());
+                auto size = file->size();
+                auto line_end = static_cast<const char *>(std::memchr(data, '\n', size));
+                if (size < 10 || std::memcmp(data, "YUV4MPEG2 ", 10) != 0 || !line_end) {
+                    throw Exception("Not YUV4MPEG2 file: " + filename);
+                }
+                _::FrameStream stream;
+                stream.format = SEETA_AIP_FORMAT_U8I420;
+                std::string header(data + 10, line_end);
+                size_t begin = 0;
+                while (begin < header.size()) {
+                    auto end = header.find(' ', begin);
+                    if (end == std::string::npos) end = header.size();
+                    auto token = header.substr(begin, end - begin);
+                    begin = end + 1;
+                    if (token.empty()) continue;
+                    auto value = token.substr(1);
+                    switch (token[0]) {
+                        default: break;
+                        case 'W': stream.width = uint32_t(std::strtoul(value.c_str(), nullptr, 10)); break;
+                        case 'H': stream.height = uint32_t(std::strtoul(value.c_str(), nullptr, 10)); break;
+                        case 'F': {
+                            auto colon = value.find(':');
+                            auto den = colon == std::string::npos ? 0.0 : std::strtod(value.c_str() + colon + 1, nullptr);
+                            if (den > 0) stream.fps = std::strtod(value.c_str(), nullptr) / den;
+                            break;
+                        }
+                        case 'C':
+                            if (value == "mono") {
+                                stream.format = SEETA_AIP_FORMAT_U8Y;
+                            } else if (value.compare(0, 3, "420") != 0 || value == "420p10" || value == "420p12") {
+                                throw Exception("Y4M only support 8-bit 4:2:0 and mono, got C" + value);
+                            }
+                            break;
+                    }
+                }
+                if (stream.width == 0 || stream.height == 0) throw Exception("Y4M header has no size: " + filename);
+                if (stream.format == SEETA_AIP_FORMAT_U8I420 && (stream.width % 2 || stream.height % 2)) {
+                    throw Exception("Y4M 4:2:0 frames must have even size, got " + std::to_string(stream.width)
+                                    + "x" + std::to_string(stream.height));
+                }
+                stream.channels = 1;
+                auto offset = size_t(line_end - data) + 1;
+                stream.read = [file, offset](ImageData &frame) mutable {
+                    auto data = reinterpret_cast<const char *>(file->data());
+                    auto size = file->size();
+                    if (offset + 5 > size || std::memcmp(data + offset, "FRAME", 5) != 0) return false;
+                    auto line_end = static_cast<const char *>(std::memchr(data + offset, '\n', size - offset));
+                    if (!line_end) return false;
+                    auto begin = size_t(line_end - data) + 1;
+                    if (begin + frame.bytes() > size) return false;
+                    std::memcpy(frame.data(), data + begin, frame.bytes());
+                    offset = begin + frame.bytes();
+                    return true;
+                };
+                return std::shared_ptr<self>(new self(std::move(stream), ring, read_ahead));
+            }
+
+            /**
+             * Open headerless file of packed fixed size frames, like raw I420, NV12 or BGR dumps.
+             * Trailing bytes less than one frame are ignored.
+             * @param filename raw file
+             * @param format format of each frame, YUV 4:2:0 frames must have even size
+             * @param width frame width
+             * @param height frame height
+             * @param ring number of preallocated frames
+             * @param read_ahead read frames in background thread
+             * @return frame source
+             */
+            static std::shared_ptr<self> Raw(const std::string &filename, SEETA_AIP_IMAGE_FORMAT format,
+                                             uint32_t width, uint32_t height,
+                                             int ring = 4, bool read_ahead = true) {
+                if (width == 0 || height == 0) throw Exception("Raw frames got zero size.");
+                if (ImageData::IsYUV420(format) && (width % 2 || height % 2)) {
+                    throw Exception("Raw 4:2:0 frames must have even size, got " + std::to_string(width)
+                                    + "x" + std::to_string(height));
+                }
+                auto file = _::map_frames(filename);
+                _::FrameStream stream;
+                stream.format = format;
+                stream.width = width;
+                stream.height = height;
+                stream.channels = ImageData::GetChannels(format, 1);
+                size_t offset = 0;
+                stream.read = [file, offset](ImageData &frame) mutable {
+                    if (offset + frame.bytes() > file->size()) return false;
+                    std::memcpy(frame.data(), file->data() + offset, frame.bytes());
+                    offset += frame.bytes();
+                    return true;
+                };
+                return std::shared_ptr<self>(new self(std::move(stream), ring, read_ahead));
+            }
+
+            /**
+             * Open concatenated JPEG frames, bytes between frames like multipart boundaries are skipped.
+             * All frames must have size of the first one, frames failed to decode are skipped.
+             * @param filename mjpeg file
+             * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA
+             * @param ring number of preallocated frames
+             * @param read_ahead decode frames in background thread
+             * @return frame source
+             */
+            static std::shared_ptr<self> MJPEG(const std::string &filename,
+                                               SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RGB,
+                                               int ring = 4, bool read_ahead = true) {
+                auto channels = uint32_t(_::decode_channels(format));
+                auto file = _::map_frames(filename);
+                auto offset = _::jpeg_begin(file->data(), file->size(), 0);
+                auto end = offset < file->size() ? _::jpeg_end(file->data(), file->size(), offset) : 0;
+                if (!end || end - offset > size_t(INT32_MAX)) throw Exception("No JPEG frame in: " + filename);
+                auto info = probe(file->data() + offset, int(end - offset));
+                if (info.empty()) throw Exception("Broken first JPEG frame in: " + filename);
+                _::FrameStream stream;
+                stream.format = format;
+                stream.width = uint32_t(info.width);
+                stream.height = uint32_t(info.height);
+                stream.channels = channels;
+                stream.read = [file, offset](ImageData &frame) mutable {
+                    auto data = file->data();
+                    auto size = file->size();
+                    while (true) {
+                        offset = _::jpeg_begin(data, size, offset);
+                        if (offset >= size) return false;
+                        auto end = _::jpeg_end(data, size, offset);
+                        if (!end || end - offset > size_t(INT32_MAX)) return false;
+                        auto begin = offset;
+                        offset = end;
+                        auto info = probe(data + begin, int(end - begin));
+                        if (uint32_t(info.width) != frame.width() || uint32_t(info.height) != frame.height()) {
+                            if (info.empty()) continue;
+                            throw Exception("MJPEG frame size changed from " + std::to_string(frame.width()) + "x"
+                                            + std::to_string(frame.height()) + " to " + std::to_string(info.width)
+                                            + "x" + std::to_string(info.height));
+                        }
+                        if (decode(data + begin, int(end - begin), frame)) return true;
+                    }
+                };
+                return std::shared_ptr<self>(new self(std::move(stream), ring, read_ahead));
+            }
+
+            SEETA_AIP_IMAGE_FORMAT format() const { return m_stream.format; }
+
+            uint32_t width() const { return m_stream.width; }
+
+            uint32_t height() const { return m_stream.height; }
+
+            /**
+             * @return frames per second in file header, 0 if unknown
+             */
+            double fps() const { return m_stream.fps; }
+
+            /**
+             * @return number of frames given out
+             */
+            int64_t count() const { return m_count; }
+
+            /**
+             * Get next frame, waiting for reader if read ahead.
+             * Throws if all slots of ring are held by caller, or reader failed.
+             * @param frame [out] next frame, holding its slot of ring until all copies released
+             * @return false at end of file
+             */
+            bool next(ImageData &frame) {
+                size_t slot = 0;
+                if (m_thread.joinable()) {
+                    std::unique_lock<std::mutex> _locker(m_ring->mutex);
+                    m_ring->cond.wait(_locker, [&]() {
+                        return !m_ring->ready.empty() || m_ring->finished
+                               || (m_ring->free.empty() && !m_ring->filling);
+                    });
+                    if (m_ring->ready.empty()) {
+                        if (m_ring->error) std::rethrow_exception(m_ring->error);
+                        if (m_ring->finished) return false;
+                        throw Exception("All " + std::to_string(m_ring->slots.size())
+                                        + " frames of ring are held, release frames before reading more.");
+                    }
+                    slot = m_ring->ready.front();
+                    m_ring->ready.pop_front();
+                } else {
+                    {
+                        std::unique_lock<std::mutex> _locker(m_ring->mutex);
+                        if (m_ring->finished) return false;
+                        if (m_ring->free.empty()) {
+                            throw Exception("All " + std::to_string(m_ring->slots.size())
+                                            + " frames of ring are held, release frames before reading more.");
+                        }
+                        slot = m_ring->free.front();
+                        m_ring->free.pop_front();
+                    }
+                    bool ok = false;
+                    try {
+                        ok = m_stream.read(m_ring->slots[slot]);
+                    } catch (...) {
+                        release(m_ring, slot);
+                        throw;
+                    }
+                    if (!ok) {
+                        std::unique_lock<std::mutex> _locker(m_ring->mutex);
+                        m_ring->finished = true;
+                        m_ring->free.push_front(slot);
+                        return false;
+                    }
+                }
+                auto ring = m_ring;
+                auto &image = m_ring->slots[slot];
+                SeetaAIPImageData raw = {int32_t(image.format()), image.data(), image.number(),
+                                         image.height(), image.width(), image.channels()};
+                frame = ImageData::Adopt(raw, [ring, slot](void *) { release(ring, slot); });
+                ++m_count;
+                return true;
+            }
+
+        private:
+            FrameSource(_::FrameStream stream, int ring, bool read_ahead)
+                    : m_stream(std::move(stream)), m_ring(std::make_shared<_::FrameRing>()) {
+                if (ring < 1) throw Exception("Frame source needs at least 1 frame in ring, got " + std::to_string(ring));
+                for (int i = 0; i < ring; ++i) {
+                    m_ring->slots.emplace_back(m_stream.format, 1, m_stream.width, m_stream.height, m_stream.channels);
+                    m_ring->free.push_back(size_t(i));
+                }
+                if (read_ahead) m_thread = std::thread([this]() { loop(); });
+            }
+
+            static void release(const std::shared_ptr<_::FrameRing> &ring, size_t slot) {
+                {
+                    std::unique_lock<std::mutex> _locker(ring->mutex);
+                    ring->free.push_back(slot);
+                }
+                ring->cond.notify_all();
+            }
+
+            void loop() {
+                auto &ring = *m_ring;
+                while (true) {
+                    size_t slot = 0;
+                    {
+                        std::unique_lock<std::mutex> _locker(ring.mutex);
+                        ring.cond.wait(_locker, [&]() { return ring.stopped || !ring.free.empty(); });
+                        if (ring.stopped) return;
+                        slot = ring.free.front();
+                        ring.free.pop_front();
+                        ring.filling = true;
+                    }
+                    bool ok = false;
+                    std::exception_ptr error;
+                    try {
+                        ok = m_stream.read(ring.slots[slot]);
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    {
+                        std::unique_lock<std::mutex> _locker(ring.mutex);
+                        ring.filling = false;
+                        if (ok) {
+                            ring.ready.push_back(slot);
+                        } else {
+                            ring.free.push_front(slot);
+                            ring.finished = true;
+                            ring.error = error;
+                        }
+                    }
+                    ring.cond.notify_all();
+                    if (!ok) return;
+                }
+            }
+
+            _::FrameStream m_stream;
+            std::shared_ptr<_::FrameRing> m_ring;
+            int64_t m_count = 0;
+            std::thread m_thread;
+        };
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_FRAME_SOURCE_H
@@ -6,18 +6,20 @@
 #define SEETA_AIP_SEETA_AIP_IMAGE_H
 
 #include "seeta_aip_struct.h"
+#include "seeta_aip_affine.h"
+#include "seeta_aip_simd.h"
+#include "seeta_aip_executor.h"
+
+#include <algorithm>
 
 namespace seeta {
     namespace aip {
         namespace _ {
             template<typename SRC, typename DST,
                     typename=typename std::enable_if<std::is_convertible<SRC, DST>::value>::type>
-            static inline void cast(int threads, const SRC *src, DST *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { dst[i] = DST(src[i]); }
+            static inline void cast(const Executor &threads, const SRC *src, DST *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { dst[i] = DST(src[i]); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i) { *dst++ = DST(*src++); }
                 }
@@ -25,19 +27,16 @@ namespace seeta {
 
             template<typename SRC, typename DST,
                     typename=typename std::enable_if<std::is_convertible<SRC, DST>::value>::type>
-            static inline void cast(int threads, const SRC *src, DST *dst, int32_t N, SRC scale) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { dst[i] = DST(scale * src[i]); }
+            static inline void cast(const Executor &threads, const SRC *src, DST *dst, int32_t N, SRC scale) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { dst[i] = DST(scale * src[i]); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i) { *dst++ = DST(scale * *src++); }
                 }
             }
 
             template<typename DST>
-            static inline void cast_to(int threads, const void *src, SEETA_AIP_VALUE_TYPE src_type, DST *dst, uint32_t N,
+            static inline void cast_to(const Executor &threads, const void *src, SEETA_AIP_VALUE_TYPE src_type, DST *dst, uint32_t N,
                                 float data_scale = 1) {
                 switch (src_type) {
                     default:
@@ -74,7 +73,7 @@ namespace seeta {
             }
         }
 
-        static inline void cast(int threads,
+        static inline void cast(const Executor &threads,
                          const void *src, SEETA_AIP_VALUE_TYPE src_type,
                          void *dst, SEETA_AIP_VALUE_TYPE dst_type,
                          uint32_t N, float data_scale = 1) {
@@ -160,13 +159,9 @@ namespace seeta {
                 dst[2] = tmp;
             }
 
-            static inline void convert_uimage_bgr2rgb(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-                    const auto N3 = N * 3;
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) n = 0; n < N3; n += 3) { _bgr2rgb(src + n, dst + n); }
+            static inline void convert_uimage_bgr2rgb(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgr2rgb(src + i * 3, dst + i * 3); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 3, dst += 3) { _bgr2rgb(src, dst); }
                 }
@@ -179,12 +174,9 @@ namespace seeta {
                 dst[3] = 0;
             }
 
-            static inline void convert_uimage_bgr2bgra(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _bgr2bgra(src + i * 3, dst + i * 4); }
+            static inline void convert_uimage_bgr2bgra(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgr2bgra(src + i * 3, dst + i * 4); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 3, dst += 4) { _bgr2bgra(src, dst); }
                 }
@@ -197,12 +189,9 @@ namespace seeta {
                 dst[3] = 0;
             }
 
-            static inline void convert_uimage_bgr2rgba(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _bgr2rgba(src + i * 3, dst + i * 4); }
+            static inline void convert_uimage_bgr2rgba(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgr2rgba(src + i * 3, dst + i * 4); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 3, dst += 4) { _bgr2rgba(src, dst); }
                 }
@@ -214,12 +203,9 @@ namespace seeta {
                 dst[2] = src[2];
             }
 
-            static inline void convert_uimage_bgra2bgr(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _bgra2bgr(src + i * 4, dst + i * 3); }
+            static inline void convert_uimage_bgra2bgr(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgra2bgr(src + i * 4, dst + i * 3); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 4, dst += 3) { _bgra2bgr(src, dst); }
                 }
@@ -231,12 +217,9 @@ namespace seeta {
                 dst[2] = src[0];
             }
 
-            static inline void convert_uimage_bgra2rgb(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _bgra2rgb(src + i * 4, dst + i * 3); }
+            static inline void convert_uimage_bgra2rgb(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgra2rgb(src + i * 4, dst + i * 3); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 4, dst += 3) { _bgra2rgb(src, dst); }
                 }
@@ -250,13 +233,9 @@ namespace seeta {
                 dst[3] = src[3];
             }
 
-            static inline void convert_uimage_bgra2rgba(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-                    const auto N4 = N * 4;
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) n = 0; n < N4; n += 4) { _bgra2rgba(src + n, dst + n); }
+            static inline void convert_uimage_bgra2rgba(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgra2rgba(src + i * 4, dst + i * 4); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 4, dst += 4) { _bgra2rgba(src, dst); }
                 }
@@ -268,12 +247,9 @@ namespace seeta {
                 dst[2] = src[0];
             }
 
-            static inline void convert_uimage_y2bgr(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _y2bgr(src + i, dst + i * 3); }
+            static inline void convert_uimage_y2bgr(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _y2bgr(src + i, dst + i * 3); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 1, dst += 3) { _y2bgr(src, dst); }
                 }
@@ -286,12 +262,9 @@ namespace seeta {
                 dst[3] = 0;
             }
 
-            static inline void convert_uimage_y2bgra(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _y2bgra(src + i, dst + i * 4); }
+            static inline void convert_uimage_y2bgra(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _y2bgra(src + i, dst + i * 4); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 1, dst += 4) { _y2bgra(src, dst); }
                 }
@@ -305,23 +278,17 @@ namespace seeta {
                 dst[0] = Y > 255 ? 255 : Y;
             }
 
-            static inline void convert_uimage_bgr2y(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _bgr2y(src + i * 3, dst + i); }
+            static inline void convert_uimage_bgr2y(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgr2y(src + i * 3, dst + i); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 3, dst += 1) { _bgr2y(src, dst); }
                 }
             }
 
-            static inline void convert_uimage_bgra2y(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _bgr2y(src + i * 4, dst + i); }
+            static inline void convert_uimage_bgra2y(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _bgr2y(src + i * 4, dst + i); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 4, dst += 1) { _bgr2y(src, dst); }
                 }
@@ -335,29 +302,46 @@ namespace seeta {
                 dst[0] = Y > 255 ? 255 : Y;
             }
 
-            static inline void convert_uimage_rgb2y(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _rgb2y(src + i * 3, dst + i); }
+            static inline void convert_uimage_rgb2y(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _rgb2y(src + i * 3, dst + i); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 3, dst += 1) { _rgb2y(src, dst); }
                 }
             }
 
-            static inline void convert_uimage_rgba2y(int threads, const uint8_t *src, uint8_t *dst, int32_t N) {
-                if (threads > 1) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads)
-#endif
-                    for (decltype(N) i = 0; i < N; ++i) { _rgb2y(src + i * 4, dst + i); }
+            static inline void convert_uimage_rgba2y(const Executor &threads, const uint8_t *src, uint8_t *dst, int32_t N) {
+                if (threads.size() > 1) {
+                    parallel_for(threads, 0, N, [&](int32_t i) { _rgb2y(src + i * 4, dst + i); });
                 } else {
                     for (decltype(N) i = 0; i < N; ++i, src += 4, dst += 1) { _rgb2y(src, dst); }
                 }
             }
 
-            static inline void convert_uimage(int threads,
+            static inline simd::UImageKernel simd_uimage_kernel(const simd::UImageKernels *kernels,
+                                                                cvt_format cvt_code) {
+                if (!kernels) return nullptr;
+                switch (cvt_code) {
+                    default: return nullptr;
+                    case BGR2RGB: return kernels->bgr2rgb;
+                    case BGR2BGRA: return kernels->bgr2bgra;
+                    case BGR2RGBA: return kernels->bgr2rgba;
+                    case BGRA2BGR: return kernels->bgra2bgr;
+                    case BGRA2RGB: return kernels->bgra2rgb;
+                    case BGRA2RGBA: return kernels->bgra2rgba;
+                    case Y2BGR: return kernels->y2bgr;
+                    case Y2BGRA: return kernels->y2bgra;
+                    case BGR2Y: return kernels->bgr2y;
+                    case BGRA2Y: return kernels->bgra2y;
+                    case RGB2Y: return kernels->rgb2y;
+                    case RGBA2Y: return kernels->rgba2y;
+                }
+            }
+
+            /**
+             * Convert byte image, use SIMD kernels if running CPU supports, scalar converter is the reference.
+             */
+            static inline void convert_uimage(const Executor &threads,
                                        cvt_format cvt_code, const void *src, void *dst,
                                        uint32_t pixel_number) {
                 static decltype(convert_uimage_bgr2rgb) *converter[] = {
@@ -375,15 +359,40 @@ namespace seeta {
                         convert_uimage_rgb2y,
                         convert_uimage_rgba2y,
                 };
+                // input and output channels of each converter
+                static const int32_t channels[][2] = {
+                        {0, 0},
+                        {3, 3}, {3, 4}, {3, 4},
+                        {4, 3}, {4, 3}, {4, 4},
+                        {1, 3}, {1, 4},
+                        {3, 1}, {4, 1}, {3, 1}, {4, 1},
+                };
                 auto func = converter[cvt_code];
                 if (!func) return;
-                func(threads,
-                     reinterpret_cast<const uint8_t *>(src),
-                     reinterpret_cast<uint8_t *>(dst),
-                     int32_t(pixel_number));
+                auto src_data = reinterpret_cast<const uint8_t *>(src);
+                auto dst_data = reinterpret_cast<uint8_t *>(dst);
+                auto N = int32_t(pixel_number);
+                auto simd_func = simd_uimage_kernel(simd::uimage_kernels(), cvt_code);
+                if (!simd_func) {
+                    func(threads, src_data, dst_data, N);
+                    return;
+                }
+                // each chunk is converted with SIMD kernel, then the rest pixels with scalar code
+                auto in_channels = channels[cvt_code][0];
+                auto out_channels = channels[cvt_code][1];
+                parallel_range(threads, 0, N, [&](int32_t begin, int32_t end) {
+                    auto count = end - begin;
+                    auto part_src = src_data + size_t(begin) * in_channels;
+                    auto part_dst = dst_data + size_t(begin) * out_channels;
+                    auto done = simd_func(part_src, part_dst, count);
+                    if (done < count) {
+                        func(1, part_src + size_t(done) * in_channels, part_dst + size_t(done) * out_channels,
+                             count - done);
+                    }
+                });
             }
 
-            static inline void convert_u8image(int threads,
+            static inline void convert_u8image(const Executor &threads,
                                         const void *src_data, void *dst_data,
                                         uint32_t src_channels, uint32_t dst_channels,
                                         SEETA_AIP_IMAGE_FORMAT src_format,
@@ -410,7 +419,7 @@ namespace seeta {
                 }
             }
 
-            static inline void convert_f32image(int threads,
+            static inline void convert_f32image(const Executor &threads,
                                          const void *src_data, void *dst_data,
                                          uint32_t src_channels, uint32_t dst_channels,
                                          SEETA_AIP_IMAGE_FORMAT src_format,
@@ -427,7 +436,7 @@ namespace seeta {
                 }
             }
 
-            static inline void convert_i32image(int threads,
+            static inline void convert_i32image(const Executor &threads,
                                          const void *src_data, void *dst_data,
                                          uint32_t src_channels, uint32_t dst_channels,
                                          SEETA_AIP_IMAGE_FORMAT src_format,
@@ -444,80 +453,318 @@ namespace seeta {
                 }
             }
 
-            static inline uint32_t offset4d(const uint32_t *shape,
-                              uint32_t dim1, uint32_t dim2, uint32_t dim3, uint32_t dim4)
-            {
-                return ((dim1 * shape[1] + dim2) * shape[2] + dim3) * shape[3] + dim4;
-            }
-
-            template <typename T>
-            static inline void permute4d(
-                    T *dst, const T *src,
-                    const uint32_t *shape,
-                    uint32_t dim1, uint32_t dim2, uint32_t dim3, uint32_t dim4)
-            {
-                std::vector<uint32_t> dim(4), redim(4), idx(4);
-                dim[0] = dim1; redim[dim[0]] = 0;
-                dim[1] = dim2; redim[dim[1]] = 1;
-                dim[2] = dim3; redim[dim[2]] = 2;
-                dim[3] = dim4; redim[dim[3]] = 3;
-
-                std::vector<int> new_dims(4);
-                for (int i = 0; i < 4; ++i) new_dims[i] = shape[dim[i]];
-
-                int cnt = 0;
-                for (idx[0] = 0; idx[0] < shape[dim[0]]; ++idx[0]) {
-                    for (idx[1] = 0; idx[1] < shape[dim[1]]; ++idx[1]) {
-                        for (idx[2] = 0; idx[2] < shape[dim[2]]; ++idx[2]) {
-                            for (idx[3] = 0; idx[3] < shape[dim[3]]; ++idx[3]) {
-                                dst[cnt] = src[offset4d(
-                                        shape,
-                                        idx[redim[0]], idx[redim[1]], idx[redim[2]], idx[redim[3]])];
-                                cnt++;
-                            }
-                        }
-                    }
+            /**
+             * Scatter one HWC row of `width` pixels into `C` planes, `plane` elements between two planes.
+             */
+            template<typename T, int C>
+            static inline void _deinterleave_row(const T *src, T *dst, size_t plane, int32_t width) {
+                for (int c = 0; c < C; ++c) {
+                    auto out = dst + c * plane;
+                    auto in = src + c;
+                    for (int32_t x = 0; x < width; ++x) out[x] = in[x * C];
                 }
             }
-            static inline void permute4d(
-                    SEETA_AIP_VALUE_TYPE type,
-                    void *dst, const void *src,
-                    const uint32_t *shape,
-                    uint32_t dim1, uint32_t dim2, uint32_t dim3, uint32_t dim4) {
-                switch (type) {
+
+            /**
+             * Gather one row of `width` pixels from `C` planes into HWC row, `plane` elements between two planes.
+             */
+            template<typename T, int C>
+            static inline void _interleave_row(const T *src, T *dst, size_t plane, int32_t width) {
+                for (int c = 0; c < C; ++c) {
+                    auto in = src + c * plane;
+                    auto out = dst + c;
+                    for (int32_t x = 0; x < width; ++x) out[x * C] = in[x];
+                }
+            }
+
+            template<typename T>
+            static inline void _deinterleave_row(const T *src, T *dst, size_t plane, int32_t width, int32_t channels) {
+                switch (channels) {
+                    case 1: std::memcpy(dst, src, width * sizeof(T)); return;
+                    case 2: _deinterleave_row<T, 2>(src, dst, plane, width); return;
+                    case 3: _deinterleave_row<T, 3>(src, dst, plane, width); return;
+                    case 4: _deinterleave_row<T, 4>(src, dst, plane, width); return;
+                    default: break;
+                }
+                for (int32_t c = 0; c < channels; ++c) {
+                    for (int32_t x = 0; x < width; ++x) dst[c * plane + x] = src[x * channels + c];
+                }
+            }
+
+            template<typename T>
+            static inline void _interleave_row(const T *src, T *dst, size_t plane, int32_t width, int32_t channels) {
+                switch (channels) {
+                    case 1: std::memcpy(dst, src, width * sizeof(T)); return;
+                    case 2: _interleave_row<T, 2>(src, dst, plane, width); return;
+                    case 3: _interleave_row<T, 3>(src, dst, plane, width); return;
+                    case 4: _interleave_row<T, 4>(src, dst, plane, width); return;
+                    default: break;
+                }
+                for (int32_t c = 0; c < channels; ++c) {
+                    for (int32_t x = 0; x < width; ++x) dst[x * channels + c] = src[c * plane + x];
+                }
+            }
+
+            /**
+             * Move one row between HWC and CHW layout, only element width matters.
+             * @param element_width bytes of one value, 1, 2, 4 or 8
+             * @param to_chw true for HWC row to CHW planes, false for CHW planes to HWC row
+             */
+            static inline void transpose_row(uint32_t element_width, bool to_chw,
+                                             const void *src, void *dst, size_t plane,
+                                             int32_t width, int32_t channels) {
+#define __SEETA_AIP_TRANSPOSE_ROW(T) \
+                if (to_chw) _deinterleave_row(reinterpret_cast<const T *>(src), reinterpret_cast<T *>(dst), \
+                                              plane, width, channels); \
+                else _interleave_row(reinterpret_cast<const T *>(src), reinterpret_cast<T *>(dst), \
+                                     plane, width, channels);
+                switch (element_width) {
                     default:
                         throw seeta::aip::Exception("Got unknown value type.");
-                    case SEETA_AIP_VALUE_VOID:
+                    case 0:
                         break;
-                    case SEETA_AIP_VALUE_BYTE:
-                    {
-                        using T = uint8_t;
-                        permute4d(reinterpret_cast<T*>(dst), reinterpret_cast<const T*>(src), shape,
-                                  dim1, dim2, dim3, dim4);
+                    case 1:
+                        __SEETA_AIP_TRANSPOSE_ROW(uint8_t)
                         break;
-                    }
-                    case SEETA_AIP_VALUE_INT32:
-                    {
-                        using T = int32_t ;
-                        permute4d(reinterpret_cast<T*>(dst), reinterpret_cast<const T*>(src), shape,
-                                  dim1, dim2, dim3, dim4);
+                    case 2:
+                        __SEETA_AIP_TRANSPOSE_ROW(uint16_t)
                         break;
-                    }
-                    case SEETA_AIP_VALUE_FLOAT32:
-                    {
-                        using T = float;
-                        permute4d(reinterpret_cast<T*>(dst), reinterpret_cast<const T*>(src), shape,
-                                  dim1, dim2, dim3, dim4);
+                    case 4:
+                        __SEETA_AIP_TRANSPOSE_ROW(uint32_t)
+                        break;
+                    case 8:
+                        __SEETA_AIP_TRANSPOSE_ROW(uint64_t)
                         break;
+                }
+#undef __SEETA_AIP_TRANSPOSE_ROW
+            }
+
+            /**
+             * Transpose packed images between NHWC and NCHW, parallelized over N and H.
+             * Each task moves one row, so source and destination are both walked in memory order.
+             * @param to_chw true for NHWC to NCHW, false for NCHW to NHWC
+             */
+            static inline void transpose(const Executor &threads, uint32_t element_width, bool to_chw,
+                                         const void *src, void *dst,
+                                         uint32_t number, uint32_t height, uint32_t width, uint32_t channels) {
+                auto src_data = reinterpret_cast<const uint8_t *>(src);
+                auto dst_data = reinterpret_cast<uint8_t *>(dst);
+                auto plane = size_t(height) * width;
+                auto row_bytes = size_t(width) * channels * element_width;
+                auto image_bytes = plane * channels * element_width;
+                auto H = int32_t(height);
+                auto rows = int32_t(number) * H;
+                parallel_for(threads, 0, rows, [&](int32_t i) {
+                    auto n = i / H;
+                    auto y = i % H;
+                    auto hwc_offset = n * image_bytes + y * row_bytes;
+                    auto chw_offset = n * image_bytes + y * size_t(width) * element_width;
+                    if (to_chw) {
+                        transpose_row(element_width, true, src_data + hwc_offset, dst_data + chw_offset,
+                                      plane, int32_t(width), int32_t(channels));
+                    } else {
+                        transpose_row(element_width, false, src_data + chw_offset, dst_data + hwc_offset,
+                                      plane, int32_t(width), int32_t(channels));
                     }
-                    case SEETA_AIP_VALUE_FLOAT64:
-                    {
-                        using T = double;
-                        permute4d(reinterpret_cast<T*>(dst), reinterpret_cast<const T*>(src), shape,
-                                  dim1, dim2, dim3, dim4);
+                });
+            }
+
+            /**
+             * Planes of one YUV 4:2:0 image
+             */
+            struct YUV420Planes {
+                const uint8_t *y;
+                const uint8_t *u;
+                const uint8_t *v;
+                int32_t uv_step;    ///< bytes between two chroma samples in one row
+                int32_t uv_stride;  ///< bytes between two chroma rows
+            };
+
+            static inline YUV420Planes yuv420_planes(SEETA_AIP_IMAGE_FORMAT format, const uint8_t *data,
+                                                     int32_t width, int32_t height) {
+                YUV420Planes planes;
+                auto chroma = data + width * height;
+                planes.y = data;
+                switch (format) {
+                    default:
+                    case SEETA_AIP_FORMAT_U8NV12:
+                        planes.u = chroma;
+                        planes.v = chroma + 1;
+                        planes.uv_step = 2;
+                        planes.uv_stride = width;
                         break;
+                    case SEETA_AIP_FORMAT_U8NV21:
+                        planes.v = chroma;
+                        planes.u = chroma + 1;
+                        planes.uv_step = 2;
+                        planes.uv_stride = width;
+                        break;
+                    case SEETA_AIP_FORMAT_U8I420:
+                        planes.u = chroma;
+                        planes.v = chroma + (width / 2) * (height / 2);
+                        planes.uv_step = 1;
+                        planes.uv_stride = width / 2;
+                        break;
+                }
+                return planes;
+            }
+
+            static inline uint8_t _clamp_u8(int32_t x) {
+                return uint8_t(x < 0 ? 0 : (x > 255 ? 255 : x));
+            }
+
+            /**
+             * BT.601 limited range, same as most cameras and video decoders output.
+             */
+            static inline void _yuv2bgr(int32_t y, int32_t u, int32_t v, uint8_t *bgr) {
+                auto c = 298 * (y - 16);
+                auto d = u - 128;
+                auto e = v - 128;
+                bgr[0] = _clamp_u8((c + 516 * d + 128) >> 8);
+                bgr[1] = _clamp_u8((c - 100 * d - 208 * e + 128) >> 8);
+                bgr[2] = _clamp_u8((c + 409 * e + 128) >> 8);
+            }
+
+            /**
+             * Get B, G, R index and pixel step of format.
+             * @return false if format is not BGR like.
+             */
+            static inline bool bgr_layout(SEETA_AIP_IMAGE_FORMAT format, int32_t *b, int32_t *g, int32_t *r,
+                                          int32_t *step) {
+                switch (format) {
+                    default:
+                        return false;
+                    case SEETA_AIP_FORMAT_U8BGR:
+                        *b = 0; *g = 1; *r = 2; *step = 3;
+                        return true;
+                    case SEETA_AIP_FORMAT_U8RGB:
+                        *b = 2; *g = 1; *r = 0; *step = 3;
+                        return true;
+                    case SEETA_AIP_FORMAT_U8BGRA:
+                        *b = 0; *g = 1; *r = 2; *step = 4;
+                        return true;
+                    case SEETA_AIP_FORMAT_U8RGBA:
+                        *b = 2; *g = 1; *r = 0; *step = 4;
+                        return true;
+                }
+            }
+
+            static inline void check_yuv420_size(const SeetaAIPImageData &image) {
+                if (image.width % 2 || image.height % 2) {
+                    std::ostringstream oss;
+                    oss << "YUV 4:2:0 image must have even size, got " << image.width << "x" << image.height;
+                    throw seeta::aip::Exception(oss.str());
+                }
+            }
+
+            /**
+             * Convert packed YUV 4:2:0 images into packed BGR like or U8Y images with same size.
+             */
+            static inline void convert_yuv420_u8image(const Executor &threads, const SeetaAIPImageData &src,
+                                                      const SeetaAIPImageData &dst) {
+                check_yuv420_size(src);
+                if (src.number != dst.number || src.height != dst.height || src.width != dst.width) {
+                    throw seeta::aip::Exception("Convert YUV image size must be equal.");
+                }
+                auto src_format = SEETA_AIP_IMAGE_FORMAT(src.format);
+                auto dst_format = SEETA_AIP_IMAGE_FORMAT(dst.format);
+                auto W = int32_t(src.width);
+                auto H = int32_t(src.height);
+                auto src_data = reinterpret_cast<const uint8_t *>(src.data);
+                auto dst_data = reinterpret_cast<uint8_t *>(dst.data);
+                auto src_image_bytes = size_t(W) * H * 3 / 2;
+                if (dst_format == SEETA_AIP_FORMAT_U8Y) {
+                    for (uint32_t n = 0; n < src.number; ++n) {
+                        std::memcpy(dst_data + n * size_t(W) * H, src_data + n * src_image_bytes, size_t(W) * H);
                     }
+                    return;
+                }
+                int32_t b, g, r, step;
+                if (!bgr_layout(dst_format, &b, &g, &r, &step)) {
+                    throw seeta::aip::Exception("Convert YUV image only support BGR, RGB, BGRA, RGBA and Y output.");
                 }
+                auto rows = int32_t(src.number) * H;
+                parallel_for(threads, 0, rows, [&](int32_t i) {
+                    auto n = i / H;
+                    auto y = i % H;
+                    auto planes = yuv420_planes(src_format, src_data + n * src_image_bytes, W, H);
+                    auto y_row = planes.y + y * W;
+                    auto u_row = planes.u + (y / 2) * planes.uv_stride;
+                    auto v_row = planes.v + (y / 2) * planes.uv_stride;
+                    auto out = dst_data + size_t(i) * W * step;
+                    uint8_t bgr[3];
+                    for (int32_t x = 0; x < W; ++x, out += step) {
+                        auto uv = (x / 2) * planes.uv_step;
+                        _yuv2bgr(y_row[x], u_row[uv], v_row[uv], bgr);
+                        out[b] = bgr[0];
+                        out[g] = bgr[1];
+                        out[r] = bgr[2];
+                        if (step == 4) out[3] = 0;
+                    }
+                });
+            }
+
+            static inline float _sample_plane(const uint8_t *plane, int32_t step, int32_t stride,
+                                              int32_t width, int32_t height, float x, float y) {
+                x = std::max(0.0f, std::min(x, float(width - 1)));
+                y = std::max(0.0f, std::min(y, float(height - 1)));
+                auto x0 = int32_t(x);
+                auto y0 = int32_t(y);
+                auto x1 = std::min(x0 + 1, width - 1);
+                auto y1 = std::min(y0 + 1, height - 1);
+                auto fx = x - float(x0);
+                auto fy = y - float(y0);
+                auto r0 = plane + y0 * stride;
+                auto r1 = plane + y1 * stride;
+                auto top = float(r0[x0 * step]) * (1 - fx) + float(r0[x1 * step]) * fx;
+                auto bottom = float(r1[x0 * step]) * (1 - fx) + float(r1[x1 * step]) * fx;
+                return top * (1 - fy) + bottom * fy;
+            }
+
+            /**
+             * Bilinear sample packed YUV 4:2:0 images into BGR like images with dst size,
+             * no full size converted image allocated.
+             */
+            static inline void convert_resize_yuv420_u8image(const Executor &threads, const SeetaAIPImageData &src,
+                                                             const SeetaAIPImageData &dst) {
+                check_yuv420_size(src);
+                auto src_format = SEETA_AIP_IMAGE_FORMAT(src.format);
+                auto dst_format = SEETA_AIP_IMAGE_FORMAT(dst.format);
+                int32_t b, g, r, step;
+                if (!bgr_layout(dst_format, &b, &g, &r, &step)) {
+                    throw seeta::aip::Exception("Convert YUV image only support BGR, RGB, BGRA, RGBA and Y output.");
+                }
+                auto W = int32_t(src.width);
+                auto H = int32_t(src.height);
+                auto DST_W = int32_t(dst.width);
+                auto DST_H = int32_t(dst.height);
+                auto src_data = reinterpret_cast<const uint8_t *>(src.data);
+                auto dst_data = reinterpret_cast<uint8_t *>(dst.data);
+                auto src_image_bytes = size_t(W) * H * 3 / 2;
+                // same pixel center mapping as resize
+                auto scale_x = float(W) / float(DST_W);
+                auto scale_y = float(H) / float(DST_H);
+                auto rows = int32_t(dst.number) * DST_H;
+                parallel_for(threads, 0, rows, [&](int32_t i) {
+                    auto n = i / DST_H;
+                    auto sy = (float(i % DST_H) + 0.5f) * scale_y - 0.5f;
+                    auto cy = (sy + 0.5f) / 2 - 0.5f;
+                    auto planes = yuv420_planes(src_format, src_data + n * src_image_bytes, W, H);
+                    auto out = dst_data + size_t(i) * DST_W * step;
+                    uint8_t bgr[3];
+                    for (int32_t x = 0; x < DST_W; ++x, out += step) {
+                        auto sx = (float(x) + 0.5f) * scale_x - 0.5f;
+                        auto cx = (sx + 0.5f) / 2 - 0.5f;
+                        auto Y = _sample_plane(planes.y, 1, W, W, H, sx, sy);
+                        auto U = _sample_plane(planes.u, planes.uv_step, planes.uv_stride, W / 2, H / 2, cx, cy);
+                        auto V = _sample_plane(planes.v, planes.uv_step, planes.uv_stride, W / 2, H / 2, cx, cy);
+                        _yuv2bgr(int32_t(Y + 0.5f), int32_t(U + 0.5f), int32_t(V + 0.5f), bgr);
+                        out[b] = bgr[0];
+                        out[g] = bgr[1];
+                        out[r] = bgr[2];
+                        if (step == 4) out[3] = 0;
+                    }
+                });
             }
         }
 
@@ -539,9 +786,70 @@ namespace seeta {
             }
         }
 
-        static inline void convert(int threads,
-                            SeetaAIPImageData src, SeetaAIPImageData dst,
+        /**
+         * Use `threads` to convert src image into dst image, rows of strided HWC images are supported.
+         * @param threads executor running kernels, or number of threads
+         * @param strided_src original image
+         * @param strided_dst converted image, having same size of src
+         * @param data_scale used when convert float value to wanted format. the image value while multiply `data_scale`.
+         */
+        static inline void convert(const Executor &threads,
+                            const ImageView &strided_src, const ImageView &strided_dst,
                             float data_scale = 255.0) {
+            if (!ImageData::IsPacked(strided_src) || !ImageData::IsPacked(strided_dst)) {
+                // YUV planes are handled as CHW, only packed supported
+                bool src_chw = (strided_src.format & 0xffff0000) == 0x80000
+                        || ImageData::IsYUV420(SEETA_AIP_IMAGE_FORMAT(strided_src.format));
+                bool dst_chw = (strided_dst.format & 0xffff0000) == 0x80000
+                        || ImageData::IsYUV420(SEETA_AIP_IMAGE_FORMAT(strided_dst.format));
+                if ((src_chw && !ImageData::IsPacked(strided_src)) || (dst_chw && !ImageData::IsPacked(strided_dst))) {
+                    throw seeta::aip::Exception("Strided image only support HWC format.");
+                }
+                if (src_chw || dst_chw) {
+                    // pack the strided HWC side, then convert between packed images
+                    if (dst_chw) {
+                        seeta::aip::ImageData tmp(SEETA_AIP_IMAGE_FORMAT(strided_src.format), strided_src.number,
+                                                  strided_src.width, strided_src.height, strided_src.channels);
+                        ImageData::Pack(strided_src, tmp.data());
+                        convert(threads, tmp, strided_dst, data_scale);
+                    } else {
+                        seeta::aip::ImageData tmp(SEETA_AIP_IMAGE_FORMAT(strided_dst.format), strided_dst.number,
+                                                  strided_dst.width, strided_dst.height, strided_dst.channels);
+                        convert(threads, strided_src, tmp, data_scale);
+                        convert(threads, tmp, strided_dst, data_scale);
+                    }
+                    return;
+                }
+                if (strided_src.number != strided_dst.number
+                    || strided_src.height != strided_dst.height
+                    || strided_src.width != strided_dst.width) {
+                    throw seeta::aip::Exception("Convert strided images' size must be equal.");
+                }
+                auto src_row_stride = ImageData::GetRowStride(strided_src);
+                auto src_image_stride = ImageData::GetImageStride(strided_src);
+                auto dst_row_stride = ImageData::GetRowStride(strided_dst);
+                auto dst_image_stride = ImageData::GetImageStride(strided_dst);
+                auto src_data = reinterpret_cast<uint8_t *>(strided_src.data);
+                auto dst_data = reinterpret_cast<uint8_t *>(strided_dst.data);
+                auto height = int(strided_src.height);
+                auto rows = int(strided_src.number) * height;
+                parallel_for(threads, 0, rows, [&](int32_t i) {
+                    auto n = i / height;
+                    auto y = i % height;
+                    SeetaAIPImageData src_row = {strided_src.format,
+                                                 src_data + size_t(n) * src_image_stride + size_t(y) * src_row_stride,
+                                                 1, 1, strided_src.width, strided_src.channels};
+                    SeetaAIPImageData dst_row = {strided_dst.format,
+                                                 dst_data + size_t(n) * dst_image_stride + size_t(y) * dst_row_stride,
+                                                 1, 1, strided_dst.width, strided_dst.channels};
+                    convert(1, src_row, dst_row, data_scale);
+                });
+                return;
+            }
+            SeetaAIPImageData src = {strided_src.format, strided_src.data, strided_src.number,
+                                     strided_src.height, strided_src.width, strided_src.channels};
+            SeetaAIPImageData dst = {strided_dst.format, strided_dst.data, strided_dst.number,
+                                     strided_dst.height, strided_dst.width, strided_dst.channels};
             if (src.format == dst.format) {
                 auto SRC_N = src.number * src.height * src.width;
                 auto DST_N = dst.number * dst.height * dst.width;
@@ -549,7 +857,6 @@ namespace seeta {
                     throw seeta::aip::Exception("Convert image pixels' number must be equal.");
                 }
                 auto src_format = SEETA_AIP_IMAGE_FORMAT(src.format);
-                auto type_width = image_format_element_width(src_format);
                 auto src_data = src.data;
                 auto dst_data = dst.data;
                 auto src_channels = seeta::aip::ImageData::GetChannels(src_format, src.channels);
@@ -557,23 +864,84 @@ namespace seeta {
                 if (src_channels != dst_channels) {
                     throw seeta::aip::Exception("Convert images' channels must be equal with format are same.");
                 }
-                std::memcpy(dst_data, src_data, SRC_N * src_channels * type_width);
+                std::memcpy(dst_data, src_data, ImageData::GetBytes(src));
                 return;
             }
-            if ((src.format & 0xffff0000) == 0x80000) {   // CHW format
-                seeta::aip::ImageData tmp( SEETA_AIP_IMAGE_FORMAT(src.format & 0x0000ffff),
-                                           src.number, src.width, src.height, src.channels);
-                uint32_t chw_shape[] = {src.number, src.channels, src.height, src.width };
-                _::permute4d(tmp.type(), tmp.data(), src.data, chw_shape, 0, 2, 3, 1);
-                convert(threads, tmp, dst);
+            if (ImageData::IsYUV420(SEETA_AIP_IMAGE_FORMAT(src.format))) {
+                int32_t b, g, r, step;
+                if (dst.format == SEETA_AIP_FORMAT_U8Y
+                    || _::bgr_layout(SEETA_AIP_IMAGE_FORMAT(dst.format), &b, &g, &r, &step)) {
+                    _::convert_yuv420_u8image(threads, src, dst);
+                    return;
+                }
+                seeta::aip::ImageData tmp(SEETA_AIP_FORMAT_U8BGR, src.number, src.width, src.height, 3);
+                _::convert_yuv420_u8image(threads, src, tmp);
+                convert(threads, tmp, dst, data_scale);
                 return;
             }
-            if ((dst.format & 0xffff0000) == 0x80000) {   // CHW format
-                seeta::aip::ImageData tmp( SEETA_AIP_IMAGE_FORMAT(dst.format & 0x0000ffff),
-                                           dst.number, dst.width, dst.height, dst.channels);
-                convert(threads, src, tmp);
-                uint32_t hwc_shape[] = {dst.number, dst.height, dst.width, dst.channels };
-                _::permute4d(tmp.type(), dst.data, tmp.data(), hwc_shape, 0, 3, 1, 2);
+            if (ImageData::IsYUV420(SEETA_AIP_IMAGE_FORMAT(dst.format))) {
+                throw seeta::aip::Exception(
+                        std::string("Convert image to YUV format not supported, got ") + format_string(dst.format));
+            }
+            auto src_chw = (src.format & 0xffff0000) == 0x80000;
+            auto dst_chw = (dst.format & 0xffff0000) == 0x80000;
+            if (src_chw || dst_chw) {
+                if (src.number != dst.number || src.height != dst.height || src.width != dst.width) {
+                    throw seeta::aip::Exception("Convert CHW images' size must be equal.");
+                }
+                auto src_hwc_format = SEETA_AIP_IMAGE_FORMAT(src.format & 0x0000ffff);
+                auto dst_hwc_format = SEETA_AIP_IMAGE_FORMAT(dst.format & 0x0000ffff);
+                auto src_channels = ImageData::GetChannels(src_hwc_format, src.channels);
+                auto dst_channels = ImageData::GetChannels(dst_hwc_format, dst.channels);
+                auto src_width = ImageData::GetElementWidth(src_hwc_format);
+                auto dst_width = ImageData::GetElementWidth(dst_hwc_format);
+                if (src_hwc_format == dst_hwc_format) {
+                    if (src_channels != dst_channels) {
+                        throw seeta::aip::Exception("Convert images' channels must be equal with format are same.");
+                    }
+                    _::transpose(threads, src_width, dst_chw, src.data, dst.data,
+                                 src.number, src.height, src.width, src_channels);
+                    return;
+                }
+                // convert row by row, only CHW side row is transposed through a row buffer of each chunk
+                auto W = src.width;
+                auto H = int32_t(src.height);
+                auto plane = size_t(src.height) * W;
+                auto src_image_bytes = plane * src_channels * src_width;
+                auto dst_image_bytes = plane * dst_channels * dst_width;
+                auto src_row_bytes = size_t(W) * src_channels * src_width;
+                auto dst_row_bytes = size_t(W) * dst_channels * dst_width;
+                auto src_data = reinterpret_cast<const uint8_t *>(src.data);
+                auto dst_data = reinterpret_cast<uint8_t *>(dst.data);
+                auto rows = int32_t(src.number) * H;
+                parallel_range(threads, 0, rows, [&](int32_t begin, int32_t end) {
+                    std::unique_ptr<uint8_t[]> src_buffer(src_chw ? new uint8_t[src_row_bytes] : nullptr);
+                    std::unique_ptr<uint8_t[]> dst_buffer(dst_chw ? new uint8_t[dst_row_bytes] : nullptr);
+                    for (int32_t i = begin; i < end; ++i) {
+                        auto n = i / H;
+                        auto y = i % H;
+                        const uint8_t *src_row;
+                        uint8_t *dst_row;
+                        if (src_chw) {
+                            _::transpose_row(src_width, false,
+                                             src_data + n * src_image_bytes + y * size_t(W) * src_width,
+                                             src_buffer.get(), plane, int32_t(W), int32_t(src_channels));
+                            src_row = src_buffer.get();
+                        } else {
+                            src_row = src_data + n * src_image_bytes + y * src_row_bytes;
+                        }
+                        dst_row = dst_chw ? dst_buffer.get() : dst_data + n * dst_image_bytes + y * dst_row_bytes;
+                        SeetaAIPImageData src_view = {int32_t(src_hwc_format), const_cast<uint8_t *>(src_row),
+                                                      1, 1, W, src.channels};
+                        SeetaAIPImageData dst_view = {int32_t(dst_hwc_format), dst_row, 1, 1, W, dst.channels};
+                        convert(1, src_view, dst_view, data_scale);
+                        if (dst_chw) {
+                            _::transpose_row(dst_width, true, dst_buffer.get(),
+                                             dst_data + n * dst_image_bytes + y * size_t(W) * dst_width,
+                                             plane, int32_t(W), int32_t(dst_channels));
+                        }
+                    }
+                });
                 return;
             }
 
@@ -630,54 +998,55 @@ namespace seeta {
 
         /**
          * Use `threads` to convert image to `format`.
-         * @param threads using threads(OpenMP)
+         * @param threads executor running kernels, or number of threads
          * @param format wanted format
          * @param image original image
          * @param data_scale used when convert float value to wanted format. the image value while multiply `data_scale`.
          * @return
          */
-        static seeta::aip::ImageData convert(int threads,
+        static seeta::aip::ImageData convert(const Executor &threads,
                             SEETA_AIP_IMAGE_FORMAT format,
-                            SeetaAIPImageData image,
+                            ImageView image,
                             float data_scale = 255.0) {
             seeta::aip::ImageData converted(format,
                                             image.number,
                                             image.width,
                                             image.height,
                                             seeta::aip::ImageData::GetChannels(format, image.channels));
-            convert(threads, image, SeetaAIPImageData(converted), data_scale);
+            convert(threads, image, converted, data_scale);
             return converted;
         }
 
         /**
          * Use `threads` to convert image to `format`.
-         * @param threads using threads(OpenMP)
+         * @param threads executor running kernels, or number of threads
          * @param format wanted format
          * @param image original image
          * @param data_scale used when convert float value to wanted format. the image value while multiply `data_scale`.
          * @return
          */
-        static seeta::aip::ImageData convert(int threads,
+        static seeta::aip::ImageData convert(const Executor &threads,
                                              SEETA_AIP_IMAGE_FORMAT format,
                                              const seeta::aip::ImageData &image,
                                              float data_scale = 255.0) {
-            return convert(threads, format, SeetaAIPImageData(image), data_scale);
+            ImageView view = image;
+            return convert(threads, format, view, data_scale);
         }
 
         /**
          * Use `threads` to convert image to `format`.:q:q
          *
-         * @param threads using threads(OpenMP)
+         * @param threads executor running kernels, or number of threads
          * @param format wanted format
          * @param align memory align
          * @param image original image
          * @param data_scale used when convert float value to wanted format. the image value while multiply `data_scale`.
          * @return
          */
-        static seeta::aip::ImageData convert(int threads,
+        static seeta::aip::ImageData convert(const Executor &threads,
                                              SEETA_AIP_IMAGE_FORMAT format,
                                              const ImageAlign &align,
-                                             SeetaAIPImageData image,
+                                             ImageView image,
                                              float data_scale = 255.0) {
             seeta::aip::ImageData converted(format,
                                             align,
@@ -685,25 +1054,443 @@ namespace seeta {
                                             image.width,
                                             image.height,
                                             seeta::aip::ImageData::GetChannels(format, image.channels));
-            convert(threads, image, SeetaAIPImageData(converted), data_scale);
+            convert(threads, image, converted, data_scale);
             return converted;
         }
 
         /**
          * Use `threads` to convert image to `format`.
-         * @param threads using threads(OpenMP)
+         * @param threads executor running kernels, or number of threads
          * @param format wanted format
          * @param align memory align
          * @param image original image
          * @param data_scale used when convert float value to wanted format. the image value while multiply `data_scale`.
          * @return
          */
-        static seeta::aip::ImageData convert(int threads,
+        static seeta::aip::ImageData convert(const Executor &threads,
                                              SEETA_AIP_IMAGE_FORMAT format,
                                              const ImageAlign &align,
                                              const seeta::aip::ImageData &image,
                                              float data_scale = 255.0) {
-            return convert(threads, format, align, SeetaAIPImageData(image), data_scale);
+            ImageView view = image;
+            return convert(threads, format, align, view, data_scale);
+        }
+
+        /**
+         * Use `threads` to convert image to `format` with size `width x height`.
+         * YUV 4:2:0 image is sampled from its planes directly, no full size converted image allocated.
+         * @param threads executor running kernels, or number of threads
+         * @param format wanted format
+         * @param image original image
+         * @param width resized image width
+         * @param height resized image height
+         * @return converted image `width x height`
+         */
+        static seeta::aip::ImageData convert_resize(const Executor &threads,
+                                                    SEETA_AIP_IMAGE_FORMAT format,
+                                                    ImageView image,
+                                                    int width, int height) {
+            auto image_format = SEETA_AIP_IMAGE_FORMAT(image.format);
+            if (!ImageData::IsYUV420(image_format)) {
+                return convert(threads, format, resize(threads, image, width, height));
+            }
+            if (!ImageData::IsPacked(image)) {
+                throw seeta::aip::Exception("Strided image only support HWC format.");
+            }
+            if (format == SEETA_AIP_FORMAT_U8Y) {
+                // Y plane is gray image already
+                return resize(threads, ImageData::Borrow(image).y_plane(), width, height);
+            }
+            SeetaAIPImageData src = {image.format, image.data, image.number, image.height, image.width, 1};
+            int32_t b, g, r, step;
+            if (_::bgr_layout(format, &b, &g, &r, &step)) {
+                seeta::aip::ImageData converted(format, image.number, width, height, 3);
+                _::convert_resize_yuv420_u8image(threads, src, converted);
+                return converted;
+            }
+            seeta::aip::ImageData tmp(SEETA_AIP_FORMAT_U8BGR, image.number, width, height, 3);
+            _::convert_resize_yuv420_u8image(threads, src, tmp);
+            return convert(threads, format, tmp);
+        }
+
+        /**
+         * Setting of preprocess, each output value is `(sampled - mean[c]) / std[c]`.
+         * mean and std are in source value units, e.g. 0~255 for byte images.
+         */
+        struct PreprocessParam {
+            /**
+             * Channel order of output, one of U8BGR, U8RGB, U8BGRA, U8RGBA, U8Y,
+             * or U8RAW to keep channels of source, BGR for YUV source.
+             * Only used when output format do not tell the channel order, like F32RAW and CHW_F32RAW.
+             * Default U8RAW works for any source, color orders need color or gray source.
+             */
+            SEETA_AIP_IMAGE_FORMAT color = SEETA_AIP_FORMAT_U8RAW;
+            float mean[4] = {0, 0, 0, 0};
+            float std[4] = {1, 1, 1, 1};
+
+            PreprocessParam() = default;
+
+            PreprocessParam(SEETA_AIP_IMAGE_FORMAT color,
+                            const std::vector<float> &mean, const std::vector<float> &std)
+                    : color(color) {
+                for (size_t i = 0; i < 4 && i < mean.size(); ++i) this->mean[i] = mean[i];
+                for (size_t i = 0; i < 4 && i < std.size(); ++i) this->std[i] = std[i];
+            }
+        };
+
+        namespace _ {
+            static const int32_t PREPROCESS_ZERO = -1;  ///< output channel filled with 0
+            static const int32_t PREPROCESS_GRAY = -2;  ///< output channel computed from source B, G, R
+
+            /**
+             * How output channels come from source channels.
+             */
+            struct PreprocessMap {
+                int32_t channels = 0;       ///< output channels
+                int32_t index[4];           ///< source channel, or PREPROCESS_ZERO, PREPROCESS_GRAY
+                int32_t b = 0, g = 1, r = 2;    ///< source channels used by PREPROCESS_GRAY
+                float scale[4];
+                float bias[4];
+                bool chw = false;
+            };
+
+            static inline void _preprocess_store(float value, uint8_t *out) {
+                value = std::max(0.0f, std::min(value + 0.5f, 255.0f));
+                *out = uint8_t(value);
+            }
+
+            static inline void _preprocess_store(float value, float *out) {
+                *out = value;
+            }
+
+            /**
+             * Write one normalized pixel at column `x` of output row.
+             * For CHW output, `out` is the row in first channel plane and `plane` is elements of one plane.
+             */
+            template<typename O>
+            static inline void _preprocess_write(const PreprocessMap &map, const float *value,
+                                                 O *out, int32_t x, size_t plane) {
+                if (map.chw) {
+                    for (int32_t c = 0; c < map.channels; ++c) {
+                        _preprocess_store(value[c] * map.scale[c] + map.bias[c], out + c * plane + x);
+                    }
+                } else {
+                    auto pixel = out + size_t(x) * map.channels;
+                    for (int32_t c = 0; c < map.channels; ++c) {
+                        _preprocess_store(value[c] * map.scale[c] + map.bias[c], pixel + c);
+                    }
+                }
+            }
+
+            template<typename O>
+            static inline O *_preprocess_row(const SeetaAIPImageData &dst, const PreprocessMap &map,
+                                             int32_t n, int32_t y, size_t *plane) {
+                auto W = size_t(dst.width);
+                auto H = size_t(dst.height);
+                auto C = size_t(map.channels);
+                auto data = reinterpret_cast<O *>(dst.data);
+                *plane = W * H;
+                if (map.chw) return data + n * C * W * H + y * W;
+                return data + (n * H + y) * W * C;
+            }
+
+            /**
+             * Single pass bilinear resize, channel mapping and normalize of HWC source with element type T.
+             */
+            template<typename T, typename O>
+            static inline void preprocess_hwc(const Executor &threads, const ImageView &src,
+                                              const SeetaAIPImageData &dst, const PreprocessMap &map) {
+                auto C = int32_t(src.channels);
+                auto DST_W = int32_t(dst.width);
+                auto DST_H = int32_t(dst.height);
+                auto row_stride = ImageData::GetRowStride(src);
+                auto image_stride = ImageData::GetImageStride(src);
+                auto src_data = reinterpret_cast<const uint8_t *>(src.data);
+                // same cached bilinear tables as resize, 2 taps for each output pixel
+                auto tx = resize_table(RESIZE_LINEAR, int32_t(src.width), DST_W);
+                auto ty = resize_table(RESIZE_LINEAR, int32_t(src.height), DST_H);
+                auto rows = int32_t(dst.number) * DST_H;
+                parallel_for(threads, 0, rows, [&](int32_t i) {
+                    auto n = i / DST_H;
+                    auto y = i % DST_H;
+                    auto image = src_data + n * image_stride;
+                    auto r0 = reinterpret_cast<const T *>(image + ty->index[y * 2] * row_stride);
+                    auto r1 = reinterpret_cast<const T *>(image + ty->index[y * 2 + 1] * row_stride);
+                    auto wy = ty->weight[y * 2 + 1];
+                    size_t plane;
+                    auto out = _preprocess_row<O>(dst, map, n, y, &plane);
+                    float sampled[4];
+                    for (int32_t x = 0; x < DST_W; ++x) {
+                        auto x0 = tx->index[x * 2] * C;
+                        auto x1 = tx->index[x * 2 + 1] * C;
+                        auto p00 = r0 + x0;
+                        auto p01 = r0 + x1;
+                        auto p10 = r1 + x0;
+                        auto p11 = r1 + x1;
+                        auto wx = tx->weight[x * 2 + 1];
+                        auto sample = [&](int32_t k) -> float {
+                            auto top = float(p00[k]) + (float(p01[k]) - float(p00[k])) * wx;
+                            auto bottom = float(p10[k]) + (float(p11[k]) - float(p10[k])) * wx;
+                            return top + (bottom - top) * wy;
+                        };
+                        for (int32_t c = 0; c < map.channels; ++c) {
+                            auto k = map.index[c];
+                            if (k >= 0) {
+                                sampled[c] = sample(k);
+                            } else if (k == PREPROCESS_GRAY) {
+                                sampled[c] = (sample(map.r) * 19595.0f + sample(map.g) * 38469.0f
+                                              + sample(map.b) * 7472.0f) / 65536.0f;
+                            } else {
+                                sampled[c] = 0;
+                            }
+                        }
+                        _preprocess_write(map, sampled, out, x, plane);
+                    }
+                });
+            }
+
+            /**
+             * Single pass preprocess of packed YUV 4:2:0 source,
+             * source channels are B, G, R converted from sampled Y, U, V, and gray is sampled Y.
+             */
+            template<typename O>
+            static inline void preprocess_yuv420(const Executor &threads, const SeetaAIPImageData &src,
+                                                 const SeetaAIPImageData &dst, const PreprocessMap &map) {
+                check_yuv420_size(src);
+                auto src_format = SEETA_AIP_IMAGE_FORMAT(src.format);
+                auto W = int32_t(src.width);
+                auto H = int32_t(src.height);
+                auto DST_W = int32_t(dst.width);
+                auto DST_H = int32_t(dst.height);
+                auto src_data = reinterpret_cast<const uint8_t *>(src.data);
+                auto src_image_bytes = size_t(W) * H * 3 / 2;
+                auto scale_x = float(W) / float(DST_W);
+                auto scale_y = float(H) / float(DST_H);
+                auto rows = int32_t(dst.number) * DST_H;
+                parallel_for(threads, 0, rows, [&](int32_t i) {
+                    auto n = i / DST_H;
+                    auto y = i % DST_H;
+                    auto sy = (float(y) + 0.5f) * scale_y - 0.5f;
+                    auto cy = (sy + 0.5f) / 2 - 0.5f;
+                    auto planes = yuv420_planes(src_format, src_data + n * src_image_bytes, W, H);
+                    size_t plane;
+                    auto out = _preprocess_row<O>(dst, map, n, y, &plane);
+                    uint8_t bgr[3];
+                    float sampled[4];
+                    for (int32_t x = 0; x < DST_W; ++x) {
+                        auto sx = (float(x) + 0.5f) * scale_x - 0.5f;
+                        auto cx = (sx + 0.5f) / 2 - 0.5f;
+                        auto Y = _sample_plane(planes.y, 1, W, W, H, sx, sy);
+                        auto U = _sample_plane(planes.u, planes.uv_step, planes.uv_stride, W / 2, H / 2, cx, cy);
+                        auto V = _sample_plane(planes.v, planes.uv_step, planes.uv_stride, W / 2, H / 2, cx, cy);
+                        _yuv2bgr(int32_t(Y + 0.5f), int32_t(U + 0.5f), int32_t(V + 0.5f), bgr);
+                        for (int32_t c = 0; c < map.channels; ++c) {
+                            auto k = map.index[c];
+                            sampled[c] = k >= 0 ? float(bgr[k]) : (k == PREPROCESS_GRAY ? Y : 0.0f);
+                        }
+                        _preprocess_write(map, sampled, out, x, plane);
+                    }
+                });
+            }
+
+            /**
+             * Build channel mapping from `src_format` to output `color` order.
+             * @param src_format HWC source format, YUV 4:2:0 source act as BGR
+             * @param src_channels channels of source
+             * @param color output channel order
+             */
+            static inline PreprocessMap preprocess_map(SEETA_AIP_IMAGE_FORMAT src_format, int32_t src_channels,
+                                                       SEETA_AIP_IMAGE_FORMAT color) {
+                PreprocessMap map;
+                int32_t b = 0, g = 1, r = 2, step = 3;
+                auto src_gray = src_format == SEETA_AIP_FORMAT_U8Y;
+                auto src_color = ImageData::IsYUV420(src_format)
+                                 || bgr_layout(src_format, &b, &g, &r, &step);
+                auto src_alpha = src_color && step == 4 ? 3 : PREPROCESS_ZERO;
+                map.b = b;
+                map.g = g;
+                map.r = r;
+
+                int32_t out_b, out_g, out_r, out_step;
+                if (color == SEETA_AIP_FORMAT_U8RAW || color == SEETA_AIP_FORMAT_F32RAW
+                    || color == SEETA_AIP_FORMAT_I32RAW) {
+                    map.channels = src_format == SEETA_AIP_FORMAT_U8Y ? 1 : (src_color ? step : src_channels);
+                    if (map.channels > 4) {
+                        throw seeta::aip::Exception("Preprocess support at most 4 channels.");
+                    }
+                    for (int32_t c = 0; c < map.channels; ++c) map.index[c] = c;
+                } else if (color == SEETA_AIP_FORMAT_U8Y) {
+                    if (!src_gray && !src_color) {
+                        throw seeta::aip::Exception(
+                                std::string("Preprocess can not get gray image from ") + format_string(src_format) +
+                                " image, set PreprocessParam.color to U8RAW to keep source channels.");
+                    }
+                    map.channels = 1;
+                    map.index[0] = src_gray ? 0 : PREPROCESS_GRAY;
+                } else if (bgr_layout(color, &out_b, &out_g, &out_r, &out_step)) {
+                    if (!src_gray && !src_color) {
+                        throw seeta::aip::Exception(
+                                std::string("Preprocess can not get ") + format_string(color) + " image from " +
+                                format_string(src_format) +
+                                " image, set PreprocessParam.color to U8RAW to keep source channels.");
+                    }
+                    map.channels = out_step;
+                    map.index[out_b] = src_gray ? 0 : b;
+                    map.index[out_g] = src_gray ? 0 : g;
+                    map.index[out_r] = src_gray ? 0 : r;
+                    if (out_step == 4) map.index[3] = src_alpha;
+                } else {
+                    throw seeta::aip::Exception(
+                            std::string("Preprocess not support output color: ") + format_string(color));
+                }
+                return map;
+            }
+        }
+
+        /**
+         * @param batch batch of images
+         * @param index first image in batch
+         * @param number images in slot
+         * @return view of `number` images start at `index` in batch, can be used as output of preprocess to
+         *     fill batch in place.
+         */
+        static inline SeetaAIPImageData batch_slot(const SeetaAIPImageData &batch,
+                                                   uint32_t index, uint32_t number = 1) {
+            if (index + number > batch.number) {
+                throw seeta::aip::Exception("Batch slot out of range.");
+            }
+            auto slot = batch;
+            if (batch.number) {
+                auto image_bytes = ImageData::GetBytes(batch) / batch.number;
+                slot.data = reinterpret_cast<uint8_t *>(batch.data) + index * image_bytes;
+            }
+            slot.number = number;
+            return slot;
+        }
+
+        /**
+         * Use `threads` to convert, resize and normalize image in one pass, write result into `output`.
+         * Source can be any HWC format, strided views included, YUV 4:2:0 is sampled from its planes directly.
+         * CHW source is transposed to HWC first.
+         * @param threads executor running kernels, or number of threads
+         * @param image source image
+         * @param output caller provided memory, like one slot of NCHW batch from batch_slot.
+         *     Its format must be byte or float32 in HWC or CHW, and number must same as image.
+         *     width and height are the resized size.
+         *     If format has channel order like U8BGR or CHW_U8RGB, param.color is ignored.
+         * @param param channel order, mean and std
+         */
+        static inline void preprocess(const Executor &threads, ImageView image, const SeetaAIPImageData &output,
+                                      const PreprocessParam &param = PreprocessParam()) {
+            auto image_format = SEETA_AIP_IMAGE_FORMAT(image.format);
+            auto output_format = SEETA_AIP_IMAGE_FORMAT(output.format);
+            if (image.number != output.number) {
+                throw seeta::aip::Exception("Preprocess output number must be same as image.");
+            }
+            if (image.width == 0 || image.height == 0 || output.width == 0 || output.height == 0) {
+                throw seeta::aip::Exception("Preprocess got empty image.");
+            }
+
+            seeta::aip::ImageData transposed;
+            if ((image_format & 0xffff0000) == 0x80000) {
+                image_format = SEETA_AIP_IMAGE_FORMAT(image_format & 0xffff);
+                transposed = convert(threads, image_format, image);
+                image = transposed;
+            }
+            seeta::aip::ImageData compacted;
+            if (ImageData::IsYUV420(image_format) && !ImageData::IsPacked(image)) {
+                compacted = ImageData::Borrow(image).compact();
+                image = compacted;
+            }
+
+            auto chw = (output_format & 0xffff0000) == 0x80000;
+            auto color = SEETA_AIP_IMAGE_FORMAT(output_format & 0xffff);
+            int32_t b, g, r, step;
+            if (color != SEETA_AIP_FORMAT_U8Y && !_::bgr_layout(color, &b, &g, &r, &step)) {
+                color = param.color;
+            }
+
+            auto map = _::preprocess_map(image_format, int32_t(image.channels), color);
+            map.chw = chw;
+            if (ImageData::GetChannels(output_format, output.channels) != uint32_t(map.channels)) {
+                throw seeta::aip::Exception(
+                        "Preprocess output must have " + std::to_string(map.channels) + " channels.");
+            }
+            for (int32_t c = 0; c < map.channels; ++c) {
+                map.scale[c] = 1.0f / param.std[c];
+                map.bias[c] = -param.mean[c] / param.std[c];
+            }
+
+            auto output_type = ImageData::GetType(output_format);
+            if (ImageData::IsYUV420(image_format)) {
+                SeetaAIPImageData src = {image.format, image.data, image.number, image.height, image.width, 1};
+                switch (output_type) {
+                    default:
+                        break;
+                    case SEETA_AIP_VALUE_BYTE:
+                        _::preprocess_yuv420<uint8_t>(threads, src, output, map);
+                        return;
+                    case SEETA_AIP_VALUE_FLOAT32:
+                        _::preprocess_yuv420<float>(threads, src, output, map);
+                        return;
+                }
+            } else {
+                auto image_type = ImageData::GetType(image_format);
+#define __SEETA_AIP_PREPROCESS_CASE(T) \
+                switch (output_type) { \
+                    default: break; \
+                    case SEETA_AIP_VALUE_BYTE: \
+                        _::preprocess_hwc<T, uint8_t>(threads, image, output, map); \
+                        return; \
+                    case SEETA_AIP_VALUE_FLOAT32: \
+                        _::preprocess_hwc<T, float>(threads, image, output, map); \
+                        return; \
+                }
+                switch (image_type) {
+                    default:
+                        throw seeta::aip::Exception(
+                                std::string("Preprocess not support image type: ") + type_string(image_type));
+                    case SEETA_AIP_VALUE_BYTE:
+                        __SEETA_AIP_PREPROCESS_CASE(uint8_t)
+                        break;
+                    case SEETA_AIP_VALUE_FLOAT32:
+                        __SEETA_AIP_PREPROCESS_CASE(float)
+                        break;
+                    case SEETA_AIP_VALUE_INT32:
+                        __SEETA_AIP_PREPROCESS_CASE(int32_t)
+                        break;
+                }
+#undef __SEETA_AIP_PREPROCESS_CASE
+            }
+            throw seeta::aip::Exception("Preprocess output must be byte or float32 image.");
+        }
+
+        /**
+         * Use `threads` to convert, resize and normalize image in one pass.
+         * @param threads executor running kernels, or number of threads
+         * @param format output format, byte or float32 in HWC or CHW, like CHW_F32RAW
+         * @param image source image
+         * @param width resized image width
+         * @param height resized image height
+         * @param param channel order, mean and std
+         * @return preprocessed image `width x height`
+         */
+        static inline seeta::aip::ImageData preprocess(const Executor &threads,
+                                                       SEETA_AIP_IMAGE_FORMAT format,
+                                                       ImageView image,
+                                                       int width, int height,
+                                                       const PreprocessParam &param = PreprocessParam()) {
+            auto color = SEETA_AIP_IMAGE_FORMAT(format & 0xffff);
+            int32_t b, g, r, step;
+            if (color != SEETA_AIP_FORMAT_U8Y && !_::bgr_layout(color, &b, &g, &r, &step)) {
+                color = param.color;
+            }
+            auto image_format = SEETA_AIP_IMAGE_FORMAT(image.format & 0xffff);
+            auto map = _::preprocess_map(image_format, int32_t(image.channels), color);
+            seeta::aip::ImageData output(format, image.number, uint32_t(width), uint32_t(height),
+                                         uint32_t(map.channels));
+            preprocess(threads, image, output, param);
+            return output;
         }
     }
 }
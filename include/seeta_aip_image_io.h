@@ -7,6 +7,9 @@
 
 #include "seeta_aip_struct.h"
 #include "seeta_aip_image.h"
+#include "seeta_aip_resize.h"
+#include "seeta_aip_executor.h"
+#include "seeta_aip_mapped_file.h"
 
 #define STB_IMAGE_STATIC
 #define STB_IMAGE_IMPLEMENTATION
@@ -18,26 +21,243 @@
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <functional>
+#include <vector>
 
 namespace seeta {
     namespace aip {
-        static seeta::aip::ImageData imread(const std::string &filename) {
+        namespace _ {
+            /**
+             * @param format wanted decoded format
+             * @return channels of wanted format
+             */
+            static inline int decode_channels(SEETA_AIP_IMAGE_FORMAT format) {
+                switch (format) {
+                    default:
+                        throw Exception(std::string("Decode only support U8Y, U8RGB, U8BGR, U8RGBA and U8BGRA, got ")
+                                        + format_string(format));
+                    case SEETA_AIP_FORMAT_U8Y: return 1;
+                    case SEETA_AIP_FORMAT_U8RGB:
+                    case SEETA_AIP_FORMAT_U8BGR: return 3;
+                    case SEETA_AIP_FORMAT_U8RGBA:
+                    case SEETA_AIP_FORMAT_U8BGRA: return 4;
+                }
+            }
+
+            /**
+             * @param format wanted decoded format
+             * @return channels asked from stb, Y is converted from RGB so it is same as convert
+             */
+            static inline int request_channels(SEETA_AIP_IMAGE_FORMAT format) {
+                auto channels = decode_channels(format);
+                return channels == 1 ? 3 : channels;
+            }
+
+            /**
+             * @param channels channels decoded by stb
+             * @return format of stb decoded buffer
+             */
+            static inline SEETA_AIP_IMAGE_FORMAT decoded_format(int channels) {
+                return channels == 1 ? SEETA_AIP_FORMAT_U8Y
+                                     : channels == 4 ? SEETA_AIP_FORMAT_U8RGBA : SEETA_AIP_FORMAT_U8RGB;
+            }
+
+            /**
+             * Take stb decoded buffer as image of wanted format, BGR orders are swapped in place.
+             * @param data stb decoded buffer of request_channels(format), freed with returned image,
+             *     nullptr for failed decoding
+             * @return empty image if data is nullptr
+             */
+            static inline ImageData adopt_decoded(unsigned char *data, int width, int height,
+                                                  SEETA_AIP_IMAGE_FORMAT format) {
+                if (!data) return ImageData();
+                auto channels = request_channels(format);
+                auto decoded = decoded_format(channels);
+                auto in_place = channels == decode_channels(format);
+                SeetaAIPImageData image = {int32_t(in_place ? format : decoded), data, 1,
+                                           uint32_t(height), uint32_t(width), uint32_t(channels)};
+                auto result = ImageData::Adopt(image, [](void *data) { stbi_image_free(data); });
+                if (!in_place) {
+                    // gray has less channels, converted into new image
+                    return convert(1, format, result);
+                }
+                if (format != decoded) {
+                    // pixel by pixel swap, safe to convert in place
+                    auto source = image;
+                    source.format = decoded;
+                    convert(1, source, image);
+                }
+                return result;
+            }
+        }
+
+        /**
+         * Read image file, decoded buffer is owned by returned image without copy.
+         * @param filename
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA. Y is converted from decoded RGB.
+         * @return empty image if failed
+         */
+        static seeta::aip::ImageData imread(const std::string &filename,
+                                            SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RGB) {
             int iw, ih, n;
             iw = ih = n = 0;
-            unsigned char *data = stbi_load(filename.c_str(), &iw, &ih, &n, 3);
-            if (!data) return seeta::aip::ImageData();
-            seeta::aip::ImageData result(SEETA_AIP_FORMAT_U8RGB, iw, ih, n, data);
-            stbi_image_free(data);
-            return result;
+            unsigned char *data = stbi_load(filename.c_str(), &iw, &ih, &n, _::request_channels(format));
+            return _::adopt_decoded(data, iw, ih, format);
         }
 
-        static bool imwrite(const std::string &filename, const SeetaAIPImageData &image) {
-            auto image_t = image;
-            seeta::aip::ImageData tmp;
-            if (image_t.format != SEETA_AIP_FORMAT_U8RGB && image_t.format != SEETA_AIP_FORMAT_U8RGBA) {
-                tmp = convert(1, SEETA_AIP_FORMAT_U8RGB, image_t);
-                image_t = tmp;
+        /**
+         * Encoder of one image type with its settings, output buffer is kept and reused by following images.
+         * JPEG and PNG read U8Y, U8RGB, U8BGR, U8RGBA and U8BGRA images in place, rows could be strided,
+         * other formats or types are converted into a reused image first.
+         */
+        class ImageEncoder {
+        public:
+            using self = ImageEncoder;
+
+            /**
+             * @param code image type, or filename with extension, jpg, jpeg, png, bmp or tga
+             */
+            explicit ImageEncoder(const std::string &code) {
+                auto dot_pos = code.rfind('.');
+                m_type = dot_pos == std::string::npos ? code : code.substr(dot_pos + 1);
+                for (auto &ch: m_type) ch = char(std::tolower(ch));
+                if (m_type == "jpeg") m_type = "jpg";
+                if (m_type != "jpg" && m_type != "png" && m_type != "bmp" && m_type != "tga") {
+                    throw Exception("Encoder only support jpg, png, bmp and tga, got \'" + code + "\'");
+                }
+            }
+
+            /**
+             * @return image type, jpg, png, bmp or tga
+             */
+            const std::string &type() const { return m_type; }
+
+            /**
+             * @param quality JPEG quality in [1, 100], default 90
+             */
+            self &quality(int quality) {
+                m_quality = std::max(1, std::min(quality, 100));
+                return *this;
             }
+
+            int quality() const { return m_quality; }
+
+            /**
+             * @param level PNG zlib compression level in [0, 9], higher for smaller and slower, default 8
+             */
+            self &compression(int level) {
+                m_compression = std::max(0, std::min(level, 9));
+                return *this;
+            }
+
+            int compression() const { return m_compression; }
+
+            /**
+             * Encode first image of batch.
+             * @param image image to encode, could be strided view
+             * @return encoded image, valid until next encoding, empty if failed
+             */
+            const std::vector<unsigned char> &encode(const ImageView &image) {
+                m_buffer.clear();
+                if (image.width == 0 || image.height == 0 || image.number == 0) return m_buffer;
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                auto width = int(image.width);
+                auto height = int(image.height);
+                auto comp = 0;
+                auto bgr = 0;
+                switch (format) {
+                    default: break;
+                    case SEETA_AIP_FORMAT_U8Y: comp = 1; break;
+                    case SEETA_AIP_FORMAT_U8RGB: comp = 3; break;
+                    case SEETA_AIP_FORMAT_U8BGR: comp = 3; bgr = 1; break;
+                    case SEETA_AIP_FORMAT_U8RGBA: comp = 4; break;
+                    case SEETA_AIP_FORMAT_U8BGRA: comp = 4; bgr = 1; break;
+                }
+                auto data = reinterpret_cast<const unsigned char *>(image.data);
+                auto stride = int(ImageData::GetRowStride(image));
+                bool in_place = comp != 0 && (m_type == "jpg" || m_type == "png"
+                                              || (!bgr && stride == width * comp));
+                if (!in_place) {
+                    auto wanted = comp == 4 ? SEETA_AIP_FORMAT_U8RGBA : SEETA_AIP_FORMAT_U8RGB;
+                    auto channels = comp == 4 ? 4u : 3u;
+                    if (m_converted.format() != wanted || m_converted.width() != image.width
+                        || m_converted.height() != image.height) {
+                        m_converted = ImageData(wanted, 1, image.width, image.height, channels);
+                    }
+                    auto first = image;
+                    first.number = 1;
+                    convert(1, first, m_converted);
+                    data = m_converted.data<unsigned char>();
+                    comp = int(channels);
+                    bgr = 0;
+                    stride = width * comp;
+                }
+                int ok = 0;
+                if (m_type == "jpg") {
+                    stbi__write_context context;
+                    stbi__start_write_callbacks(&context, Append, &m_buffer);
+                    ok = stbiw__jpg_core_ex(&context, width, height, comp, data, m_quality, stride, bgr);
+                } else if (m_type == "png") {
+                    int len = 0;
+                    auto png = stbiw__png_to_mem_ex(data, stride, width, height, comp, &len, m_compression, bgr);
+                    if (png) {
+                        m_buffer.assign(png, png + len);
+                        STBIW_FREE(png);
+                        ok = 1;
+                    }
+                } else if (m_type == "bmp") {
+                    ok = stbi_write_bmp_to_func(Append, &m_buffer, width, height, comp, data);
+                } else if (m_type == "tga") {
+                    ok = stbi_write_tga_to_func(Append, &m_buffer, width, height, comp, data);
+                }
+                if (!ok) m_buffer.clear();
+                return m_buffer;
+            }
+
+            /**
+             * Encode first image of batch and write file at once.
+             * @param filename output file
+             * @param image image to encode, could be strided view
+             * @return false if failed to encode or write
+             */
+            bool write(const std::string &filename, const ImageView &image) {
+                auto &buffer = encode(image);
+                if (buffer.empty()) return false;
+                std::unique_ptr<FILE, int (*)(FILE *)> file(stbiw__fopen(filename.c_str(), "wb"), fclose);
+                if (!file) return false;
+                return std::fwrite(buffer.data(), 1, buffer.size(), file.get()) == buffer.size();
+            }
+
+            /**
+             * @return last encoded image
+             */
+            const std::vector<unsigned char> &buffer() const { return m_buffer; }
+
+            /**
+             * Take last encoded image out, next encoding allocates new buffer.
+             */
+            std::vector<unsigned char> release() {
+                std::vector<unsigned char> buffer;
+                buffer.swap(m_buffer);
+                return buffer;
+            }
+
+        private:
+            static void Append(void *context, void *data, int size) {
+                auto buffer = static_cast<std::vector<unsigned char> *>(context);
+                auto bytes = static_cast<const unsigned char *>(data);
+                buffer->insert(buffer->end(), bytes, bytes + size);
+            }
+
+            std::string m_type;
+            int m_quality = 90;
+            int m_compression = 8;
+            std::vector<unsigned char> m_buffer;
+            ImageData m_converted;
+        };
+
+        static bool imwrite(const std::string &filename, const SeetaAIPImageData &image) {
             auto dot_pos = filename.rfind('.');
             std::string ext = dot_pos == std::string::npos ? "" : filename.substr(dot_pos + 1);
             for (auto &ch: ext) ch = std::tolower(ch);
@@ -47,22 +267,15 @@ namespace seeta {
                 return false;
             }
 
-            if (ext == "jpeg" || ext == "jpg") {
-                return stbi_write_jpg(filename.c_str(),
-                                      image_t.width, image_t.height, image_t.channels, image_t.data,
-                                      90);
-            } else if (ext == "png") {
-                return stbi_write_png(filename.c_str(),
-                                      image_t.width, image_t.height, image_t.channels, image_t.data,
-                                      0);
-            } else if (ext == "bmp") {
-                return stbi_write_bmp(filename.c_str(),
-                                      image_t.width, image_t.height, image_t.channels,
-                                      image_t.data);;
-            } else if (ext == "tga") {
-                return stbi_write_tga(filename.c_str(),
-                                      image_t.width, image_t.height, image_t.channels, image_t.data);
+            if (ext == "jpeg" || ext == "jpg" || ext == "png" || ext == "bmp" || ext == "tga") {
+                return ImageEncoder(ext).write(filename, image);
             } else if (ext == "hdr") {
+                auto image_t = image;
+                seeta::aip::ImageData tmp;
+                if (image_t.format != SEETA_AIP_FORMAT_U8RGB && image_t.format != SEETA_AIP_FORMAT_U8RGBA) {
+                    tmp = convert(1, SEETA_AIP_FORMAT_U8RGB, image_t);
+                    image_t = tmp;
+                }
                 return stbi_write_hdr(filename.c_str(),
                                       image_t.width, image_t.height, image_t.channels,
                                       (float *) image_t.data);;
@@ -72,33 +285,330 @@ namespace seeta {
             return false;
         }
 
-        static seeta::aip::ImageData decode(const void *data, int len) {
+        /**
+         * Decode image, decoded buffer is owned by returned image without copy.
+         * @param data encoded image
+         * @param len bytes of encoded image
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA. Y is converted from decoded RGB.
+         * @return empty image if failed
+         */
+        static seeta::aip::ImageData decode(const void *data, int len,
+                                            SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RGB) {
             int iw, ih, n;
             iw = ih = n = 0;
-            unsigned char *image_data = stbi_load_from_memory((const stbi_uc *) data, len, &iw, &ih, &n, 3);
-            if (!image_data) return seeta::aip::ImageData();
-            seeta::aip::ImageData result(SEETA_AIP_FORMAT_U8RGB, iw, ih, n, image_data);
-            stbi_image_free(image_data);
-            return result;
+            unsigned char *image_data = stbi_load_from_memory((const stbi_uc *) data, len, &iw, &ih, &n,
+                                                              _::request_channels(format));
+            return _::adopt_decoded(image_data, iw, ih, format);
+        }
+
+        /**
+         * Decode image into caller provided image, channels are ordered while copying out of decoder.
+         * @param data encoded image
+         * @param len bytes of encoded image
+         * @param output image of wanted format, could be strided view,
+         *               format must be U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA, size must be same as encoded image
+         * @return false if failed to decode, output may be untouched
+         * @throw Exception if size in header is not same as output, checked before decoding pixels
+         */
+        static bool decode(const void *data, int len, const ImageView &output) {
+            auto format = SEETA_AIP_IMAGE_FORMAT(output.format);
+            auto channels = _::request_channels(format);
+            int iw, ih, n;
+            iw = ih = n = 0;
+            if (!stbi_info_from_memory((const stbi_uc *) data, len, &iw, &ih, &n)) return false;
+            if (output.number != 1 || int(output.width) != iw || int(output.height) != ih) {
+                throw Exception("Decode got " + std::to_string(iw) + "x" + std::to_string(ih) + " image, but output is "
+                                + std::to_string(output.number) + "x" + std::to_string(output.width) + "x"
+                                + std::to_string(output.height));
+            }
+            unsigned char *image_data = stbi_load_from_memory((const stbi_uc *) data, len, &iw, &ih, &n, channels);
+            if (!image_data) return false;
+            std::shared_ptr<unsigned char> holder(image_data, stbi_image_free);
+            SeetaAIPImageData decoded = {int32_t(_::decoded_format(channels)), image_data, 1,
+                                         uint32_t(ih), uint32_t(iw), uint32_t(channels)};
+            convert(1, decoded, output);
+            return true;
+        }
+
+        /**
+         * Image header, read without decoding pixels.
+         */
+        struct ImageInfo {
+            int32_t width = 0;
+            int32_t height = 0;
+            int32_t channels = 0;   ///< channels in file, 1 gray, 2 gray and alpha, 3 RGB, 4 RGBA
+            SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RAW;   ///< decoded format keeping all colors
+
+            bool empty() const { return width == 0 || height == 0; }
+        };
+
+        namespace _ {
+            static inline ImageInfo image_info(int ok, int width, int height, int channels) {
+                ImageInfo info;
+                if (!ok) return info;
+                info.width = width;
+                info.height = height;
+                info.channels = channels;
+                info.format = channels == 1 ? SEETA_AIP_FORMAT_U8Y
+                                            : channels == 3 ? SEETA_AIP_FORMAT_U8RGB : SEETA_AIP_FORMAT_U8RGBA;
+                return info;
+            }
+        }
+
+        /**
+         * Read image size and channels from header, pixels are not decoded.
+         * @param data encoded image
+         * @param len bytes of encoded image
+         * @return empty info if not of any known type
+         */
+        static inline ImageInfo probe(const void *data, int len) {
+            int iw = 0, ih = 0, n = 0;
+            auto ok = stbi_info_from_memory(reinterpret_cast<const stbi_uc *>(data), len, &iw, &ih, &n);
+            return _::image_info(ok, iw, ih, n);
+        }
+
+        /**
+         * Read image size and channels from file header, only the header is read.
+         * @param filename
+         * @return empty info if failed to open or not of any known type
+         */
+        static inline ImageInfo probe(const std::string &filename) {
+            int iw = 0, ih = 0, n = 0;
+            auto ok = stbi_info(filename.c_str(), &iw, &ih, &n);
+            return _::image_info(ok, iw, ih, n);
+        }
+
+        /**
+         * Read image file by memory mapping, decoder reads the mapping directly instead of stdio buffered reads.
+         * @param filename
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA. Y is converted from decoded RGB.
+         * @return empty image if failed
+         */
+        static inline seeta::aip::ImageData imread_mapped(const std::string &filename,
+                                                          SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RGB) {
+            MappedFile file(filename);
+            if (file.empty() || file.size() > size_t(INT32_MAX)) return seeta::aip::ImageData();
+            return decode(file.data(), int(file.size()), format);
+        }
+
+        namespace _ {
+            /**
+             * @return largest JPEG DCT scaling shift in [0, 3], with long side still not less than `max_side`
+             */
+            static inline int jpeg_scale(int width, int height, int max_side) {
+                auto side = std::max(width, height);
+                int scale = 0;
+                while (scale < 3 && max_side > 0 && ((side + (2 << scale) - 1) >> (scale + 1)) >= max_side) ++scale;
+                return scale;
+            }
+
+            /**
+             * Decode JPEG in reduced size by DCT scaling, or other images in full size.
+             * @param denominator [out] 1, 2, 4 or 8, decoded size is ceil(original size / denominator)
+             */
+            static inline unsigned char *load_reduced(const void *data, int len, int max_side,
+                                                      int *x, int *y, int *comp, int req_comp, int *denominator) {
+                *denominator = 1;
+                stbi__context s;
+                stbi__start_mem(&s, reinterpret_cast<const stbi_uc *>(data), len);
+                if (!stbi__jpeg_test(&s)) {
+                    return stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(data), len, x, y, comp, req_comp);
+                }
+                int width = 0, height = 0;
+                stbi_info_from_memory(reinterpret_cast<const stbi_uc *>(data), len, &width, &height, comp);
+                std::unique_ptr<stbi__jpeg, void (*)(void *)> jpeg(
+                        reinterpret_cast<stbi__jpeg *>(stbi__malloc(sizeof(stbi__jpeg))), [](void *p) { STBI_FREE(p); });
+                if (!jpeg) return nullptr;
+                jpeg->s = &s;
+                stbi__setup_jpeg(jpeg.get());
+                jpeg->scale = jpeg_scale(width, height, max_side);
+                auto result = load_jpeg_image(jpeg.get(), x, y, comp, req_comp);
+                if (result) *denominator = 1 << jpeg->scale;
+                return result;
+            }
+        }
+
+        /**
+         * Decode image in reduced size for images much larger than wanted.
+         * JPEG is scaled to 1/2, 1/4 or 1/8 in DCT domain, skipping full size IDCT and full size pixel buffers.
+         * The largest reduction with long side not less than `max_side` is used, so resize result to exact size.
+         * Other image types are decoded in full size.
+         * @param data encoded image
+         * @param len bytes of encoded image
+         * @param max_side wanted maximum of width and height, 0 for full size
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA. Y is converted from decoded RGB.
+         * @param denominator [out] 1, 2, 4 or 8, decoded size is ceil(original size / denominator)
+         * @return empty image if failed
+         */
+        static seeta::aip::ImageData decode_reduced(const void *data, int len, int max_side,
+                                                    SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RGB,
+                                                    int *denominator = nullptr) {
+            int iw, ih, n, scale;
+            iw = ih = n = 0;
+            unsigned char *image_data = _::load_reduced(data, len, max_side, &iw, &ih, &n,
+                                                        _::request_channels(format), &scale);
+            if (denominator) *denominator = scale;
+            return _::adopt_decoded(image_data, iw, ih, format);
+        }
+
+        /**
+         * Read image file in reduced size, see decode_reduced.
+         * @param filename
+         * @param max_side wanted maximum of width and height, 0 for full size
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA. Y is converted from decoded RGB.
+         * @param denominator [out] 1, 2, 4 or 8, decoded size is ceil(original size / denominator)
+         * @return empty image if failed
+         */
+        static seeta::aip::ImageData imread_reduced(const std::string &filename, int max_side,
+                                                    SEETA_AIP_IMAGE_FORMAT format = SEETA_AIP_FORMAT_U8RGB,
+                                                    int *denominator = nullptr) {
+            MappedFile file(filename);
+            if (file.empty() || file.size() > size_t(INT32_MAX)) return seeta::aip::ImageData();
+            return decode_reduced(file.data(), int(file.size()), max_side, format, denominator);
+        }
+
+        /**
+         * How one image of batch is decoded and placed, `resized = original * scale + offset`.
+         */
+        struct DecodeInfo {
+            bool decoded = false;   ///< false if image failed to read or decode, its slot is filled with pad
+            uint32_t width = 0;     ///< original width
+            uint32_t height = 0;    ///< original height
+            float scale_x = 1;
+            float scale_y = 1;
+            float offset_x = 0;     ///< left padding of letterbox
+            float offset_y = 0;     ///< top padding of letterbox
+
+            /**
+             * @param p point on batch image
+             * @return point on original image
+             */
+            SeetaAIPPoint to_original(const SeetaAIPPoint &p) const {
+                return {(p.x - offset_x) / scale_x, (p.y - offset_y) / scale_y};
+            }
+        };
+
+        namespace _ {
+            /**
+             * Decode images concurrently, each is resized and placed into its slot of batch.
+             * @param load decode i-th image in wanted format, empty image for failed
+             */
+            static inline ImageData decode_batch(const Executor &threads, int32_t number,
+                                                 const std::function<ImageData(int32_t)> &load,
+                                                 SEETA_AIP_IMAGE_FORMAT format, int width, int height,
+                                                 bool letterbox, uint8_t pad,
+                                                 std::vector<DecodeInfo> *infos) {
+                auto channels = uint32_t(decode_channels(format));
+                if (width <= 0 || height <= 0) {
+                    throw Exception("Decode batch got non-positive size.");
+                }
+                ImageData batch(format, uint32_t(number), uint32_t(width), uint32_t(height), channels);
+                std::vector<DecodeInfo> local(number);
+                auto row_bytes = size_t(width) * channels;
+                auto slot_bytes = row_bytes * height;
+                // images are decoded in parallel, each one is resized in its own thread
+                parallel_for(threads, 0, number, [&](int32_t i) {
+                    auto slot = batch.data<uint8_t>() + size_t(i) * slot_bytes;
+                    auto &info = local[i];
+                    auto image = load(i);
+                    if (image.width() == 0 || image.height() == 0) {
+                        std::memset(slot, pad, slot_bytes);
+                        return;
+                    }
+                    info.decoded = true;
+                    info.width = image.width();
+                    info.height = image.height();
+                    auto resized_width = width;
+                    auto resized_height = height;
+                    if (letterbox) {
+                        auto scale = std::min(float(width) / float(info.width), float(height) / float(info.height));
+                        resized_width = std::max(1, std::min(width, int(lroundf(float(info.width) * scale))));
+                        resized_height = std::max(1, std::min(height, int(lroundf(float(info.height) * scale))));
+                    }
+                    info.scale_x = float(resized_width) / float(info.width);
+                    info.scale_y = float(resized_height) / float(info.height);
+                    auto left = (width - resized_width) / 2;
+                    auto top = (height - resized_height) / 2;
+                    info.offset_x = float(left);
+                    info.offset_y = float(top);
+                    if (resized_width != int(info.width) || resized_height != int(info.height)) {
+                        image = resize2d(1, image, resized_width, resized_height);
+                    }
+                    if (resized_width == width && resized_height == height) {
+                        std::memcpy(slot, image.data(), slot_bytes);
+                        return;
+                    }
+                    auto resized_row = size_t(resized_width) * channels;
+                    for (int y = 0; y < height; ++y) {
+                        auto row = slot + size_t(y) * row_bytes;
+                        if (y < top || y >= top + resized_height) {
+                            std::memset(row, pad, row_bytes);
+                            continue;
+                        }
+                        std::memset(row, pad, size_t(left) * channels);
+                        std::memcpy(row + size_t(left) * channels,
+                                    image.data<uint8_t>() + size_t(y - top) * resized_row, resized_row);
+                        std::memset(row + size_t(left) * channels + resized_row, pad,
+                                    row_bytes - size_t(left) * channels - resized_row);
+                    }
+                });
+                if (infos) *infos = std::move(local);
+                return batch;
+            }
+        }
+
+        /**
+         * Read image files concurrently into one NHWC batch.
+         * @param threads executor decoding images, or number of threads
+         * @param filenames image files
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA
+         * @param width width of each image in batch
+         * @param height height of each image in batch
+         * @param infos [out] original size and placement of each image, for mapping coordinates back
+         * @param letterbox keep aspect ratio and pad to center, or stretch to batch size
+         * @param pad value of padding bytes, and of images failed to read
+         * @return batch of `filenames.size()` images
+         */
+        static inline ImageData imread_batch(const Executor &threads, const std::vector<std::string> &filenames,
+                                             SEETA_AIP_IMAGE_FORMAT format, int width, int height,
+                                             std::vector<DecodeInfo> *infos = nullptr,
+                                             bool letterbox = false, uint8_t pad = 0) {
+            return _::decode_batch(threads, int32_t(filenames.size()), [&](int32_t i) {
+                return imread(filenames[i], format);
+            }, format, width, height, letterbox, pad, infos);
+        }
+
+        /**
+         * Decode encoded images concurrently into one NHWC batch.
+         * @param threads executor decoding images, or number of threads
+         * @param buffers encoded images, like result of encode
+         * @param format U8Y, U8RGB, U8BGR, U8RGBA or U8BGRA
+         * @param width width of each image in batch
+         * @param height height of each image in batch
+         * @param infos [out] original size and placement of each image, for mapping coordinates back
+         * @param letterbox keep aspect ratio and pad to center, or stretch to batch size
+         * @param pad value of padding bytes, and of images failed to decode
+         * @return batch of `buffers.size()` images
+         */
+        static inline ImageData decode_batch(const Executor &threads,
+                                             const std::vector<std::vector<unsigned char>> &buffers,
+                                             SEETA_AIP_IMAGE_FORMAT format, int width, int height,
+                                             std::vector<DecodeInfo> *infos = nullptr,
+                                             bool letterbox = false, uint8_t pad = 0) {
+            return _::decode_batch(threads, int32_t(buffers.size()), [&](int32_t i) {
+                return decode(buffers[i].data(), int(buffers[i].size()), format);
+            }, format, width, height, letterbox, pad, infos);
         }
 
         namespace _ {
             static void encode_buffer(void *context, void *data, int size) {
                 auto buffer = (std::vector<unsigned char> *) context;
-                auto now_size = buffer->size();
-                auto new_size = buffer->size() + size;
-                buffer->resize(new_size);
-                std::memcpy(buffer->data() + now_size, data, size);
+                auto bytes = (const unsigned char *) data;
+                buffer->insert(buffer->end(), bytes, bytes + size);
             }
         }
 
         static std::vector<unsigned char> encode(const std::string &code, const SeetaAIPImageData &image) {
-            auto image_t = image;
-            seeta::aip::ImageData tmp;
-            if (image_t.format != SEETA_AIP_FORMAT_U8RGB && image_t.format != SEETA_AIP_FORMAT_U8RGBA) {
-                tmp = convert(1, SEETA_AIP_FORMAT_U8RGB, image_t);
-                image_t = tmp;
-            }
             auto dot_pos = code.rfind('.');
             std::string ext = dot_pos == std::string::npos ? code : code.substr(dot_pos + 1);
             for (auto &ch: ext) ch = std::tolower(ch);
@@ -108,28 +618,17 @@ namespace seeta {
                 return {};
             }
 
-            std::vector<unsigned char> buffer;
-            buffer.reserve(image_t.number * image_t.height * image_t.width * image_t.channels / 2);
-
-            if (ext == "jpeg" || ext == "jpg") {
-                if (stbi_write_jpg_to_func(_::encode_buffer, &buffer,
-                                           image_t.width, image_t.height, image_t.channels, image_t.data,
-                                           90))
-                    return buffer;
-            } else if (ext == "png") {
-                if (stbi_write_png_to_func(_::encode_buffer, &buffer,
-                                           image_t.width, image_t.height, image_t.channels, image_t.data,
-                                           0))
-                    return buffer;
-            } else if (ext == "bmp") {
-                if (stbi_write_bmp_to_func(_::encode_buffer, &buffer,
-                                           image_t.width, image_t.height, image_t.channels, image_t.data))
-                    return buffer;
-            } else if (ext == "tga") {
-                if (stbi_write_tga_to_func(_::encode_buffer, &buffer,
-                                           image_t.width, image_t.height, image_t.channels, image_t.data))
-                    return buffer;
+            if (ext == "jpeg" || ext == "jpg" || ext == "png" || ext == "bmp" || ext == "tga") {
+                ImageEncoder encoder(ext);
+                if (!encoder.encode(image).empty()) return encoder.release();
             } else if (ext == "hdr") {
+                auto image_t = image;
+                seeta::aip::ImageData tmp;
+                if (image_t.format != SEETA_AIP_FORMAT_U8RGB && image_t.format != SEETA_AIP_FORMAT_U8RGBA) {
+                    tmp = convert(1, SEETA_AIP_FORMAT_U8RGB, image_t);
+                    image_t = tmp;
+                }
+                std::vector<unsigned char> buffer;
                 if (stbi_write_hdr_to_func(_::encode_buffer, &buffer,
                                            image_t.width, image_t.height, image_t.channels, (float *) image_t.data))
                     return buffer;
@@ -0,0 +1,211 @@
+#ifndef SEETA_AIP_SEETA_AIP_MAPPED_FILE_H
+#define SEETA_AIP_SEETA_AIP_MAPPED_FILE_H
+
+#include "seeta_aip_platform.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#if SEETA_AIP_OS_WINDOWS
+
+#include <Windows.h>
+
+#undef min
+#undef max
+
+#else
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif
+
+namespace seeta {
+    namespace aip {
+        /**
+         * Read only memory mapping of whole file, pages are read by the OS when touched.
+         * Open failures are not thrown, the mapping is empty instead, same as imread returns empty image.
+         */
+        class MappedFile {
+        public:
+            using self = MappedFile;
+
+            MappedFile() = default;
+
+            /**
+             * @param filename file to be mapped, empty mapping if failed or file is empty
+             */
+            explicit MappedFile(const std::string &filename)
+                    : m_filename(filename) {
+                open();
+            }
+
+            ~MappedFile() { close(); }
+
+            MappedFile(const self &) = delete;
+
+            self &operator=(const self &) = delete;
+
+            const std::string &filename() const { return m_filename; }
+
+            const uint8_t *data() const { return m_data; }
+
+            size_t size() const { return m_size; }
+
+            bool empty() const { return m_data == nullptr; }
+
+            /**
+             * Ask the OS to read all pages now, then touch each page,
+             * so decoding later never waits on page faults.
+             */
+            void prefetch() const {
+                if (!m_data) return;
+#if !SEETA_AIP_OS_WINDOWS
+                ::madvise(const_cast<uint8_t *>(m_data), m_size, MADV_WILLNEED);
+#endif
+                volatile uint8_t sum = 0;
+                for (size_t i = 0; i < m_size; i += 4096) sum += m_data[i];
+                (void) sum;
+            }
+
+        private:
+#if SEETA_AIP_OS_WINDOWS
+            void open() {
+                m_file = ::CreateFileA(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                       OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE) return;
+                LARGE_INTEGER size;
+                if (!::GetFileSizeEx(m_file, &size) || size.QuadPart == 0) return;
+                m_mapping = ::CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!m_mapping) return;
+                auto view = ::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+                if (!view) return;
+                m_data = static_cast<const uint8_t *>(view);
+                m_size = size_t(size.QuadPart);
+            }
+
+            void close() {
+                if (m_data) ::UnmapViewOfFile(m_data);
+                if (m_mapping) ::CloseHandle(m_mapping);
+                if (m_file != INVALID_HANDLE_VALUE) ::CloseHandle(m_file);
+                m_data = nullptr;
+                m_size = 0;
+            }
+
+            HANDLE m_file = INVALID_HANDLE_VALUE;
+            HANDLE m_mapping = nullptr;
+#else
+            void open() {
+                auto fd = ::open(m_filename.c_str(), O_RDONLY);
+                if (fd < 0) return;
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                    auto view = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (view != MAP_FAILED) {
+                        m_data = static_cast<const uint8_t *>(view);
+                        m_size = size_t(st.st_size);
+                    }
+                }
+                // mapping keeps file alive
+                ::close(fd);
+            }
+
+            void close() {
+                if (m_data) ::munmap(const_cast<uint8_t *>(m_data), m_size);
+                m_data = nullptr;
+                m_size = 0;
+            }
+#endif
+
+            std::string m_filename;
+            const uint8_t *m_data = nullptr;
+            size_t m_size = 0;
+        };
+
+        /**
+         * Read-ahead of file list, like images of directory scan.
+         * One background thread maps and prefetches files in order, keeping at most `ahead` ready files,
+         * so reading next file overlaps with decoding current one.
+         */
+        class FilePrefetcher {
+        public:
+            using self = FilePrefetcher;
+
+            /**
+             * @param filenames files to be read in order
+             * @param ahead most files mapped and prefetched before taken
+             */
+            explicit FilePrefetcher(std::vector<std::string> filenames, size_t ahead = 4)
+                    : m_filenames(std::move(filenames)), m_ahead(std::max<size_t>(ahead, 1)) {
+                m_thread = std::thread([this]() { loop(); });
+            }
+
+            ~FilePrefetcher() {
+                {
+                    std::unique_lock<std::mutex> _locker(m_mutex);
+                    m_stopped = true;
+                }
+                m_cond.notify_all();
+                m_thread.join();
+            }
+
+            FilePrefetcher(const self &) = delete;
+
+            self &operator=(const self &) = delete;
+
+            /**
+             * Wait for next file.
+             * @return next file in order of filenames, empty mapping if failed to open, nullptr after last one
+             */
+            std::shared_ptr<const MappedFile> next() {
+                std::unique_lock<std::mutex> _locker(m_mutex);
+                if (m_taken >= m_filenames.size()) return nullptr;
+                m_cond.wait(_locker, [&]() { return !m_ready.empty(); });
+                auto file = m_ready.front();
+                m_ready.pop_front();
+                ++m_taken;
+                m_cond.notify_all();
+                return file;
+            }
+
+        private:
+            void loop() {
+                for (auto &filename : m_filenames) {
+                    {
+                        std::unique_lock<std::mutex> _locker(m_mutex);
+                        m_cond.wait(_locker, [&]() { return m_stopped || m_ready.size() < m_ahead; });
+                        if (m_stopped) return;
+                    }
+                    auto file = std::make_shared<MappedFile>(filename);
+                    file->prefetch();
+                    {
+                        std::unique_lock<std::mutex> _locker(m_mutex);
+                        m_ready.push_back(file);
+                    }
+                    m_cond.notify_all();
+                }
+            }
+
+            std::vector<std::string> m_filenames;
+            size_t m_ahead;
+            size_t m_taken = 0;
+            std::deque<std::shared_ptr<const MappedFile>> m_ready;
+            std::mutex m_mutex;
+            std::condition_variable m_cond;
+            bool m_stopped = false;
+            std::thread m_thread;
+        };
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_MAPPED_FILE_H
@@ -8,11 +8,21 @@
 
 #include "seeta_aip.h"
 #include "seeta_aip_struct.h"
+#include "seeta_aip_executor.h"
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <memory>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #define AIP_THREAD_LOCAL thread_local
 
@@ -31,6 +41,13 @@ namespace seeta {
                 std::vector<Object> objects;
             };
 
+            class Request {
+            public:
+                uint32_t method_id = 0;
+                std::vector<SeetaAIPImageData> images;
+                std::vector<SeetaAIPObject> objects;
+            };
+
             virtual ~Package() = default;
 
             virtual const char *error(int32_t errcode) = 0;
@@ -60,14 +77,90 @@ namespace seeta {
                     const std::vector<SeetaAIPImageData> &images,
                     const std::vector<SeetaAIPObject> &objects) = 0;
 
+            /**
+             * Forward each request, and set batch_result in same order.
+             * Default loop over forward, override it if the package could run real batched kernel.
+             * @param requests
+             */
+            virtual void forward_batch(const std::vector<Request> &requests) {
+                batch_result.clear();
+                batch_result.reserve(requests.size());
+                for (auto &request : requests) {
+                    forward(request.method_id, request.images, request.objects);
+                    batch_result.emplace_back();
+                    std::swap(batch_result.back(), result);
+                }
+            }
+
             const Result &const_result() const { return result; }
 
+            const std::vector<Result> &const_batch_result() const { return batch_result; }
+
+            /**
+             * Set caller provided output buffers, used by forward_into
+             * @param buffers
+             * @param size
+             */
+            void output_buffers(const SeetaAIPImageData *buffers, uint32_t size) {
+                if (!buffers) size = 0;
+                m_output_buffers.assign(buffers, buffers + size);
+            }
+
+            /**
+             * Set executor shared by host, used by executor()
+             * @param executor nullptr for package's own threads
+             */
+            void shared_executor(const SeetaAIPExecutor *executor) {
+                m_shared_executor = executor ? *executor : SeetaAIPExecutor();
+            }
+
+        protected:
+            /**
+             * Get i-th output image, which uses caller provided buffer if fits, otherwise new allocated.
+             * Use it in forward to write result image directly into caller's memory.
+             * @note the returned image may be borrowed, only valid in current forward.
+             */
+            ImageData output_image(size_t i,
+                                   SEETA_AIP_IMAGE_FORMAT format,
+                                   uint32_t number,
+                                   uint32_t width,
+                                   uint32_t height,
+                                   uint32_t channels) {
+                SeetaAIPImageData wanted = {int32_t(format), nullptr, number, height, width,
+                                            ImageData::GetChannels(format, channels)};
+                if (i < m_output_buffers.size() && ImageData::Fits(m_output_buffers[i], wanted)) {
+                    wanted.data = m_output_buffers[i].data;
+                    return ImageData::Borrow(wanted);
+                }
+                return ImageData(format, number, width, height, channels);
+            }
+
+            /**
+             * Get executor running image kernels, pass it where kernels take `threads`.
+             * @param threads most threads used, caller included, 0 for all threads of shared executor
+             * @return executor shared by host, or `threads` threads of package's default pool
+             */
+            Executor executor(int threads = 0) const {
+                if (m_shared_executor.parallel_for) return Executor(m_shared_executor, threads);
+                return Executor(threads);
+            }
+
+        private:
+            template<typename, typename>
+            friend class PackageWrapper;
+
+            std::vector<SeetaAIPImageData> m_output_buffers;
+            SeetaAIPExecutor m_shared_executor = {};
+
         protected:
             Result result;
+            std::vector<Result> batch_result;
         };
 
         namespace {
             AIP_THREAD_LOCAL char g_creation_error_message[256] = {0};
+            // last error message of calling thread, so forward_async callback reads its own error
+            AIP_THREAD_LOCAL char g_error_message[1024] = {0};
         }
 
         template<typename T>
@@ -112,6 +205,8 @@ namespace seeta {
                         return "Got unexpected null pointer.";
                     case SEETA_AIP_ERROR_WRITE_READONLY_PROPERTY:
                         return "Write read-only property.";
+                    case SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH:
+                        return "Output buffer not enough.";
                 }
                 try {
                     auto wrapper = static_cast<self *>((void *) aip);
@@ -122,7 +217,7 @@ namespace seeta {
                         return "Unhandled internal error.";
                     }
                     if (errcode == -1) {
-                        return wrapper->m_error_message.c_str();
+                        return wrapper->error_message();
                     }
                     if (wrapper == nullptr) {
                         T tmp;
@@ -187,6 +282,7 @@ namespace seeta {
                 try {
                     if (aip == nullptr) return 0;
                     auto wrapper = static_cast<self *>((void *) aip);
+                    wrapper->stop_worker();
                     Package *raw = wrapper->m_raw.get();
                     try {
                         raw->free();
@@ -207,13 +303,14 @@ namespace seeta {
                     if (aip == nullptr) return SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         raw->reset();
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return e.errcode();
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return -1;
                     }
                     return 0;
@@ -222,6 +319,21 @@ namespace seeta {
                 }
             }
 
+            static int32_t SEETA_AIP_CALL SetExecutor(
+                    SeetaAIPHandle aip, const SeetaAIPExecutor *executor) {
+                try {
+                    if (aip == nullptr) return SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE;
+                    auto wrapper = static_cast<self *>((void *) aip);
+                    Package *raw = wrapper->m_raw.get();
+                    // never change executor while forwarding
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
+                    raw->shared_executor(executor);
+                    return 0;
+                } catch (const std::exception &) {
+                    return SEETA_AIP_ERROR_UNHANDLED_INTERNAL_ERROR;
+                }
+            }
+
             static int32_t SEETA_AIP_CALL SetD(
                     SeetaAIPHandle aip, const char *name, double value) {
                 try {
@@ -229,13 +341,14 @@ namespace seeta {
                     if (name == nullptr) return SEETA_AIP_ERROR_NULLPTR;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         raw->setd(name, value);
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return e.errcode();
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return -1;
                     }
                     return 0;
@@ -251,13 +364,14 @@ namespace seeta {
                     if (name == nullptr) return SEETA_AIP_ERROR_NULLPTR;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         *pvalue = raw->getd(name);
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return e.errcode();
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return -1;
                     }
                     return 0;
@@ -272,13 +386,14 @@ namespace seeta {
                     if (aip == nullptr) return nullptr;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         return raw->property();
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return nullptr;
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return nullptr;
                     }
                     return nullptr;
@@ -295,13 +410,14 @@ namespace seeta {
                     if (pvalue == nullptr) return SEETA_AIP_ERROR_NULLPTR;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         raw->set(name, *pvalue);
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return e.errcode();
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return -1;
                     }
                     return 0;
@@ -317,13 +433,14 @@ namespace seeta {
                     if (name == nullptr) return SEETA_AIP_ERROR_NULLPTR;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         *pvalue = raw->get(name);
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return e.errcode();
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return -1;
                     }
                     return 0;
@@ -344,6 +461,7 @@ namespace seeta {
                     if (aip == nullptr) return SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         if (result_objects) *result_objects = nullptr;
                         if (result_objects_size) *result_objects_size = 0;
@@ -355,10 +473,80 @@ namespace seeta {
                         raw->forward(method_id, input_images, input_objects);
                         wrapper->update_output(result_objects, result_objects_size, result_images, result_images_size);
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
+                        return e.errcode();
+                    } catch (const std::exception &e) {
+                        wrapper->error_message(e.what());
+                        return -1;
+                    }
+                    return 0;
+                } catch (const std::exception &) {
+                    return SEETA_AIP_ERROR_UNHANDLED_INTERNAL_ERROR;
+                }
+            }
+
+            static int32_t SEETA_AIP_CALL ForwardInto(
+                    SeetaAIPHandle aip,
+                    uint32_t method_id,
+                    const struct SeetaAIPImageData *images, uint32_t images_size,
+                    const struct SeetaAIPObject *objects, uint32_t objects_size,
+                    struct SeetaAIPObject **result_objects, uint32_t result_objects_capacity,
+                    uint32_t *result_objects_size,
+                    struct SeetaAIPImageData **result_images, uint32_t result_images_capacity,
+                    uint32_t *result_images_size) {
+                try {
+                    if (aip == nullptr) return SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE;
+                    auto wrapper = static_cast<self *>((void *) aip);
+                    Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
+                    // output buffers only valid in this call
+                    std::shared_ptr<void> _reset(nullptr, [raw](void *) { raw->output_buffers(nullptr, 0); });
+                    try {
+                        if (result_objects_size) *result_objects_size = 0;
+                        if (result_images_size) *result_images_size = 0;
+                        if (!result_objects || !*result_objects) result_objects_capacity = 0;
+                        if (!result_images || !*result_images) result_images_capacity = 0;
+                        raw->output_buffers(result_images ? *result_images : nullptr, result_images_capacity);
+                        wrapper->update_input(images, images_size, objects, objects_size);
+                        auto &input_images = wrapper->m_input_images;
+                        auto &input_objects = wrapper->m_input_objects;
+                        raw->forward(method_id, input_images, input_objects);
+                        wrapper->update_into_output(
+                                result_objects, result_objects_capacity, result_objects_size,
+                                result_images, result_images_capacity, result_images_size);
+                    } catch (const Exception &e) {
+                        wrapper->error_message(e.message());
+                        return e.errcode();
+                    } catch (const std::exception &e) {
+                        wrapper->error_message(e.what());
+                        return -1;
+                    }
+                    return 0;
+                } catch (const std::exception &) {
+                    return SEETA_AIP_ERROR_UNHANDLED_INTERNAL_ERROR;
+                }
+            }
+
+            static int32_t SEETA_AIP_CALL ForwardBatch(
+                    SeetaAIPHandle aip,
+                    const struct SeetaAIPForwardRequest *requests, uint32_t requests_size,
+                    struct SeetaAIPForwardResult **results) {
+                try {
+                    if (aip == nullptr) return SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE;
+                    if (requests == nullptr && requests_size) return SEETA_AIP_ERROR_NULLPTR;
+                    auto wrapper = static_cast<self *>((void *) aip);
+                    Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
+                    try {
+                        if (results) *results = nullptr;
+                        wrapper->update_batch_input(requests, requests_size);
+                        raw->forward_batch(wrapper->m_batch_requests);
+                        wrapper->update_batch_output(results);
+                    } catch (const Exception &e) {
+                        wrapper->error_message(e.message());
                         return e.errcode();
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return -1;
                     }
                     return 0;
@@ -367,19 +555,78 @@ namespace seeta {
                 }
             }
 
+            static int32_t SEETA_AIP_CALL ForwardAsync(
+                    SeetaAIPHandle aip,
+                    uint32_t method_id,
+                    const struct SeetaAIPImageData *images, uint32_t images_size,
+                    const struct SeetaAIPObject *objects, uint32_t objects_size,
+                    seeta_aip_forward_callback *callback, void *userdata) {
+                try {
+                    if (aip == nullptr) return SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE;
+                    if (callback == nullptr) return SEETA_AIP_ERROR_NULLPTR;
+                    auto wrapper = static_cast<self *>((void *) aip);
+                    if (!images) images_size = 0;
+                    if (!objects) objects_size = 0;
+                    // only the arrays are copied, the data they pointed are borrowed until callback.
+                    std::shared_ptr<std::vector<SeetaAIPImageData>> async_images(
+                            new std::vector<SeetaAIPImageData>(images, images + images_size));
+                    std::shared_ptr<std::vector<SeetaAIPObject>> async_objects(
+                            new std::vector<SeetaAIPObject>(objects, objects + objects_size));
+                    wrapper->submit([=]() {
+                        Package::Result result;
+                        int32_t errcode = 0;
+                        {
+                            std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
+                            Package *raw = wrapper->m_raw.get();
+                            // each request has its own result, the borrowed result of Forward is kept unchanged
+                            Package::Result borrowed;
+                            std::swap(borrowed, raw->result);
+                            try {
+                                raw->forward(method_id, *async_images, *async_objects);
+                            } catch (const Exception &e) {
+                                wrapper->error_message(e.message());
+                                errcode = e.errcode();
+                            } catch (const std::exception &e) {
+                                wrapper->error_message(e.what());
+                                errcode = -1;
+                            }
+                            std::swap(result, raw->result);
+                            std::swap(borrowed, raw->result);
+                        }
+                        if (errcode) result = Package::Result();
+                        std::vector<SeetaAIPImageData> result_images;
+                        result_images.reserve(result.images.size());
+                        for (auto &image : result.images) result_images.emplace_back(*image.raw());
+                        std::vector<SeetaAIPObject> result_objects;
+                        result_objects.reserve(result.objects.size());
+                        for (auto &object : result.objects) result_objects.emplace_back(*object.raw());
+                        // called without lock, so callback could use other entries of aip
+                        callback(userdata, errcode,
+                                 result_objects.data(), uint32_t(result_objects.size()),
+                                 result_images.data(), uint32_t(result_images.size()));
+                    });
+                    return 0;
+                } catch (const std::bad_alloc &) {
+                    return SEETA_AIP_ERROR_BAD_ALLOC;
+                } catch (const std::exception &) {
+                    return SEETA_AIP_ERROR_UNHANDLED_INTERNAL_ERROR;
+                }
+            }
+
             static const char *SEETA_AIP_CALL Tag(
                     SeetaAIPHandle aip, uint32_t method_id, uint32_t label_index, int32_t label_value) {
                 try {
                     if (aip == nullptr) return nullptr;
                     auto wrapper = static_cast<self *>((void *) aip);
                     Package *raw = wrapper->m_raw.get();
+                    std::unique_lock<std::recursive_mutex> _locker(wrapper->m_forward_mutex);
                     try {
                         return raw->tag(method_id, label_index, label_value);
                     } catch (const Exception &e) {
-                        wrapper->m_error_message = e.message();
+                        wrapper->error_message(e.message());
                         return nullptr;
                     } catch (const std::exception &e) {
-                        wrapper->m_error_message = e.what();
+                        wrapper->error_message(e.what());
                         return nullptr;
                     }
                 } catch (const std::exception &) {
@@ -387,16 +634,85 @@ namespace seeta {
                 }
             }
 
+            ~PackageWrapper() {
+                stop_worker();
+            }
+
         private:
             std::shared_ptr<Raw> m_raw;
-            std::string m_error_message;
             std::vector<int32_t> m_property;
             std::vector<SeetaAIPImageData> m_input_images;
             std::vector<SeetaAIPObject> m_input_objects;
             std::vector<SeetaAIPImageData> m_output_images;
             std::vector<SeetaAIPObject> m_output_objects;
 
+            std::vector<Package::Request> m_batch_requests;
+            std::vector<SeetaAIPImageData> m_batch_output_images;
+            std::vector<SeetaAIPObject> m_batch_output_objects;
+            std::vector<SeetaAIPForwardResult> m_batch_output;
+
+            // every entry calling into package holds it, so forward_async worker never runs concurrently
+            std::recursive_mutex m_forward_mutex;
+
+            // forward_async worker, started at first submit
+            std::mutex m_task_mutex;
+            std::condition_variable m_task_cond;
+            std::deque<std::function<void()>> m_tasks;
+            std::thread m_worker;
+            bool m_worker_stop = false;
+
         private:
+            static void error_message(const std::string &message) {
+                std::snprintf(g_error_message, sizeof(g_error_message), "%s", message.c_str());
+            }
+
+            /**
+             * @return last error message of calling thread, valid until next error on same thread
+             */
+            static const char *error_message() {
+                return g_error_message;
+            }
+
+            void submit(const std::function<void()> &task) {
+                std::unique_lock<std::mutex> _locker(m_task_mutex);
+                if (m_worker_stop) throw Exception(SEETA_AIP_ERROR_EMPTY_PACKAGE_HANDLE);
+                if (!m_worker.joinable()) {
+                    m_worker = std::thread(&self::worker, this);
+                }
+                m_tasks.push_back(task);
+                m_task_cond.notify_all();
+            }
+
+            void worker() {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> _locker(m_task_mutex);
+                        m_task_cond.wait(_locker, [this]() { return m_worker_stop || !m_tasks.empty(); });
+                        if (m_tasks.empty()) break; // stopped and all tasks done
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+                    try {
+                        task();
+                    } catch (const std::exception &e) {
+                        std::cerr << "Forward async got unhandled exception: " << e.what() << std::endl;
+                    }
+                }
+            }
+
+            /**
+             * wait all submitted tasks finished, then stop worker thread
+             */
+            void stop_worker() {
+                {
+                    std::unique_lock<std::mutex> _locker(m_task_mutex);
+                    m_worker_stop = true;
+                    m_task_cond.notify_all();
+                }
+                if (m_worker.joinable()) m_worker.join();
+            }
+
             void update_input(
                     const struct SeetaAIPImageData *images, uint32_t images_size,
                     const struct SeetaAIPObject *objects, uint32_t objects_size) {
@@ -430,6 +746,110 @@ namespace seeta {
                 if (result_images) *result_images = m_output_images.data();
                 if (result_images_size) *result_images_size = uint32_t(m_output_images.size());
             }
+
+            /**
+             * Write result into caller's arrays, NULL array or NULL image data gets borrowed value.
+             * @throw Exception(SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH) after sizes and shapes needed are set
+             */
+            void update_into_output(
+                    struct SeetaAIPObject **result_objects, uint32_t result_objects_capacity,
+                    uint32_t *result_objects_size,
+                    struct SeetaAIPImageData **result_images, uint32_t result_images_capacity,
+                    uint32_t *result_images_size) {
+                Package *raw = m_raw.get();
+                auto &result = raw->const_result();
+                bool enough = true;
+                if (result_images && *result_images) {
+                    auto buffers = *result_images;
+                    if (result.images.size() > result_images_capacity) enough = false;
+                    auto size = std::min<size_t>(result.images.size(), result_images_capacity);
+                    for (size_t i = 0; i < size; ++i) {
+                        auto image = *result.images[i].raw();
+                        auto &buffer = buffers[i];
+                        if (buffer.data == nullptr || image.data == buffer.data) {
+                            // borrowed, or already written by package
+                        } else if (ImageData::Fits(buffer, image)) {
+                            std::memcpy(buffer.data, image.data, ImageData::GetBytes(image));
+                            image.data = buffer.data;
+                        } else {
+                            // tell caller the buffer needed
+                            enough = false;
+                            image.data = buffer.data;
+                        }
+                        buffer = image;
+                    }
+                } else if (result_images) {
+                    m_output_images.clear();
+                    for (auto &image : result.images) {
+                        m_output_images.emplace_back(*image.raw());
+                    }
+                    *result_images = m_output_images.data();
+                }
+                if (result_objects && *result_objects) {
+                    if (result.objects.size() > result_objects_capacity) enough = false;
+                    auto size = std::min<size_t>(result.objects.size(), result_objects_capacity);
+                    for (size_t i = 0; i < size; ++i) {
+                        (*result_objects)[i] = *result.objects[i].raw();
+                    }
+                } else if (result_objects) {
+                    m_output_objects.clear();
+                    for (auto &object : result.objects) {
+                        m_output_objects.emplace_back(*object.raw());
+                    }
+                    *result_objects = m_output_objects.data();
+                }
+                if (result_objects_size) *result_objects_size = uint32_t(result.objects.size());
+                if (result_images_size) *result_images_size = uint32_t(result.images.size());
+                if (!enough) throw Exception(SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH, "Output buffer not enough.");
+            }
+
+            void update_batch_input(const struct SeetaAIPForwardRequest *requests, uint32_t requests_size) {
+                m_batch_requests.resize(requests_size);
+                for (uint32_t i = 0; i < requests_size; ++i) {
+                    auto &request = requests[i];
+                    auto &input = m_batch_requests[i];
+                    auto images_size = request.images ? request.images_size : 0;
+                    auto objects_size = request.objects ? request.objects_size : 0;
+                    input.method_id = request.method_id;
+                    input.images.assign(request.images, request.images + images_size);
+                    input.objects.assign(request.objects, request.objects + objects_size);
+                }
+            }
+
+            void update_batch_output(struct SeetaAIPForwardResult **results) {
+                Package *raw = m_raw.get();
+                auto &batch = raw->const_batch_result();
+                if (batch.size() != m_batch_requests.size()) {
+                    throw Exception("Package forward_batch must set one result for each request.");
+                }
+                size_t images_size = 0;
+                size_t objects_size = 0;
+                for (auto &result : batch) {
+                    images_size += result.images.size();
+                    objects_size += result.objects.size();
+                }
+                // reserved first, so the data pointers are stable
+                m_batch_output_images.clear();
+                m_batch_output_images.reserve(images_size);
+                m_batch_output_objects.clear();
+                m_batch_output_objects.reserve(objects_size);
+                m_batch_output.resize(batch.size());
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    auto &result = batch[i];
+                    auto &output = m_batch_output[i];
+                    output.images = m_batch_output_images.data() + m_batch_output_images.size();
+                    output.images_size = uint32_t(result.images.size());
+                    for (auto &image : result.images) {
+                        m_batch_output_images.emplace_back(*image.raw());
+                    }
+                    output.objects = m_batch_output_objects.data() + m_batch_output_objects.size();
+                    output.objects_size = uint32_t(result.objects.size());
+                    for (auto &object : result.objects) {
+                        m_batch_output_objects.emplace_back(*object.raw());
+                    }
+                }
+                if (results) *results = m_batch_output.data();
+            }
         };
 
         class Header {
@@ -490,13 +910,58 @@ namespace seeta {
             aip.tag = Wrapper::Tag;
             aip.set = Wrapper::Set;
             aip.get = Wrapper::Get;
+            aip.forward_async = Wrapper::ForwardAsync;
+            aip.forward_batch = Wrapper::ForwardBatch;
+            aip.forward_into = Wrapper::ForwardInto;
+            aip.set_executor = Wrapper::SetExecutor;
+        }
+
+        namespace _ {
+            /**
+             * Size of SeetaAIP before entries appended, hosts built with it still load this AIP.
+             */
+            static const uint32_t legacy_aip_size = uint32_t(offsetof(SeetaAIP, forward_async));
+
+            /**
+             * Let setup functions write full sized SeetaAIP, then copy back fields fit in host's size.
+             */
+            class LoadGuard {
+            public:
+                using self = LoadGuard;
+
+                LoadGuard(SeetaAIP *aip, uint32_t size)
+                        : m_aip(aip), m_size(std::min<size_t>(size, sizeof(SeetaAIP))) {
+                    std::memcpy(&m_full, aip, m_size);
+                }
+
+                ~LoadGuard() {
+                    std::memcpy(m_aip, &m_full, m_size);
+                }
+
+                LoadGuard(const self &) = delete;
+
+                self &operator=(const self &) = delete;
+
+                SeetaAIP *full() { return &m_full; }
+
+            private:
+                SeetaAIP *m_aip;
+                size_t m_size;
+                SeetaAIP m_full = {};
+            };
         }
 
+/**
+ * Accept host's SeetaAIP not shorter than legacy size, the entries beyond host's size are not written.
+ * `aip` is redirected to full sized one, copied back when load function returns.
+ */
 #define CHECK_AIP_SIZE(aip, size) \
-            if (size < sizeof(SeetaAIP)) { \
+            if (size < seeta::aip::_::legacy_aip_size) { \
                 if (size > 4) aip->aip_version = SEETA_AIP_VERSION; \
                 return SEETA_AIP_LOAD_SIZE_NOT_ENOUGH; \
-            }
+            } \
+            seeta::aip::_::LoadGuard _aip_load_guard(aip, size); \
+            aip = _aip_load_guard.full();
     }
 }
 
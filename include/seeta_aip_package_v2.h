@@ -149,6 +149,16 @@ namespace seeta {
                 }
             }
 
+            /**
+             * Declare input images in `format` are accepted directly, like YUV frames from camera.
+             * Host could check it by `accept_format_property(format)`, then skip converting.
+             * @param format accepted image format
+             */
+            void bind_accept_format(SEETA_AIP_IMAGE_FORMAT format) {
+                PropertyGetter getter = []() { return 1.0; };
+                bind_property(accept_format_property(format), getter);
+            }
+
             template<typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
             void bind_property(const std::string &name, T &value, PropertyType type = Writeable) {
                 PropertyGetter getter = [&value]() { return static_cast<double>(value); };
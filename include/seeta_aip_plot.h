@@ -6,9 +6,12 @@
 #define SEETA_AIP_SEETA_AIP_PLOT_H
 
 #include "seeta_aip_struct.h"
+#include "seeta_aip_simd.h"
 #include <cmath>
 #include <climits>
 #include <cfloat>
+#include <vector>
+#include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -54,11 +57,11 @@ namespace seeta {
                 return std::max(min, std::min(x, max));
             }
 
-            inline void put_uint8_pixel(SeetaAIPImageData image,
+            inline void put_uint8_pixel(const ImageView &image,
                                         int32_t x, int32_t y,
                                         const Color &color) {
                 auto data = reinterpret_cast<uint8_t *>(image.data);
-                auto pixel = &data[(y * image.width + x) * image.channels];
+                auto pixel = &data[size_t(y) * ImageData::GetRowStride(image) + size_t(x) * image.channels];
                 int32_t alpha = color.c4;
                 switch (image.channels) {
                     case 4:
@@ -72,175 +75,296 @@ namespace seeta {
                 }
             }
 
-            static inline std::vector<PutSetting> _prepare_rectangle_solid(
-                    uint32_t width, uint32_t height,
-                    const SeetaAIPPoint &p1, const SeetaAIPPoint &p2,
-                    int line_width) {
-                // check plot area
-                if (line_width <= 0) return {};
-                auto area_width = p2.x - p1.x;
-                auto area_height = p2.y - p1.y;
-                if (area_height < 0 || area_width < 0) return {};
-                auto half = (line_width - 1) / 2;
-                // get int area: [top, bottom) x [left, right)
-                auto top = int32_t(lroundf(p1.y - half));
-                auto bottom = int32_t(lroundf(top + area_height + float(line_width)));
-                auto left = int32_t(lroundf(p1.x - half));
-                auto right = int32_t(lroundf(left + area_width + float(line_width)));
+            static inline float _pow2(float x) { return x * x; }
 
-                // compute not plot area
-                auto c_top = top + line_width;
-                auto c_bottom = bottom - line_width;
-                auto c_left = left + line_width;
-                auto c_right = right - line_width;
-                if (c_bottom < c_top) c_bottom = c_top;
-                if (c_right < c_left) c_right = c_left;
-
-                // check all pixel in graph
-                if (top < 0) top = 0;
-                if (bottom > int32_t(height)) bottom = height;
-                if (left < 0) left = 0;
-                if (right > int32_t(width)) right = width;
-
-                if (c_top < 0) c_top = 0;
-                if (c_bottom > int32_t(height)) c_bottom = height;
-                if (c_left < 0) c_left = 0;
-                if (c_right > int32_t(width)) c_right = width;
-
-                std::vector<PutSetting> setting;
-                for (decltype(top) y = top; y < c_top; ++y) {
-                    for (decltype(left) x = left; x < right; ++x) {
-                        setting.emplace_back(PutSetting({x, y, 0xff}));
+            static inline float _distance(const SeetaAIPPoint &a, const SeetaAIPPoint &b) {
+                return sqrtf(_pow2(a.x - b.x) + _pow2(a.y - b.y));
+            }
+
+            /**
+             * Horizontal run of pixels [x0, x1) on row y with same coverage.
+             */
+            class PutSpan {
+            public:
+                int32_t x0;
+                int32_t x1;
+                int32_t y;
+                int32_t alpha;  //< [0, 255], 255 means full color plot
+            };
+
+            static inline int32_t _div255(int32_t x) {
+                // exact x / 255 for x in [0, 255 * 255]
+                return (x + 1 + (x >> 8)) >> 8;
+            }
+
+            /**
+             * Blend `count` pixels to color, alpha channel is blended to 255, same as put_uint8_pixel.
+             */
+            template<int C>
+            static inline void _blend_span(uint8_t *pixel, int32_t count, const uint8_t *color, int32_t alpha) {
+                uint8_t target[C];
+                for (int c = 0; c < C; ++c) target[c] = c < 3 ? color[c] : 0xff;
+                // kernels work on blocks of 16 pixels, short spans go scalar directly
+                auto kernels = count >= 16 ? simd::blend_kernels() : nullptr;
+                if (kernels) {
+                    auto done = alpha == 255
+                                ? kernels->fill[C](pixel, count, target)
+                                : kernels->blend[C](pixel, count, target, alpha);
+                    pixel += size_t(done) * C;
+                    count -= done;
+                }
+                if (alpha == 255) {
+                    for (int32_t i = 0; i < count; ++i, pixel += C) {
+                        for (int c = 0; c < C; ++c) pixel[c] = target[c];
                     }
+                    return;
                 }
-                for (decltype(top) y = c_top; y < c_bottom; ++y) {
-                    for (decltype(left) x = left; x < c_left; ++x) {
-                        setting.emplace_back(PutSetting({x, y, 0xff}));
-                    }
-                    for (decltype(left) x = c_right; x < right; ++x) {
-                        setting.emplace_back(PutSetting({x, y, 0xff}));
+                auto keep = 255 - alpha;
+                for (int32_t i = 0; i < count; ++i, pixel += C) {
+                    for (int c = 0; c < C; ++c) {
+                        pixel[c] = uint8_t(_div255(keep * pixel[c] + alpha * target[c]));
                     }
                 }
-                for (decltype(top) y = c_bottom; y < bottom; ++y) {
-                    for (decltype(left) x = left; x < right; ++x) {
-                        setting.emplace_back(PutSetting({x, y, 0xff}));
+            }
+
+            /**
+             * Blend `count` pixels to color with per pixel coverage, same as _blend_span of each pixel.
+             */
+            template<int C>
+            static inline void _blend_mask(uint8_t *pixel, int32_t count, const uint8_t *color, int32_t alpha,
+                                           const uint8_t *coverage) {
+                uint8_t target[C];
+                for (int c = 0; c < C; ++c) target[c] = c < 3 ? color[c] : 0xff;
+                auto kernels = count >= 16 ? simd::blend_kernels() : nullptr;
+                int32_t i = 0;
+                if (kernels) {
+                    i = kernels->blend_mask[C](pixel, count, target, alpha, coverage);
+                    pixel += size_t(i) * C;
+                }
+                for (; i < count; ++i, pixel += C) {
+                    auto a = alpha * coverage[i] / 255;
+                    auto keep = 255 - a;
+                    for (int c = 0; c < C; ++c) {
+                        pixel[c] = uint8_t(_div255(keep * pixel[c] + a * target[c]));
                     }
                 }
-                return setting;
             }
 
-            static inline std::vector<PutSetting> _prepare_fill_rectangle_solid(
-                    uint32_t width, uint32_t height,
-                    const SeetaAIPPoint &p1, const SeetaAIPPoint &p2) {
-                // check plot area
-                auto area_width = p2.x - p1.x;
-                auto area_height = p2.y - p1.y;
-                if (area_height < 0 || area_width < 0) return {};
-                // get int area: [top, bottom) x [left, right)
-                auto top = int32_t(lroundf(p1.y));
-                auto bottom = int32_t(lroundf(top + area_height + 1));
-                auto left = int32_t(lroundf(p1.x));
-                auto right = int32_t(lroundf(left + area_width + 1));
-
-                // check all pixel in graph
-                if (top < 0) top = 0;
-                if (bottom > int32_t(height)) bottom = height;
-                if (left < 0) left = 0;
-                if (right > int32_t(width)) right = width;
-
-                std::vector<PutSetting> setting;
-                for (decltype(top) y = top; y < bottom; ++y) {
-                    for (decltype(left) x = left; x < right; ++x) {
-                        // plot pixel
-                        setting.emplace_back(PutSetting({x, y, 0xff}));
-                    }
+            inline void put_uint8_span(const ImageView &image,
+                                       const PutSpan &span,
+                                       const Color &color) {
+                auto data = reinterpret_cast<uint8_t *>(image.data);
+                auto pixel = &data[size_t(span.y) * ImageData::GetRowStride(image) + size_t(span.x0) * image.channels];
+                auto count = span.x1 - span.x0;
+                int32_t alpha = color.c4 * span.alpha / 255;
+                if (count <= 0 || alpha <= 0) return;
+                switch (image.channels) {
+                    case 4: _blend_span<4>(pixel, count, &color.c1, alpha); break;
+                    case 3: _blend_span<3>(pixel, count, &color.c1, alpha); break;
+                    case 2: _blend_span<2>(pixel, count, &color.c1, alpha); break;
+                    case 1: _blend_span<1>(pixel, count, &color.c1, alpha); break;
+                    default: break;
                 }
+            }
 
-                return setting;
+            template<int C>
+            static inline void _blend_spans(const ImageView &image, const PutSpan *spans, size_t count,
+                                            const Color &color) {
+                auto data = reinterpret_cast<uint8_t *>(image.data);
+                auto row_stride = size_t(ImageData::GetRowStride(image));
+                for (size_t i = 0; i < count; ++i) {
+                    auto &span = spans[i];
+                    int32_t alpha = color.c4 * span.alpha / 255;
+                    if (span.x1 <= span.x0 || alpha <= 0) continue;
+                    _blend_span<C>(data + size_t(span.y) * row_stride + size_t(span.x0) * C,
+                                   span.x1 - span.x0, &color.c1, alpha);
+                }
             }
 
-            static inline float _pow2(float x) { return x * x; }
+            /**
+             * Blend all spans, same as put_uint8_span for each span.
+             */
+            inline void put_uint8_spans(const ImageView &image,
+                                        const std::vector<PutSpan> &spans,
+                                        const Color &color) {
+                switch (image.channels) {
+                    case 4: _blend_spans<4>(image, spans.data(), spans.size(), color); break;
+                    case 3: _blend_spans<3>(image, spans.data(), spans.size(), color); break;
+                    case 2: _blend_spans<2>(image, spans.data(), spans.size(), color); break;
+                    case 1: _blend_spans<1>(image, spans.data(), spans.size(), color); break;
+                    default: break;
+                }
+            }
 
-            static inline float _distance(const SeetaAIPPoint &a, const SeetaAIPPoint &b) {
-                return sqrtf(_pow2(a.x - b.x) + _pow2(a.y - b.y));
+            /**
+             * Blend pixels [x, x + count) on row y with per pixel coverage, pixels out of image are skipped.
+             * @param image BYTE type HWC format image, could be strided view, channels must be fixed.
+             * @param coverage `count` values in [0, 255], 255 means full color plot
+             */
+            inline void put_uint8_mask(const ImageView &image,
+                                       int32_t x, int32_t y, const uint8_t *coverage, int32_t count,
+                                       const Color &color) {
+                if (y < 0 || y >= int32_t(image.height)) return;
+                if (x < 0) {
+                    coverage -= x;
+                    count += x;
+                    x = 0;
+                }
+                count = std::min(count, int32_t(image.width) - x);
+                if (count <= 0 || color.c4 == 0) return;
+                auto data = reinterpret_cast<uint8_t *>(image.data);
+                auto pixel = &data[size_t(y) * ImageData::GetRowStride(image) + size_t(x) * image.channels];
+                switch (image.channels) {
+                    case 4: _blend_mask<4>(pixel, count, &color.c1, color.c4, coverage); break;
+                    case 3: _blend_mask<3>(pixel, count, &color.c1, color.c4, coverage); break;
+                    case 2: _blend_mask<2>(pixel, count, &color.c1, color.c4, coverage); break;
+                    case 1: _blend_mask<1>(pixel, count, &color.c1, color.c4, coverage); break;
+                    default: break;
+                }
             }
 
-            static inline std::vector<PutSetting> _prepare_fill_circle(
-                    uint32_t width, uint32_t height,
-                    const SeetaAIPPoint &center, int radius) {
-                // check plot area
-                auto area_width = 2 * radius;
-                auto area_height = 2 * radius;
-                if (area_height < 0 || area_width < 0) return {};
-                // get int area: [top, bottom) x [left, right)
-                auto top = int32_t(floorf(center.y - radius));
-                auto bottom = int32_t(ceilf(center.y + radius + 1));
-                auto left = int32_t(floorf(center.x - radius));
-                auto right = int32_t(ceilf(center.x + radius + 1));
+            /**
+             * Append span clipped in image, merged into last span if continuous with same coverage.
+             */
+            static inline void _push_span(std::vector<PutSpan> &spans, uint32_t width, uint32_t height,
+                                          int32_t x0, int32_t x1, int32_t y, int32_t alpha) {
+                if (alpha <= 0 || y < 0 || y >= int32_t(height)) return;
+                x0 = std::max(x0, 0);
+                x1 = std::min(x1, int32_t(width));
+                if (x0 >= x1) return;
+                if (!spans.empty()) {
+                    auto &last = spans.back();
+                    if (last.y == y && last.x1 == x0 && last.alpha == alpha) {
+                        last.x1 = x1;
+                        return;
+                    }
+                }
+                spans.push_back({x0, x1, y, alpha});
+            }
 
-                // check all pixel in graph
-                if (top < 0) top = 0;
-                if (bottom > int32_t(height)) bottom = height;
-                if (left < 0) left = 0;
-                if (right > int32_t(width)) right = width;
+            static inline int32_t _coverage(float part) {
+                return int32_t(std::min(std::max(part, 0.0f), 1.0f) * 255);
+            }
 
-                std::vector<PutSetting> setting;
-                for (decltype(top) y = top; y < bottom; ++y) {
-                    for (decltype(left) x = left; x < right; ++x) {
-                        // plot pixel
-                        auto d = _distance(center, {float(x), float(y)});
-                        auto part = radius + 0.5f - d;
-                        if (part <= 0) continue;
-                        if (part >= 1) {
-                            setting.emplace_back(PutSetting({x, y, 0xff}));
+            /**
+             * Scan row y in [left, right), y must be in image, coverage of pixels in windows are computed one by one.
+             * Coverage must be constant between windows, so each gap is one span with coverage of its first pixel.
+             * @param windows [begin, end) pairs, will be sorted and merged
+             * @param coverage int32_t(int32_t x) coverage of pixel x
+             */
+            template<typename FUNC>
+            static inline void _scan_row(std::vector<PutSpan> &spans, uint32_t width, uint32_t height,
+                                         int32_t y, int32_t left, int32_t right,
+                                         std::vector<std::pair<int32_t, int32_t>> &windows, FUNC coverage) {
+                left = std::max(left, 0);
+                right = std::min(right, int32_t(width));
+                std::sort(windows.begin(), windows.end());
+                auto x = left;
+                for (auto &window : windows) {
+                    auto begin = std::max(window.first, x);
+                    auto end = std::min(window.second, right);
+                    if (begin >= end) continue;
+                    if (x < begin) {
+                        _push_span(spans, width, height, x, begin, y, coverage(x));
+                    }
+                    // pixels are in image, only merged
+                    for (x = begin; x < end; ++x) {
+                        auto alpha = coverage(x);
+                        if (alpha <= 0) continue;
+                        if (!spans.empty() && spans.back().y == y && spans.back().x1 == x
+                            && spans.back().alpha == alpha) {
+                            ++spans.back().x1;
                         } else {
-                            setting.emplace_back(PutSetting({x, y, int32_t(part * 255)}));
+                            spans.push_back({x, x + 1, y, alpha});
                         }
                     }
                 }
+                if (x < right) {
+                    _push_span(spans, width, height, x, right, y, coverage(x));
+                }
+            }
+
+            /**
+             * Append window of pixels could be in [lo, hi], pixels out of it are at least 1 pixel away.
+             */
+            static inline void _window(std::vector<std::pair<int32_t, int32_t>> &windows, float lo, float hi) {
+                windows.emplace_back(int32_t(floorf(lo)), int32_t(ceilf(hi)) + 1);
+            }
+
+            /**
+             * Append windows of band lo < |x - center| < hi.
+             */
+            static inline void _band_windows(std::vector<std::pair<int32_t, int32_t>> &windows,
+                                             float center, float lo, float hi) {
+                if (hi < lo) return;
+                _window(windows, center - hi, center - lo);
+                _window(windows, center + lo, center + hi);
+            }
 
-                return setting;
+            /**
+             * Append windows of radial band lo < d < hi on row, d is distance to center.
+             */
+            static inline void _radial_windows(std::vector<std::pair<int32_t, int32_t>> &windows,
+                                               const SeetaAIPPoint &center, float y, float lo, float hi) {
+                auto dy2 = _pow2(y - center.y);
+                auto hi2 = _pow2(hi) - dy2;
+                if (hi <= 0 || hi2 < 0) return;
+                auto lo2 = lo > 0 ? _pow2(lo) - dy2 : 0;
+                _band_windows(windows, center.x, lo2 > 0 ? sqrtf(lo2) : 0, sqrtf(hi2));
             }
 
-            static inline std::vector<PutSetting> _prepare_circle(
+            static inline std::vector<PutSpan> _prepare_rectangle_solid(
                     uint32_t width, uint32_t height,
-                    const SeetaAIPPoint &center, int radius,
+                    const SeetaAIPPoint &p1, const SeetaAIPPoint &p2,
                     int line_width) {
                 // check plot area
                 if (line_width <= 0) return {};
-                auto area_width = 2 * radius;
-                auto area_height = 2 * radius;
+                auto area_width = p2.x - p1.x;
+                auto area_height = p2.y - p1.y;
                 if (area_height < 0 || area_width < 0) return {};
-                auto half = float(line_width) / 2;
+                auto half = (line_width - 1) / 2;
                 // get int area: [top, bottom) x [left, right)
-                auto top = int32_t(floorf(center.y - radius - half));
-                auto bottom = int32_t(ceilf(center.y + radius + half + 1));
-                auto left = int32_t(floorf(center.x - radius - half));
-                auto right = int32_t(ceilf(center.x + radius + half + 1));
-
-                // check all pixel in graph
-                if (top < 0) top = 0;
-                if (bottom > int32_t(height)) bottom = height;
-                if (left < 0) left = 0;
-                if (right > int32_t(width)) right = width;
+                auto top = int32_t(lroundf(p1.y - half));
+                auto bottom = int32_t(lroundf(top + area_height + float(line_width)));
+                auto left = int32_t(lroundf(p1.x - half));
+                auto right = int32_t(lroundf(left + area_width + float(line_width)));
 
-                std::vector<PutSetting> setting;
-                for (decltype(top) y = top; y < bottom; ++y) {
-                    for (decltype(left) x = left; x < right; ++x) {
-                        // plot pixel
-                        auto d = _distance(center, {float(x), float(y)});
-                        auto part = std::min(radius + half + 0.5f - d,
-                                             d - (radius - half - 0.5f));
-                        if (part <= 0) continue;
-                        if (part >= 1) {
-                            setting.emplace_back(PutSetting({x, y, 0xff}));
-                        } else {
-                            setting.emplace_back(PutSetting({x, y, int32_t(part * 255)}));
-                        }
+                // compute not plot area
+                auto c_top = std::min(top + line_width, bottom);
+                auto c_bottom = std::max(bottom - line_width, c_top);
+                auto c_left = std::min(left + line_width, right);
+                auto c_right = std::max(right - line_width, c_left);
+
+                std::vector<PutSpan> spans;
+                for (auto y = std::max(top, 0); y < std::min(bottom, int32_t(height)); ++y) {
+                    if (y < c_top || y >= c_bottom) {
+                        _push_span(spans, width, height, left, right, y, 0xff);
+                    } else {
+                        _push_span(spans, width, height, left, c_left, y, 0xff);
+                        _push_span(spans, width, height, c_right, right, y, 0xff);
                     }
                 }
+                return spans;
+            }
 
-                return setting;
+            static inline std::vector<PutSpan> _prepare_fill_rectangle_solid(
+                    uint32_t width, uint32_t height,
+                    const SeetaAIPPoint &p1, const SeetaAIPPoint &p2) {
+                // check plot area
+                auto area_width = p2.x - p1.x;
+                auto area_height = p2.y - p1.y;
+                if (area_height < 0 || area_width < 0) return {};
+                // get int area: [top, bottom) x [left, right)
+                auto top = int32_t(lroundf(p1.y));
+                auto bottom = int32_t(lroundf(top + area_height + 1));
+                auto left = int32_t(lroundf(p1.x));
+                auto right = int32_t(lroundf(left + area_width + 1));
+
+                std::vector<PutSpan> spans;
+                for (auto y = std::max(top, 0); y < std::min(bottom, int32_t(height)); ++y) {
+                    _push_span(spans, width, height, left, right, y, 0xff);
+                }
+                return spans;
             }
 
             /**
@@ -320,7 +444,136 @@ namespace seeta {
             };
 
 
-            static inline std::vector<PutSetting> _prepare_line(
+            static inline std::vector<PutSpan> _prepare_fill_circle(
+                    uint32_t width, uint32_t height,
+                    const SeetaAIPPoint &center, int radius) {
+                if (radius < 0) return {};
+                // get int area: [top, bottom) x [left, right)
+                auto top = int32_t(floorf(center.y - radius));
+                auto bottom = int32_t(ceilf(center.y + radius + 1));
+                auto left = int32_t(floorf(center.x - radius));
+                auto right = int32_t(ceilf(center.x + radius + 1));
+
+                std::vector<PutSpan> spans;
+                std::vector<std::pair<int32_t, int32_t>> windows;
+                for (auto y = std::max(top, 0); y < std::min(bottom, int32_t(height)); ++y) {
+                    // partly covered where radius - 0.5 < d < radius + 0.5
+                    windows.clear();
+                    _radial_windows(windows, center, float(y), radius - 0.5f, radius + 0.5f);
+                    _scan_row(spans, width, height, y, left, right, windows, [&](int32_t x) {
+                        auto d = _distance(center, {float(x), float(y)});
+                        return _coverage(radius + 0.5f - d);
+                    });
+                }
+                return spans;
+            }
+
+            static inline std::vector<PutSpan> _prepare_circle(
+                    uint32_t width, uint32_t height,
+                    const SeetaAIPPoint &center, int radius,
+                    int line_width) {
+                // check plot area
+                if (line_width <= 0 || radius < 0) return {};
+                auto half = float(line_width) / 2;
+                // get int area: [top, bottom) x [left, right)
+                auto top = int32_t(floorf(center.y - radius - half));
+                auto bottom = int32_t(ceilf(center.y + radius + half + 1));
+                auto left = int32_t(floorf(center.x - radius - half));
+                auto right = int32_t(ceilf(center.x + radius + half + 1));
+
+                auto inner = radius - half - 0.5f;
+                auto outer = radius + half + 0.5f;
+                std::vector<PutSpan> spans;
+                std::vector<std::pair<int32_t, int32_t>> windows;
+                for (auto y = std::max(top, 0); y < std::min(bottom, int32_t(height)); ++y) {
+                    // partly covered in 1 pixel inside both edges of ring
+                    windows.clear();
+                    _radial_windows(windows, center, float(y), inner, inner + 1);
+                    _radial_windows(windows, center, float(y), outer - 1, outer);
+                    _scan_row(spans, width, height, y, left, right, windows, [&](int32_t x) {
+                        auto d = _distance(center, {float(x), float(y)});
+                        return _coverage(std::min(outer - d, d - inner));
+                    });
+                }
+                return spans;
+            }
+
+            /**
+             * Segment a-b with precomputed direction, used to rasterize line with round caps.
+             */
+            class _Segment {
+            public:
+                _Segment(const SeetaAIPPoint &a, const SeetaAIPPoint &b)
+                        : a(a), b(b) {
+                    length = _distance(a, b);
+                    ux = (b.x - a.x) / length;
+                    uy = (b.y - a.y) / length;
+                    inv_ux = Line::near_zero(ux) ? 0 : 1 / ux;
+                    inv_uy = Line::near_zero(uy) ? 0 : 1 / uy;
+                }
+
+                /**
+                 * distance of point to segment, perpendicular distance between ends
+                 */
+                float distance(float x, float y) const {
+                    auto s = (x - a.x) * ux + (y - a.y) * uy;
+                    if (s <= 0) return _distance({x, y}, a);
+                    if (s >= length) return _distance({x, y}, b);
+                    return std::fabs((y - a.y) * ux - (x - a.x) * uy);
+                }
+
+                /**
+                 * Get [x0, x1] of row y with points within r of segment.
+                 * @return false if row not crossing
+                 */
+                bool row(float r, float y, float &x0, float &x1) const {
+                    if (r <= 0) return false;
+                    x0 = FLT_MAX;
+                    x1 = -FLT_MAX;
+                    for (auto &p : {a, b}) {
+                        auto dx2 = _pow2(r) - _pow2(y - p.y);
+                        if (dx2 < 0) continue;
+                        auto dx = sqrtf(dx2);
+                        x0 = std::min(x0, p.x - dx);
+                        x1 = std::max(x1, p.x + dx);
+                    }
+                    // band between ends: 0 <= u * (p - a) <= length, -r <= n * (p - a) <= r
+                    auto s0 = -FLT_MAX, s1 = FLT_MAX;
+                    clip(inv_ux, uy * (y - a.y) - ux * a.x, 0, length, s0, s1);
+                    clip(-inv_uy, ux * (y - a.y) + uy * a.x, -r, r, s0, s1);
+                    if (s0 <= s1) {
+                        x0 = std::min(x0, s0);
+                        x1 = std::max(x1, s1);
+                    }
+                    return x0 <= x1;
+                }
+
+            private:
+                /**
+                 * Clip [x0, x1] by lo <= x / inv_k + m <= hi, inv_k is 0 if k is 0.
+                 */
+                static void clip(float inv_k, float m, float lo, float hi, float &x0, float &x1) {
+                    if (inv_k == 0) {
+                        if (m < lo || m > hi) x1 = -FLT_MAX;
+                        return;
+                    }
+                    auto p = (lo - m) * inv_k;
+                    auto q = (hi - m) * inv_k;
+                    if (p > q) std::swap(p, q);
+                    x0 = std::max(x0, p);
+                    x1 = std::min(x1, q);
+                }
+
+                SeetaAIPPoint a;
+                SeetaAIPPoint b;
+                float length;
+                float ux;
+                float uy;
+                float inv_ux;
+                float inv_uy;
+            };
+
+            static inline std::vector<PutSpan> _prepare_line(
                     uint32_t width, uint32_t height,
                     const SeetaAIPPoint &p1, const SeetaAIPPoint &p2,
                     int line_width) {
@@ -329,94 +582,31 @@ namespace seeta {
                 }
                 // check plot area
                 if (line_width <= 0) return {};
-                // make point left2right
-                float min_x = std::min(p1.x, p2.x);
-                float max_x = std::max(p1.x, p2.x);
-                float min_y = std::min(p1.y, p2.y);
-                float max_y = std::max(p1.y, p2.y);
-
-                auto area_width = max_x - min_x;
-                auto area_height = max_y - min_y;
                 auto half = float(line_width) / 2;
-                // get int area: [top, bottom) x [left, right)
-                auto top = int32_t(floorf(min_y - half));
-                auto bottom = int32_t(ceilf(max_y + half + 1));
-                auto left = int32_t(floorf(min_x - half));
-                auto right = int32_t(ceilf(max_x + half + 1));
-
-                // check all pixel in graph
-                if (top < 0) top = 0;
-                if (bottom > int32_t(height)) bottom = height;
-                if (left < 0) left = 0;
-                if (right > int32_t(width)) right = width;
-
-                Line line(p1, p2);
-
-                std::vector<PutSetting> setting;
-                if (area_height > area_width) {
-                    // H scan
-                    float scan_width = (line_width + 1) / (cosf(atanf(fabsf(line.b / line.a))));
-                    SeetaAIPPoint s1 = p1, s2 = p2;
-                    if (s2.y < s1.y) std::swap(s1, s2);
-                    for (decltype(top) y = top; y < bottom; ++y) {
-                        auto center_x = line.get_x(float(y));
-                        auto scan_left = int32_t(floorf(center_x - scan_width / 2));
-                        auto scan_right = int32_t(ceilf(center_x + scan_width / 2 + 1));
-                        if (scan_left < 0) scan_left = 0;
-                        if (scan_right > int32_t(width)) scan_right = width;
-                        for (decltype(scan_left) x = scan_left; x < scan_right; ++x) {
-                            SeetaAIPPoint fp = {float(x), float(y)};
-                            float d = 0;
-                            auto proj = line.projection(fp);
-                            if (proj.y < s1.y) {
-                                d = _distance(fp, s1);
-                            } else if (proj.y > s2.y) {
-                                d = _distance(fp, s2);
-                            } else {
-                                d = _distance(fp, proj);
-                            }
-                            auto part = half + 0.5f - d;
-                            if (part <= 0) continue;
-                            if (part >= 1) {
-                                setting.emplace_back(PutSetting({x, y, 0xff}));
-                            } else {
-                                setting.emplace_back(PutSetting({x, y, int32_t(part * 255)}));
-                            }
-                        }
-                    }
-                } else {
-                    // V scan
-                    float scan_width = (line_width + 1) / (cosf(atanf(fabsf(line.a / line.b))));
-                    SeetaAIPPoint s1 = p1, s2 = p2;
-                    if (s2.x < s1.x) std::swap(s1, s2);
-                    for (decltype(left) x = left; x < right; ++x) {
-                        auto center_y = line.get_y(float(x));
-                        auto scan_top = int32_t(floorf(center_y - scan_width / 2));
-                        auto scan_bottom = int32_t(ceilf(center_y + scan_width / 2 + 1));
-                        if (scan_top < 0) scan_top = 0;
-                        if (scan_bottom > int32_t(height)) scan_bottom = height;
-                        for (decltype(scan_top) y = scan_top; y < scan_bottom; ++y) {
-                            SeetaAIPPoint fp = {float(x), float(y)};
-                            float d = 0;
-                            auto proj = line.projection(fp);
-                            if (proj.x < s1.x) {
-                                d = _distance(fp, s1);
-                            } else if (proj.x > s2.x) {
-                                d = _distance(fp, s2);
-                            } else {
-                                d = _distance(fp, proj);
-                            }
-                            auto part = half + 0.5f - d;
-                            if (part <= 0) continue;
-                            if (part >= 1) {
-                                setting.emplace_back(PutSetting({x, y, 0xff}));
-                            } else {
-                                setting.emplace_back(PutSetting({x, y, int32_t(part * 255)}));
-                            }
-                        }
+                auto top = int32_t(floorf(std::min(p1.y, p2.y) - half - 1));
+                auto bottom = int32_t(ceilf(std::max(p1.y, p2.y) + half + 2));
+
+                // each row crosses line with round caps once, partly covered where half - 0.5 < d < half + 0.5
+                _Segment segment(p1, p2);
+                std::vector<PutSpan> spans;
+                std::vector<std::pair<int32_t, int32_t>> windows;
+                for (auto y = std::max(top, 0); y < std::min(bottom, int32_t(height)); ++y) {
+                    float outer0, outer1, inner0, inner1;
+                    if (!segment.row(half + 0.5f, float(y), outer0, outer1)) continue;
+                    windows.clear();
+                    if (segment.row(half - 0.5f, float(y), inner0, inner1)) {
+                        _window(windows, outer0, inner0);
+                        _window(windows, inner1, outer1);
+                    } else {
+                        _window(windows, outer0, outer1);
                     }
+                    auto left = windows.front().first;
+                    auto right = windows.back().second;
+                    _scan_row(spans, width, height, y, left, right, windows, [&](int32_t x) {
+                        return _coverage(half + 0.5f - segment.distance(float(x), float(y)));
+                    });
                 }
-                return setting;
+                return spans;
             }
 
             template<size_t Channels>
@@ -426,6 +616,13 @@ namespace seeta {
                 };
                 auto from = reinterpret_cast<const C *>(color);
                 auto to = reinterpret_cast<C *>(data);
+                auto kernels = simd::blend_kernels();
+                if (kernels && count <= uint32_t(INT32_MAX)) {
+                    auto done = kernels->fill[Channels](reinterpret_cast<uint8_t *>(data), int32_t(count),
+                                                        reinterpret_cast<const uint8_t *>(color));
+                    to += done;
+                    count -= done;
+                }
                 for (decltype(count) i = 0; i < count; ++i) {
                     *to++ = *from;
                 }
@@ -433,10 +630,10 @@ namespace seeta {
 
             /**
              *
-             * @param image BYTE type HWC format image.
+             * @param image BYTE type HWC format image, could be strided view.
              * @param color color according to image format
              */
-            static void fill(SeetaAIPImageData image, const Color &color) {
+            static void fill(ImageView image, const Color &color) {
                 auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
                 auto type = ImageData::GetType(format);
                 auto channels = ImageData::GetChannels(format, image.channels);
@@ -449,32 +646,41 @@ namespace seeta {
                             std::string("AIP image plot only support BYTE type, got ") + type_string(format));
                 }
                 image.channels = channels;  // fix channels if not mismatched.
-                auto count = image.number * image.height * image.width;
-                switch (image.channels) {
-                    case 4:
-                        _fill<4>(image.data, count, &color);
-                        break;
-                    case 3:
-                        _fill<3>(image.data, count, &color);
-                        break;
-                    case 2:
-                        _fill<2>(image.data, count, &color);
-                        break;
-                    case 1:
-                        _fill<1>(image.data, count, &color);
-                        break;
+                auto packed = ImageData::IsPacked(image);
+                // fill whole image once if packed, or fill each row
+                auto count = packed ? image.number * image.height * image.width : image.width;
+                auto rows = packed ? 1 : image.number * image.height;
+                auto row_stride = ImageData::GetRowStride(image);
+                auto image_stride = ImageData::GetImageStride(image);
+                for (decltype(rows) i = 0; i < rows; ++i) {
+                    auto data = reinterpret_cast<uint8_t *>(image.data)
+                            + size_t(i / image.height) * image_stride + size_t(i % image.height) * row_stride;
+                    switch (image.channels) {
+                        case 4:
+                            _fill<4>(data, count, &color);
+                            break;
+                        case 3:
+                            _fill<3>(data, count, &color);
+                            break;
+                        case 2:
+                            _fill<2>(data, count, &color);
+                            break;
+                        case 1:
+                            _fill<1>(data, count, &color);
+                            break;
+                    }
                 }
             }
 
             /**
              *
-             * @param image BYTE type HWC format image.
+             * @param image BYTE type HWC format image, could be strided view.
              * @param p1 top-left point
              * @param p2 right-bottom point
              * @param color color according to image format
              * @param line_width line with, -1 (or negative value) for fill.
              */
-            static void rectangle(SeetaAIPImageData image,
+            static void rectangle(ImageView image,
                                   const SeetaAIPPoint &p1, const SeetaAIPPoint &p2,
                                   const Color &color, int line_width = 3) {
                 auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
@@ -489,28 +695,22 @@ namespace seeta {
                             std::string("AIP image plot only support BYTE type, got ") + type_string(format));
                 }
                 image.channels = channels;  // fix channels if not mismatched.
-                // compute all pixel to draw
-                auto setting = line_width < 0
-                               ? _prepare_fill_rectangle_solid(image.width, image.height, p1, p2)
-                               : _prepare_rectangle_solid(image.width, image.height, p1, p2, line_width);
-                // plot each point
-                auto c = color;
-                // auto alpha = c.c4;
-                for (auto &p : setting) {
-                    // c.c4 = 255 - uint8_t(((255 - alpha) * (255 - p.alpha)) / 255);
-                    put_uint8_pixel(image, p.x, p.y, c);
-                }
+                // compute all spans to draw
+                auto spans = line_width < 0
+                             ? _prepare_fill_rectangle_solid(image.width, image.height, p1, p2)
+                             : _prepare_rectangle_solid(image.width, image.height, p1, p2, line_width);
+                put_uint8_spans(image, spans, color);
             }
 
             /**
              *
-             * @param image BYTE type HWC format image.
+             * @param image BYTE type HWC format image, could be strided view.
              * @param center
              * @param radius
              * @param color color according to image format
              * @param line_width line with, -1 (or negative value) for fill.
              */
-            static void circle(SeetaAIPImageData image,
+            static void circle(ImageView image,
                                const SeetaAIPPoint &center, int radius,
                                const Color &color, int line_width = 3) {
                 auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
@@ -525,28 +725,22 @@ namespace seeta {
                             std::string("AIP image plot only support BYTE type, got ") + type_string(format));
                 }
                 image.channels = channels;  // fix channels if not mismatched.
-                // compute all pixel to draw
-                auto setting = line_width < 0
-                               ? _prepare_fill_circle(image.width, image.height, center, radius)
-                               : _prepare_circle(image.width, image.height, center, radius, line_width);
-                // plot each point
-                auto c = color;
-                auto alpha = c.c4;
-                for (auto &p : setting) {
-                    c.c4 = alpha * p.alpha / 255;
-                    put_uint8_pixel(image, p.x, p.y, c);
-                }
+                // compute all spans to draw
+                auto spans = line_width < 0
+                             ? _prepare_fill_circle(image.width, image.height, center, radius)
+                             : _prepare_circle(image.width, image.height, center, radius, line_width);
+                put_uint8_spans(image, spans, color);
             }
 
             /**
              *
-             * @param image BYTE type HWC format image.
+             * @param image BYTE type HWC format image, could be strided view.
              * @param p1 start point
              * @param p2 end point
              * @param color color according to image format
              * @param line_width line with, -1 (or negative value) for fill.
              */
-            static void line(SeetaAIPImageData image,
+            static void line(ImageView image,
                              const SeetaAIPPoint &p1, const SeetaAIPPoint &p2,
                              const Color &color, int line_width = 3) {
                 auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
@@ -561,15 +755,9 @@ namespace seeta {
                             std::string("AIP image plot only support BYTE type, got ") + type_string(format));
                 }
                 image.channels = channels;  // fix channels if not mismatched.
-                // compute all pixel to draw
-                auto setting = _prepare_line(image.width, image.height, p1, p2, line_width);
-                // plot each point
-                auto c = color;
-                auto alpha = c.c4;
-                for (auto &p : setting) {
-                    c.c4 = alpha * p.alpha / 255;
-                    put_uint8_pixel(image, p.x, p.y, c);
-                }
+                // compute all spans to draw
+                auto spans = _prepare_line(image.width, image.height, p1, p2, line_width);
+                put_uint8_spans(image, spans, color);
             }
 
             inline SeetaAIPPoint rotate_point(const SeetaAIPPoint &c,
@@ -584,14 +772,14 @@ namespace seeta {
 
             /**
              *
-             * @param image BYTE type HWC format image.
+             * @param image BYTE type HWC format image, could be strided view.
              * @param p1 top-left point
              * @param p2 right-bottom point
              * @param color color according to image format
              * @param rotate rotate angle around center anti-clockwise
              * @param line_width line with, -1 (or negative value) for fill.
              */
-            static void rectangle_rotate(SeetaAIPImageData image,
+            static void rectangle_rotate(ImageView image,
                                          const SeetaAIPPoint &p1, const SeetaAIPPoint &p2,
                                          const Color &color, float angle, int line_width = 3) {
                 if (fabs(angle) < FLT_EPSILON) {
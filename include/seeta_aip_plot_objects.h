@@ -0,0 +1,339 @@
+#ifndef SEETA_AIP_SEETA_AIP_PLOT_OBJECTS_H
+#define SEETA_AIP_SEETA_AIP_PLOT_OBJECTS_H
+
+#include "seeta_aip_plot.h"
+#include "seeta_aip_plot_text.h"
+#include "seeta_aip_color_map.h"
+#include "seeta_aip_executor.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <cstdio>
+
+namespace seeta {
+    namespace aip {
+        namespace plot {
+            /**
+             * Get readable tag of label, like Instance::tag with method_id bound.
+             * Return empty string to draw label value as number.
+             */
+            using TagResolver = std::function<std::string(uint32_t label_index, int32_t label_value)>;
+
+            class ObjectStyle {
+            public:
+                int line_width = 3;             ///< line width of shapes, must be positive
+                int point_radius = 2;           ///< radius of each point of SEETA_AIP_POINTS
+                float font_scale = 1.0f;        ///< label font scale based on 8x16 font, 0 for no label
+                bool score = false;             ///< append score after each tag of label
+                bool color_by_label = true;     ///< use rcolor(label) of first tag, or `color`
+                Color color = Color(0x00FF00);  ///< color of objects without tag, or all objects if not by label
+                uint8_t alpha = 0xff;           ///< alpha of all colors
+            };
+
+            /**
+             * Spans to be blended with one color, blended one after another in order.
+             */
+            class _Layer {
+            public:
+                std::vector<PutSpan> spans;
+                Color color;
+            };
+
+            /**
+             * Polyline of points, each segment is one layer, same as calling line for each segment.
+             */
+            static inline void _prepare_polyline(std::vector<_Layer> &layers, uint32_t width, uint32_t height,
+                                                 const SeetaAIPPoint *points, uint32_t size, bool closed,
+                                                 const Color &color, int line_width) {
+                if (size < 2) return;
+                auto segments = closed && size > 2 ? size : size - 1;
+                for (uint32_t i = 0; i < segments; ++i) {
+                    layers.push_back({_prepare_line(width, height, points[i], points[(i + 1) % size], line_width),
+                                      color});
+                }
+            }
+
+            /**
+             * Layers of shape, same as drawing shape with rectangle_rotate, line and circle.
+             */
+            static inline std::vector<_Layer> _prepare_shape(uint32_t width, uint32_t height,
+                                                             const SeetaAIPShape &shape,
+                                                             const Color &color, const ObjectStyle &style) {
+                std::vector<_Layer> layers;
+                auto points = shape.landmarks.data;
+                auto size = points ? shape.landmarks.size : 0;
+                auto line_width = style.line_width;
+                switch (shape.type) {
+                    default:
+                        break;
+                    case SEETA_AIP_POINTS:
+                        for (uint32_t i = 0; i < size; ++i) {
+                            layers.push_back({_prepare_fill_circle(width, height, points[i], style.point_radius),
+                                              color});
+                        }
+                        break;
+                    case SEETA_AIP_LINES:
+                        _prepare_polyline(layers, width, height, points, size, false, color, line_width);
+                        break;
+                    case SEETA_AIP_RECTANGLE: {
+                        if (size < 2) break;
+                        auto &p1 = points[0];
+                        auto &p2 = points[1];
+                        if (fabs(shape.rotate) < FLT_EPSILON) {
+                            layers.push_back({_prepare_rectangle_solid(width, height, p1, p2, line_width), color});
+                            break;
+                        }
+                        SeetaAIPPoint center = {p1.x + (p2.x - p1.x) / 2, p1.y + (p2.y - p1.y) / 2};
+                        SeetaAIPPoint corners[] = {
+                                rotate_point(center, shape.rotate, p1),
+                                rotate_point(center, shape.rotate, {p2.x, p1.y}),
+                                rotate_point(center, shape.rotate, p2),
+                                rotate_point(center, shape.rotate, {p1.x, p2.y}),
+                        };
+                        _prepare_polyline(layers, width, height, corners, 4, true, color, line_width);
+                        break;
+                    }
+                    case SEETA_AIP_PARALLELOGRAM: {
+                        if (size < 3) break;
+                        SeetaAIPPoint corners[] = {
+                                points[0], points[1], points[2],
+                                {points[0].x + points[2].x - points[1].x, points[0].y + points[2].y - points[1].y},
+                        };
+                        _prepare_polyline(layers, width, height, corners, 4, true, color, line_width);
+                        break;
+                    }
+                    case SEETA_AIP_POLYGON:
+                        _prepare_polyline(layers, width, height, points, size, true, color, line_width);
+                        break;
+                    case SEETA_AIP_CIRCLE:
+                        if (size < 1) break;
+                        layers.push_back({_prepare_circle(width, height, points[0], int(lroundf(shape.scale)),
+                                                          line_width), color});
+                        break;
+                    case SEETA_AIP_CUBE: {
+                        if (size < 3) break;
+                        // front face from diagonal, back face shifted by right-top edge
+                        auto &p0 = points[0];
+                        auto &p1 = points[1];
+                        auto dx = points[2].x - p1.x;
+                        auto dy = points[2].y - p0.y;
+                        SeetaAIPPoint front[] = {{p0.x, p0.y}, {p1.x, p0.y}, {p1.x, p1.y}, {p0.x, p1.y}};
+                        SeetaAIPPoint back[4];
+                        for (int i = 0; i < 4; ++i) back[i] = {front[i].x + dx, front[i].y + dy};
+                        _prepare_polyline(layers, width, height, back, 4, true, color, line_width);
+                        for (int i = 0; i < 4; ++i) {
+                            SeetaAIPPoint edge[] = {front[i], back[i]};
+                            _prepare_polyline(layers, width, height, edge, 2, false, color, line_width);
+                        }
+                        _prepare_polyline(layers, width, height, front, 4, true, color, line_width);
+                        break;
+                    }
+                }
+                return layers;
+            }
+
+            /**
+             * Top-left of shape bounding box, where label is put.
+             * @return false if shape has no point
+             */
+            static inline bool _shape_anchor(const SeetaAIPShape &shape, SeetaAIPPoint &anchor) {
+                auto points = shape.landmarks.data;
+                auto size = points ? shape.landmarks.size : 0;
+                if (size == 0 || shape.type == SEETA_AIP_UNKNOWN_SHAPE || shape.type == SEETA_AIP_NO_SHAPE) {
+                    return false;
+                }
+                if (shape.type == SEETA_AIP_CIRCLE) {
+                    anchor = {points[0].x - shape.scale, points[0].y - shape.scale};
+                    return true;
+                }
+                anchor = points[0];
+                for (uint32_t i = 1; i < size; ++i) {
+                    anchor.x = std::min(anchor.x, points[i].x);
+                    anchor.y = std::min(anchor.y, points[i].y);
+                }
+                return true;
+            }
+
+            /**
+             * Draw objects of forward result, with labels, onto batch of images.
+             * Tags and colors are resolved once, all shapes and labels are rasterized into spans in parallel,
+             * then blended in horizontal bands in parallel with objects in order,
+             * so result is same as drawing objects one by one with rectangle_rotate, line, circle and text.
+             * @param threads executor running kernels, or number of threads
+             * @param image BYTE type HWC format images, could be strided view.
+             * @param objects objects of all images, objects of image i follow objects of image i - 1
+             * @param sizes `image.number` sizes, number of objects of each image
+             * @param resolver readable tag of label, could be empty
+             * @param style
+             * @note not overload of draw_objects, as `sizes` and `size` would be ambiguous with literal 0
+             */
+            static void draw_objects_batch(const Executor &threads, ImageView image,
+                                           const SeetaAIPObject *objects, const uint32_t *sizes,
+                                           const TagResolver &resolver = nullptr,
+                                           const ObjectStyle &style = ObjectStyle()) {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                auto type = ImageData::GetType(format);
+                auto channels = ImageData::GetChannels(format, image.channels);
+                if ((format & 0xffff0000) == 0x80000) {
+                    throw Exception(
+                            std::string("AIP image plot only support HWC format, got ") + format_string(format));
+                }
+                if (type != SEETA_AIP_VALUE_BYTE) {
+                    throw Exception(
+                            std::string("AIP image plot only support BYTE type, got ") + type_string(format));
+                }
+                if (style.line_width <= 0) {
+                    throw Exception(
+                            std::string("AIP image plot objects only support positive line width, got ")
+                            + std::to_string(style.line_width));
+                }
+                image.channels = channels;  // fix channels if not mismatched.
+                if (image.number == 0 || image.width == 0 || image.height == 0) return;
+
+                std::vector<uint32_t> owner;    // image index of each object
+                for (uint32_t n = 0; n < image.number; ++n) owner.insert(owner.end(), sizes[n], n);
+                auto count = int32_t(owner.size());
+
+                // resolve tags and colors once, resolver may not be thread safe
+                std::map<std::pair<uint32_t, int32_t>, std::string> tags;
+                std::map<int32_t, Color> colors;
+                std::vector<Color> object_colors(count);
+                std::vector<std::string> labels(count);
+                for (int32_t i = 0; i < count; ++i) {
+                    auto &object = objects[i];
+                    auto object_tags = object.tags.data ? object.tags.size : 0;
+                    auto color = style.color;
+                    if (style.color_by_label && object_tags > 0) {
+                        auto label = object.tags.data[0].label;
+                        auto it = colors.find(label);
+                        if (it == colors.end()) it = colors.insert(std::make_pair(label, rcolor(label))).first;
+                        color = it->second;
+                    }
+                    object_colors[i] = Color(color, style.alpha);
+                    if (style.font_scale <= 0) continue;
+                    std::string label;
+                    for (uint32_t t = 0; t < object_tags; ++t) {
+                        auto &tag = object.tags.data[t];
+                        auto key = std::make_pair(t, tag.label);
+                        auto it = tags.find(key);
+                        if (it == tags.end()) {
+                            auto name = resolver ? resolver(t, tag.label) : std::string();
+                            if (name.empty()) name = std::to_string(tag.label);
+                            it = tags.insert(std::make_pair(key, name)).first;
+                        }
+                        if (!label.empty()) label += " ";
+                        label += it->second;
+                        if (style.score) {
+                            char buffer[32];
+                            std::snprintf(buffer, sizeof(buffer), ":%.2f", tag.score);
+                            label += buffer;
+                        }
+                    }
+                    labels[i] = std::move(label);
+                }
+
+                // rasterize each object once
+                std::vector<std::vector<_Layer>> layers(count);
+                parallel_for(threads, 0, count, [&](int32_t i) {
+                    auto &shape = objects[i].shape;
+                    auto &color = object_colors[i];
+                    layers[i] = _prepare_shape(image.width, image.height, shape, color, style);
+                    SeetaAIPPoint anchor;
+                    if (labels[i].empty() || !_shape_anchor(shape, anchor)) return;
+                    // above shape, or inside if no room
+                    auto text_height = float(LetterFont::Height() + 1) * style.font_scale;
+                    if (anchor.y >= text_height) anchor.y -= text_height;
+                    _Layer label = {{}, color};
+                    _prepare_text(label.spans, image.width, image.height, labels[i], anchor, style.font_scale);
+                    // letters are put one by one, spans must be ordered by row for bands
+                    std::stable_sort(label.spans.begin(), label.spans.end(), [](const PutSpan &a, const PutSpan &b) {
+                        return a.y < b.y;
+                    });
+                    layers[i].push_back(std::move(label));
+                });
+
+                std::vector<int32_t> first(image.number + 1, 0);  // first object of each image
+                for (uint32_t n = 0; n < image.number; ++n) first[n + 1] = first[n] + int32_t(sizes[n]);
+
+                // each band blends all layers in order on its own rows
+                auto height = int32_t(image.height);
+                auto bands = std::max(1, std::min(height, threads.size() * 4));
+                auto band_rows = (height + bands - 1) / bands;
+                bands = (height + band_rows - 1) / band_rows;
+                auto image_stride = ImageData::GetImageStride(image);
+                parallel_for(threads, 0, int32_t(image.number) * bands, [&](int32_t task) {
+                    auto n = task / bands;
+                    auto top = task % bands * band_rows;
+                    auto bottom = std::min(top + band_rows, height);
+                    auto view = image;
+                    view.number = 1;
+                    view.data = reinterpret_cast<uint8_t *>(image.data) + size_t(n) * image_stride;
+                    auto less = [](const PutSpan &span, int32_t y) { return span.y < y; };
+                    for (auto i = first[n]; i < first[n + 1]; ++i) {
+                        for (auto &layer : layers[i]) {
+                            auto &spans = layer.spans;
+                            auto begin = std::lower_bound(spans.begin(), spans.end(), top, less);
+                            auto end = std::lower_bound(begin, spans.end(), bottom, less);
+                            if (begin == end) continue;
+                            switch (view.channels) {
+                                case 4: _blend_spans<4>(view, &*begin, end - begin, layer.color); break;
+                                case 3: _blend_spans<3>(view, &*begin, end - begin, layer.color); break;
+                                case 2: _blend_spans<2>(view, &*begin, end - begin, layer.color); break;
+                                case 1: _blend_spans<1>(view, &*begin, end - begin, layer.color); break;
+                                default: break;
+                            }
+                        }
+                    }
+                });
+            }
+
+            /**
+             * Draw objects onto single image.
+             * @param threads executor running kernels, or number of threads
+             * @param image BYTE type HWC format image, could be strided view.
+             * @param objects objects, like objects of Instance::Result
+             * @param size number of objects
+             * @param resolver readable tag of label, could be empty
+             * @param style
+             */
+            static void draw_objects(const Executor &threads, ImageView image,
+                                     const SeetaAIPObject *objects, uint32_t size,
+                                     const TagResolver &resolver = nullptr,
+                                     const ObjectStyle &style = ObjectStyle()) {
+                if (image.number != 1) {
+                    throw Exception(std::string("AIP image plot objects need sizes of each image, got ")
+                                    + std::to_string(image.number) + " images");
+                }
+                draw_objects_batch(threads, image, objects, &size, resolver, style);
+            }
+
+            /**
+             * Draw objects onto batch of images.
+             * @param threads executor running kernels, or number of threads
+             * @param image BYTE type HWC format images, could be strided view.
+             * @param objects `image.number` lists, objects of each image
+             * @param resolver readable tag of label, could be empty
+             * @param style
+             */
+            static void draw_objects(const Executor &threads, ImageView image,
+                                     const std::vector<std::vector<SeetaAIPObject>> &objects,
+                                     const TagResolver &resolver = nullptr,
+                                     const ObjectStyle &style = ObjectStyle()) {
+                if (objects.size() != image.number) {
+                    throw Exception(std::string("AIP image plot objects got ") + std::to_string(objects.size())
+                                    + " lists for " + std::to_string(image.number) + " images");
+                }
+                std::vector<SeetaAIPObject> all;
+                std::vector<uint32_t> sizes;
+                for (auto &list : objects) {
+                    all.insert(all.end(), list.begin(), list.end());
+                    sizes.push_back(uint32_t(list.size()));
+                }
+                draw_objects_batch(threads, image, all.data(), sizes.data(), resolver, style);
+            }
+        }
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_PLOT_OBJECTS_H
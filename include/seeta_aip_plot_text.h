@@ -9,6 +9,9 @@
 #include "seeta_aip_font_ascii.h"
 
 #include <map>
+#include <list>
+#include <memory>
+#include <mutex>
 
 namespace seeta {
     namespace aip {
@@ -142,22 +145,140 @@ namespace seeta {
                 return _prepare_ascii(width, height, font, p, scale);
             }
 
-            static void put_uint8_ascii(SeetaAIPImageData image,
+            /**
+             * Coverage mask of letter, spans relative to top-left pixel `(floor(x), floor(y))` of letter origin.
+             */
+            class Glyph {
+            public:
+                std::vector<PutSpan> spans;
+            };
+
+            /**
+             * Process-wide cache of letter masks, keyed by letter and scale.
+             * Letter origin is snapped to 1/Subpixel() pixel, each key holds masks of those sub-pixel offsets,
+             * built by `_prepare_ascii` once, so blitting them is same as sampling font at snapped origin.
+             * Least recently used key is dropped when full.
+             * Thread safe, got glyphs stay valid after they are dropped from the atlas.
+             */
+            class GlyphAtlas {
+            public:
+                using self = GlyphAtlas;
+
+                /**
+                 * @param capacity most (letter, scale) keys kept
+                 */
+                explicit GlyphAtlas(size_t capacity = 1024)
+                        : m_capacity(capacity) {}
+
+                static self &Global() {
+                    static self atlas;
+                    return atlas;
+                }
+
+                /**
+                 * Letter origin is rounded to multiple of 1 / Subpixel() pixel.
+                 */
+                static constexpr int32_t Subpixel() { return 4; }
+
+                /**
+                 * @param left_top letter origin
+                 * @return origin where glyph is put, nearest point on 1 / Subpixel() pixel grid
+                 */
+                static SeetaAIPPoint Snap(const SeetaAIPPoint &left_top) {
+                    auto grid = float(Subpixel());
+                    return {floorf(left_top.x * grid + 0.5f) / grid, floorf(left_top.y * grid + 0.5f) / grid};
+                }
+
+                /**
+                 * @param ch ascii letter
+                 * @param left_top letter origin, only fraction part of snapped origin is used
+                 * @param scale font scale, at least 1
+                 * @return nullptr if ch is not ascii
+                 */
+                std::shared_ptr<const Glyph> get(int ch, const SeetaAIPPoint &left_top, float scale) {
+                    if (ch & 0xffffff00) return nullptr;
+                    auto origin = Snap(left_top);
+                    SeetaAIPPoint offset = {origin.x - floorf(origin.x), origin.y - floorf(origin.y)};
+                    auto slot = int32_t(offset.y * Subpixel()) * Subpixel() + int32_t(offset.x * Subpixel());
+                    auto key = std::make_pair(ch, scale);
+                    std::unique_lock<std::mutex> _locker(m_mutex);
+                    auto it = m_glyphs.find(key);
+                    if (it != m_glyphs.end()) {
+                        m_order.splice(m_order.begin(), m_order, it->second.order);
+                        if (it->second.glyphs[slot]) return it->second.glyphs[slot];
+                    }
+                    _locker.unlock();
+
+                    std::shared_ptr<Glyph> glyph(new Glyph);
+                    LetterFont font(ch);
+                    for (auto &p : _prepare_ascii(INT32_MAX, INT32_MAX, font, offset, scale)) {
+                        _push_span(glyph->spans, INT32_MAX, INT32_MAX, p.x, p.x + 1, p.y, p.alpha);
+                    }
+
+                    _locker.lock();
+                    // other thread may have added or dropped the key meanwhile
+                    it = m_glyphs.find(key);
+                    if (it == m_glyphs.end()) {
+                        while (!m_order.empty() && m_glyphs.size() >= m_capacity) {
+                            m_glyphs.erase(m_order.back());
+                            m_order.pop_back();
+                        }
+                        m_order.push_front(key);
+                        it = m_glyphs.insert(std::make_pair(key, Entry())).first;
+                        it->second.order = m_order.begin();
+                    } else {
+                        m_order.splice(m_order.begin(), m_order, it->second.order);
+                    }
+                    auto &cached = it->second.glyphs[slot];
+                    if (!cached) cached = glyph;
+                    return cached;
+                }
+
+                void clear() {
+                    std::unique_lock<std::mutex> _locker(m_mutex);
+                    m_glyphs.clear();
+                    m_order.clear();
+                }
+
+            private:
+                using Key = std::pair<int, float>;
+
+                struct Entry {
+                    Entry() : glyphs(Subpixel() * Subpixel()) {}
+
+                    std::vector<std::shared_ptr<const Glyph>> glyphs;   ///< one for each sub-pixel offset
+                    std::list<Key>::iterator order;   ///< position in m_order
+                };
+
+                size_t m_capacity;
+                std::mutex m_mutex;
+                std::map<Key, Entry> m_glyphs;
+                std::list<Key> m_order;     ///< most recently used first
+            };
+
+            /**
+             * Append spans of glyph put at snapped left_top, clipped in image.
+             */
+            static inline void _blit_glyph(std::vector<PutSpan> &spans, uint32_t width, uint32_t height,
+                                           const Glyph &glyph, const SeetaAIPPoint &left_top) {
+                auto origin = GlyphAtlas::Snap(left_top);
+                auto left = int32_t(floorf(origin.x));
+                auto top = int32_t(floorf(origin.y));
+                for (auto &span : glyph.spans) {
+                    _push_span(spans, width, height, left + span.x0, left + span.x1, top + span.y, span.alpha);
+                }
+            }
+
+            static void put_uint8_ascii(ImageView image,
                                         int ch,
                                         const SeetaAIPPoint &left_top, const Color &color,
                                         float font_scale = 1.0f) {
                 if (ch & 0xffffff00) return;
                 if (font_scale < 1.0f) font_scale = 1.0f;
-                auto &font = seeta_aip_font_8x16[ch];
-                std::vector<PutSetting> setting = _prepare_ascii(
-                        image.width, image.height, ch, left_top, font_scale);
-                auto c = color;
-                auto alpha = c.c4;
-                for (auto &p : setting) {
-                    c.c4 = alpha * p.alpha / 255;
-                    put_uint8_pixel(image, p.x, p.y, c);
-                }
-                return;
+                auto glyph = GlyphAtlas::Global().get(ch, left_top, font_scale);
+                std::vector<PutSpan> spans;
+                _blit_glyph(spans, image.width, image.height, *glyph, left_top);
+                put_uint8_spans(image, spans, color);
             }
 
             class TextEditor {
@@ -194,18 +315,28 @@ namespace seeta {
                  * @return NULL if ch is control letter.
                  */
                 LetterFont *type(int ch) {
+                    if (!advance(ch)) return nullptr;
+                    return &font(ch);
+                }
+
+                /**
+                 * Move cursor as type, without building font.
+                 * @param ch
+                 * @return false if ch is control letter.
+                 */
+                bool advance(int ch) {
                     if (ch == '\t') {
                         auto shift = 8 - m_count % 8;
                         m_count += shift;
                         m_cursor_x += float(shift) * float(LetterFont::Width() + 1) * m_scale;
                         try_next_letter_endl();
-                        return nullptr;
+                        return false;
                     }
 
                     if (ch == '\r') {
                         m_cursor_x = float(m_start_x);
                         m_count = 0;
-                        return nullptr;
+                        return false;
                     }
 
                     if (ch == '\n') {
@@ -213,13 +344,13 @@ namespace seeta {
                         m_cursor_x = float(m_start_x);
                         m_count = 0;
                         m_line += 1;
-                        return nullptr;
+                        return false;
                     }
 
                     m_cursor_x += (LetterFont::Width() + 1) * m_scale;
                     try_next_letter_endl();
 
-                    return &font(ch);
+                    return true;
                 }
 
                 int line() const {
@@ -251,17 +382,39 @@ namespace seeta {
                 int m_line = 0;
             };
 
+            /**
+             * Append spans of text letter by letter, same layout as text.
+             * @return text line number
+             */
+            static inline int _prepare_text(std::vector<PutSpan> &spans, uint32_t width, uint32_t height,
+                                            const std::string &msg,
+                                            const SeetaAIPPoint &left_top, float font_scale,
+                                            int endl = -1) {
+                auto &atlas = GlyphAtlas::Global();
+                auto letter_scale = std::max(font_scale, 1.0f);
+                TextEditor editor(left_top.x, left_top.y, font_scale, endl);
+                for (auto &ch : msg) {
+                    auto cursor = editor.cursor();
+                    if (!editor.advance(ch)) continue;
+                    auto glyph = atlas.get(ch, cursor, letter_scale);
+                    if (!glyph) continue;
+                    _blit_glyph(spans, width, height, *glyph, cursor);
+                }
+                return editor.line() + 1;
+            }
+
             /**
              * Put text
-             * @param image BYTE type HWC format image.
+             * @param image BYTE type HWC format image, could be strided view.
              * @param msg ascii message
              * @param left_top message top left message
              * @param color color according to image format
              * @param font_scale based on 8x16 font
              * @param endl end line, -1 for no endl. If set, letter approching endl would start new line.
              * @return put text line number
+             * @note each letter is put at its origin rounded to 1/4 pixel, see GlyphAtlas
              */
-            static int text(SeetaAIPImageData image,
+            static int text(ImageView image,
                             const std::string &msg,
                             const SeetaAIPPoint &left_top, const Color &color,
                             float font_scale = 1.0f,
@@ -279,15 +432,10 @@ namespace seeta {
                 }
                 image.channels = channels;  // fix channels if not mismatched.
 
-                TextEditor editor(left_top.x, left_top.y, font_scale, endl);
-                for (auto &ch : msg) {
-                    auto cursor = editor.cursor();
-                    auto font = editor.type(ch);
-                    if (!font) continue;
-                    put_uint8_ascii(image, ch, cursor, color, font_scale);
-                }
-
-                return editor.line() + 1;
+                std::vector<PutSpan> spans;
+                auto lines = _prepare_text(spans, image.width, image.height, msg, left_top, font_scale, endl);
+                put_uint8_spans(image, spans, color);
+                return lines;
             }
         }
     }
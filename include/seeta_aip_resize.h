@@ -0,0 +1,361 @@
+#ifndef SEETA_AIP_SEETA_AIP_RESIZE_H
+#define SEETA_AIP_SEETA_AIP_RESIZE_H
+
+#include "seeta_aip_struct.h"
+#include "seeta_aip_executor.h"
+#include "seeta_aip_simd.h"
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+#include <type_traits>
+
+namespace seeta {
+    namespace aip {
+        enum ResizeMethod {
+            RESIZE_LINEAR = 0,  ///< bilinear, edge pixels replicated
+            RESIZE_AREA = 1,    ///< average of covered source pixels when downscale, bilinear when upscale
+        };
+
+        namespace _ {
+            /**
+             * Coefficients of resize along one axis, with same number of taps for each output pixel:
+             *     out[i] = sum(in[index[i * taps + k]] * weight[i * taps + k]) for k in [0, taps).
+             * Indices of one output are continuous and never decrease along output, taps is even.
+             */
+            struct ResizeTable {
+                int32_t taps = 0;
+                std::vector<int32_t> index;
+                std::vector<float> weight;
+                std::vector<int16_t> fixed;     ///< weight in 11 bits fixed point, sum of each output is 2048
+            };
+
+            static const int32_t RESIZE_FIXED_BITS = 11;
+
+            /**
+             * Round weights to fixed point, rounding error of each output is added to its largest weight.
+             */
+            static inline void resize_fixed_weights(ResizeTable &table) {
+                auto taps = table.taps;
+                auto count = int32_t(table.weight.size()) / taps;
+                table.fixed.resize(table.weight.size());
+                for (int32_t i = 0; i < count; ++i) {
+                    auto weight = &table.weight[i * taps];
+                    auto fixed = &table.fixed[i * taps];
+                    int32_t sum = 0;
+                    int32_t largest = 0;
+                    for (int32_t k = 0; k < taps; ++k) {
+                        fixed[k] = int16_t(std::lround(weight[k] * (1 << RESIZE_FIXED_BITS)));
+                        sum += fixed[k];
+                        if (weight[k] > weight[largest]) largest = k;
+                    }
+                    fixed[largest] = int16_t(fixed[largest] + (1 << RESIZE_FIXED_BITS) - sum);
+                }
+            }
+
+            /**
+             * Pixel centers are aligned: source x = (i + 0.5) * src / dst - 0.5
+             */
+            static inline ResizeTable resize_linear_table(int32_t src, int32_t dst) {
+                ResizeTable table;
+                table.taps = 2;
+                table.index.resize(dst * 2);
+                table.weight.resize(dst * 2);
+                auto scale = double(src) / double(dst);
+                for (int32_t i = 0; i < dst; ++i) {
+                    auto x = (double(i) + 0.5) * scale - 0.5;
+                    x = std::max(0.0, std::min(x, double(src - 1)));
+                    auto x0 = int32_t(x);
+                    auto w1 = float(x - x0);
+                    table.index[i * 2] = x0;
+                    table.index[i * 2 + 1] = std::min(x0 + 1, src - 1);
+                    table.weight[i * 2] = 1 - w1;
+                    table.weight[i * 2 + 1] = w1;
+                }
+                resize_fixed_weights(table);
+                return table;
+            }
+
+            /**
+             * Output pixel i covers source [i * src / dst, (i + 1) * src / dst),
+             * weight of each source pixel is covered length. Bilinear table returned when upscale.
+             */
+            static inline ResizeTable resize_area_table(int32_t src, int32_t dst) {
+                if (dst >= src) return resize_linear_table(src, dst);
+                ResizeTable table;
+                auto scale = double(src) / double(dst);
+                table.taps = int32_t(std::ceil(scale)) + 1;
+                table.taps += table.taps % 2;   // SIMD kernels take taps two by two
+                table.index.resize(dst * table.taps);
+                table.weight.resize(dst * table.taps);
+                for (int32_t i = 0; i < dst; ++i) {
+                    auto begin = double(i) * scale;
+                    auto end = std::min(double(i + 1) * scale, double(src));
+                    auto first = std::min(int32_t(begin), src - 1);
+                    auto index = &table.index[i * table.taps];
+                    auto weight = &table.weight[i * table.taps];
+                    for (int32_t k = 0; k < table.taps; ++k) {
+                        // unused taps read last covered pixel with weight 0
+                        auto x = std::min(first + k, src - 1);
+                        auto covered = std::min(end, double(x + 1)) - std::max(begin, double(x));
+                        index[k] = x;
+                        weight[k] = first + k < src && covered > 0 ? float(covered / scale) : 0.0f;
+                    }
+                }
+                resize_fixed_weights(table);
+                return table;
+            }
+
+            /**
+             * Get resize table, cached by (method, src, dst), so resizing same size repeatedly builds table once.
+             */
+            static inline std::shared_ptr<const ResizeTable> resize_table(ResizeMethod method,
+                                                                          int32_t src, int32_t dst) {
+                static std::mutex mutex;
+                static std::map<std::tuple<int32_t, int32_t, int32_t>, std::shared_ptr<const ResizeTable>> cache;
+                auto key = std::make_tuple(int32_t(method), src, dst);
+                std::unique_lock<std::mutex> _locker(mutex);
+                auto it = cache.find(key);
+                if (it != cache.end()) return it->second;
+                if (cache.size() >= 64) cache.clear();
+                auto table = std::make_shared<ResizeTable>(
+                        method == RESIZE_AREA ? resize_area_table(src, dst) : resize_linear_table(src, dst));
+                cache.insert(std::make_pair(key, table));
+                return table;
+            }
+
+            /**
+             * Horizontal pass of one source row, byte row into 11 bits fixed point int32 row.
+             * @tparam C channels, 0 for runtime channels
+             */
+            template<int C>
+            static inline void resize_row_x(const uint8_t *src, int32_t *dst, const ResizeTable &table,
+                                            int32_t begin, int32_t end, int32_t channels) {
+                const int32_t step = C > 0 ? C : channels;
+                const auto taps = table.taps;
+                auto index = table.index.data() + begin * taps;
+                auto weight = table.fixed.data() + begin * taps;
+                dst += begin * step;
+                for (int32_t i = begin; i < end; ++i, index += taps, weight += taps, dst += step) {
+                    // sum in locals, byte pointer may alias dst
+                    int32_t sum[C > 0 ? C : 1] = {0};
+                    if (C == 0) {
+                        for (int32_t c = 0; c < step; ++c) dst[c] = 0;
+                    }
+                    for (int32_t k = 0; k < taps; ++k) {
+                        auto p = src + index[k] * step;
+                        int32_t w = weight[k];
+                        if (C > 0) {
+                            for (int32_t c = 0; c < C; ++c) sum[c] += int32_t(p[c]) * w;
+                        } else {
+                            for (int32_t c = 0; c < step; ++c) dst[c] += int32_t(p[c]) * w;
+                        }
+                    }
+                    for (int32_t c = 0; c < C; ++c) dst[c] = sum[c];
+                }
+            }
+
+            /**
+             * Horizontal pass of one source row, float row into float row.
+             * @tparam C channels, 0 for runtime channels
+             */
+            template<int C>
+            static inline void resize_row_x(const float *src, float *dst, const ResizeTable &table,
+                                            int32_t begin, int32_t end, int32_t channels) {
+                const int32_t step = C > 0 ? C : channels;
+                const auto taps = table.taps;
+                auto index = table.index.data() + begin * taps;
+                auto weight = table.weight.data() + begin * taps;
+                dst += begin * step;
+                for (int32_t i = begin; i < end; ++i, index += taps, weight += taps, dst += step) {
+                    float sum[C > 0 ? C : 1] = {0};
+                    if (C == 0) {
+                        for (int32_t c = 0; c < step; ++c) dst[c] = 0;
+                    }
+                    for (int32_t k = 0; k < taps; ++k) {
+                        auto p = src + index[k] * step;
+                        auto w = weight[k];
+                        if (C > 0) {
+                            for (int32_t c = 0; c < C; ++c) sum[c] += p[c] * w;
+                        } else {
+                            for (int32_t c = 0; c < step; ++c) dst[c] += p[c] * w;
+                        }
+                    }
+                    for (int32_t c = 0; c < C; ++c) dst[c] = sum[c];
+                }
+            }
+
+            template<typename T, typename A>
+            static inline void resize_row_x(const T *src, int32_t src_width, A *dst, const ResizeTable &table,
+                                            int32_t width, int32_t channels) {
+                int32_t done = 0;
+                auto kernels = std::is_same<T, uint8_t>::value ? simd::resize_kernels() : nullptr;
+                if (kernels && (channels == 3 || channels == 4)) {
+                    auto kernel = channels == 3 ? kernels->c3 : kernels->c4;
+                    done = kernel(reinterpret_cast<const uint8_t *>(src), src_width, reinterpret_cast<int32_t *>(dst),
+                                  width, table.index.data(), table.fixed.data(), table.taps);
+                }
+                switch (channels) {
+                    case 1: resize_row_x<1>(src, dst, table, done, width, channels); break;
+                    case 3: resize_row_x<3>(src, dst, table, done, width, channels); break;
+                    case 4: resize_row_x<4>(src, dst, table, done, width, channels); break;
+                    default: resize_row_x<0>(src, dst, table, done, width, channels); break;
+                }
+            }
+
+            /**
+             * Vertical pass, blend fixed point rows into byte row.
+             */
+            static inline void resize_row_y(const int32_t *const *rows, const ResizeTable &table, int32_t j,
+                                            uint8_t *dst, int32_t N) {
+                const auto taps = table.taps;
+                auto weight = table.fixed.data() + j * taps;
+                const int32_t half = 1 << (RESIZE_FIXED_BITS * 2 - 1);
+                int32_t done = 0;
+                auto kernels = simd::resize_kernels();
+                if (kernels) done = kernels->column(rows, weight, taps, dst, N);
+                // accumulate blocks of row, so each loop runs over continuous memory
+                const int32_t block = 256;
+                int32_t sum[block];
+                for (int32_t i = done; i < N; i += block) {
+                    auto count = std::min(block, N - i);
+                    for (int32_t b = 0; b < count; ++b) sum[b] = half;
+                    for (int32_t k = 0; k < taps; ++k) {
+                        auto row = rows[k] + i;
+                        int32_t w = weight[k];
+                        for (int32_t b = 0; b < count; ++b) sum[b] += row[b] * w;
+                    }
+                    for (int32_t b = 0; b < count; ++b) {
+                        dst[i + b] = uint8_t(std::min(sum[b] >> (RESIZE_FIXED_BITS * 2), 255));
+                    }
+                }
+            }
+
+            /**
+             * Vertical pass, blend float rows into float row.
+             */
+            static inline void resize_row_y(const float *const *rows, const ResizeTable &table, int32_t j,
+                                            float *dst, int32_t N) {
+                const auto taps = table.taps;
+                auto weight = table.weight.data() + j * taps;
+                for (int32_t i = 0; i < N; ++i) dst[i] = rows[0][i] * weight[0];
+                for (int32_t k = 1; k < taps; ++k) {
+                    auto row = rows[k];
+                    auto w = weight[k];
+                    for (int32_t i = 0; i < N; ++i) dst[i] += row[i] * w;
+                }
+            }
+
+            /**
+             * Separable resize, horizontal pass writes source rows into a ring of rows with accumulator type A,
+             * vertical pass blends rows in ring into output rows.
+             * @param src first image, images are `image_stride` bytes apart, rows are `row_stride` bytes apart
+             * @param dst packed output images
+             */
+            template<typename T, typename A>
+            static inline void resize2d(const Executor &threads,
+                                        const uint8_t *src, int32_t number, int32_t src_width, int32_t src_height,
+                                        int32_t channels, size_t row_stride, size_t image_stride,
+                                        T *dst, int32_t dst_width, int32_t dst_height,
+                                        ResizeMethod method) {
+                auto x_table = resize_table(method, src_width, dst_width);
+                auto y_table = resize_table(method, src_height, dst_height);
+                auto taps = y_table->taps;
+                auto row_size = size_t(dst_width) * channels;
+                // SIMD row kernel may write one element after row
+                auto slot_size = row_size + 4;
+
+                parallel_range(threads, 0, number * dst_height, [&](int32_t first, int32_t last) {
+                    // any `taps` continuous source rows are in different slots
+                    std::vector<A> ring(slot_size * taps);
+                    std::vector<int32_t> ring_row(taps, -1);
+                    std::vector<const A *> rows(taps);
+                    auto ring_image = -1;
+                    for (auto item = first; item < last; ++item) {
+                        auto n = item / dst_height;
+                        auto j = item % dst_height;
+                        if (n != ring_image) {
+                            std::fill(ring_row.begin(), ring_row.end(), -1);
+                            ring_image = n;
+                        }
+                        auto image = src + size_t(n) * image_stride;
+                        auto index = &y_table->index[j * taps];
+                        for (int32_t k = 0; k < taps; ++k) {
+                            auto y = index[k];
+                            auto slot = &ring[slot_size * (y % taps)];
+                            if (ring_row[y % taps] != y) {
+                                resize_row_x(reinterpret_cast<const T *>(image + y * row_stride), src_width,
+                                             slot, *x_table, dst_width, channels);
+                                ring_row[y % taps] = y;
+                            }
+                            rows[k] = slot;
+                        }
+                        auto out = dst + (size_t(n) * dst_height + j) * row_size;
+                        resize_row_y(rows.data(), *y_table, j, out, int32_t(row_size));
+                    }
+                });
+            }
+        }
+
+        /**
+         * Resize image by separable two pass resampler, coefficient tables cached by size.
+         * @param threads executor running kernels, or number of threads
+         * @param image BYTE or FLOAT32 image, could be strided HWC view
+         * @param width resized image width
+         * @param height resized image height
+         * @param method RESIZE_LINEAR or RESIZE_AREA
+         * @return resized image with same format
+         */
+        static inline ImageData resize2d(const Executor &threads, ImageView image,
+                                         int width, int height, ResizeMethod method = RESIZE_LINEAR) {
+            auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+            auto type = ImageData::GetType(format);
+            auto channels = int32_t(ImageData::GetChannels(format, image.channels));
+            if (type != SEETA_AIP_VALUE_BYTE && type != SEETA_AIP_VALUE_FLOAT32) {
+                throw Exception(
+                        std::string("AIP image resize only support BYTE or FLOAT32 type, got ") + type_string(format));
+            }
+            if (ImageData::IsYUV420(format)) {
+                throw Exception(
+                        std::string("AIP image resize not support YUV format, got ") + format_string(format) +
+                        ", use convert_resize instead.");
+            }
+            if (width <= 0 || height <= 0) {
+                throw Exception("AIP image resize got non-positive size.");
+            }
+            image.channels = channels;
+            ImageData dst(format, image.number, width, height, channels);
+            if (image.number == 0 || image.width == 0 || image.height == 0) return dst;
+
+            auto number = int32_t(image.number);
+            auto row_stride = size_t(ImageData::GetRowStride(image));
+            auto image_stride = size_t(ImageData::GetImageStride(image));
+            bool is_chw = (format & 0xffff0000) == 0x80000;
+            if (is_chw) {
+                if (!ImageData::IsPacked(image)) {
+                    throw Exception("Strided image only support HWC format.");
+                }
+                // each channel is one gray image
+                number *= channels;
+                channels = 1;
+                row_stride = size_t(image.width) * ImageData::GetElementWidth(format);
+                image_stride = row_stride * image.height;
+            }
+            auto src = reinterpret_cast<const uint8_t *>(image.data);
+            if (type == SEETA_AIP_VALUE_BYTE) {
+                _::resize2d<uint8_t, int32_t>(
+                        threads, src, number, int32_t(image.width), int32_t(image.height), channels,
+                        row_stride, image_stride, dst.data<uint8_t>(), width, height, method);
+            } else {
+                _::resize2d<float, float>(
+                        threads, src, number, int32_t(image.width), int32_t(image.height), channels,
+                        row_stride, image_stride, dst.data<float>(), width, height, method);
+            }
+            return dst;
+        }
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_RESIZE_H
@@ -0,0 +1,284 @@
+#ifndef SEETA_AIP_SEETA_AIP_ROTATE_H
+#define SEETA_AIP_SEETA_AIP_ROTATE_H
+
+#include "seeta_aip_struct.h"
+#include "seeta_aip_executor.h"
+#include "seeta_aip_simd.h"
+
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace seeta {
+    namespace aip {
+        namespace _ {
+            template<size_t S>
+            struct PixelBlock {
+                uint8_t data[S];
+            };
+
+            /**
+             * Source of orient, pixel (x, y) of dst is at `origin + y * row_step + x * pixel_step` of source.
+             * Steps are bytes and could be negative, pixel_step is not pixel size when transposed.
+             */
+            struct OrientView {
+                const uint8_t *origin;
+                ptrdiff_t pixel_step;
+                ptrdiff_t row_step;
+            };
+
+            /**
+             * Copy `width x height` pixels from view, pixels of one dst column are continuous in source.
+             */
+            template<typename P>
+            static inline void orient_block(const OrientView &view, uint8_t *dst, ptrdiff_t dst_stride,
+                                            int32_t x, int32_t y, int32_t width, int32_t height) {
+                for (int32_t j = y; j < y + height; ++j) {
+                    auto src = view.origin + j * view.row_step + x * view.pixel_step;
+                    auto out = reinterpret_cast<P *>(dst + j * dst_stride) + x;
+                    for (int32_t i = 0; i < width; ++i) {
+                        out[i] = *reinterpret_cast<const P *>(src + i * view.pixel_step);
+                    }
+                }
+            }
+
+            static inline void orient_block(size_t pixel, const OrientView &view, uint8_t *dst, ptrdiff_t dst_stride,
+                                            int32_t x, int32_t y, int32_t width, int32_t height) {
+                switch (pixel) {
+                    case 1: orient_block<PixelBlock<1>>(view, dst, dst_stride, x, y, width, height); break;
+                    case 2: orient_block<PixelBlock<2>>(view, dst, dst_stride, x, y, width, height); break;
+                    case 3: orient_block<PixelBlock<3>>(view, dst, dst_stride, x, y, width, height); break;
+                    case 4: orient_block<PixelBlock<4>>(view, dst, dst_stride, x, y, width, height); break;
+                    default:
+                        for (int32_t j = y; j < y + height; ++j) {
+                            auto src = view.origin + j * view.row_step + x * view.pixel_step;
+                            auto out = dst + j * dst_stride + x * pixel;
+                            for (int32_t i = 0; i < width; ++i, out += pixel, src += view.pixel_step) {
+                                std::memcpy(out, src, pixel);
+                            }
+                        }
+                        break;
+                }
+            }
+
+            /**
+             * Transposing orient, pixels of one dst row are one source column.
+             * Dst is walked in tiles, so both source rows and dst rows of one tile stay in cache,
+             * full 8x8 blocks go to SIMD transpose kernel.
+             */
+            static inline void orient_transpose_tile(size_t pixel, const OrientView &view,
+                                                     uint8_t *dst, ptrdiff_t dst_stride,
+                                                     int32_t x, int32_t y, int32_t width, int32_t height) {
+                auto kernels = simd::orient_kernels();
+                auto kernel = kernels && pixel <= 4 ? kernels->transpose[pixel] : nullptr;
+                // source pixels of one dst column are continuous, in order or reversed
+                bool reversed = view.row_step < 0;
+                if (!kernel || (reversed ? -view.row_step : view.row_step) != ptrdiff_t(pixel)) {
+                    orient_block(pixel, view, dst, dst_stride, x, y, width, height);
+                    return;
+                }
+                auto full_width = width / 8 * 8;
+                auto full_height = height / 8 * 8;
+                for (int32_t j = y; j < y + full_height; j += 8) {
+                    for (int32_t i = x; i < x + full_width; i += 8) {
+                        // source block rows are dst columns, reversed block fills dst rows from bottom
+                        auto first_row = reversed ? j + 7 : j;
+                        auto src = view.origin + first_row * view.row_step + i * view.pixel_step;
+                        auto out = dst + first_row * dst_stride + i * pixel;
+                        kernel(src, view.pixel_step, out, reversed ? -dst_stride : dst_stride);
+                    }
+                }
+                if (full_width < width) {
+                    orient_block(pixel, view, dst, dst_stride, x + full_width, y, width - full_width, full_height);
+                }
+                if (full_height < height) {
+                    orient_block(pixel, view, dst, dst_stride, x, y + full_height, width, height - full_height);
+                }
+            }
+
+            /**
+             * Row of non-transposing orient, pixels in order or reversed.
+             */
+            static inline void orient_row(size_t pixel, const OrientView &view, uint8_t *dst, int32_t y,
+                                          int32_t width) {
+                auto src = view.origin + y * view.row_step;
+                if (view.pixel_step > 0) {
+                    std::memcpy(dst, src, width * pixel);
+                    return;
+                }
+                auto kernels = simd::orient_kernels();
+                auto kernel = kernels && pixel <= 4 ? kernels->reverse[pixel] : nullptr;
+                int32_t done = 0;
+                auto first = src - (width - 1) * ptrdiff_t(pixel);
+                if (kernel) done = kernel(first, dst, width);
+                OrientView rest = {src, view.pixel_step, 0};
+                orient_block(pixel, rest, dst, 0, done, 0, width - done, 1);
+            }
+
+            /**
+             * dst(x, y) = view(x, y) for each plane
+             * @param planes number of planes, planes are `plane_step` bytes apart in source
+             * @param dst packed planes of `width x height` pixels
+             */
+            static inline void orient(const Executor &threads, size_t pixel, OrientView view, ptrdiff_t plane_step,
+                                      int32_t planes, uint8_t *dst, int32_t width, int32_t height) {
+                auto dst_stride = ptrdiff_t(width) * pixel;
+                auto dst_plane = dst_stride * height;
+                bool transposed = view.pixel_step != ptrdiff_t(pixel) && view.pixel_step != -ptrdiff_t(pixel);
+                if (!transposed) {
+                    parallel_for(threads, 0, planes * height, [&](int32_t i) {
+                        auto n = i / height;
+                        auto y = i % height;
+                        OrientView plane = {view.origin + n * plane_step, view.pixel_step, view.row_step};
+                        orient_row(pixel, plane, dst + n * dst_plane + y * dst_stride, y, width);
+                    });
+                    return;
+                }
+                // tiles of 64 x 64 pixels, at most 16KB source and 16KB dst for 4 bytes pixels
+                const int32_t tile = 64;
+                auto tile_rows = (height + tile - 1) / tile;
+                auto tile_cols = (width + tile - 1) / tile;
+                parallel_for(threads, 0, planes * tile_rows * tile_cols, [&](int32_t i) {
+                    auto n = i / (tile_rows * tile_cols);
+                    auto y = (i / tile_cols) % tile_rows * tile;
+                    auto x = i % tile_cols * tile;
+                    OrientView plane = {view.origin + n * plane_step, view.pixel_step, view.row_step};
+                    orient_transpose_tile(pixel, plane, dst + n * dst_plane, dst_stride,
+                                          x, y, std::min(tile, width - x), std::min(tile, height - y));
+                });
+            }
+
+            /**
+             * Orient image, each CHW plane oriented as one image.
+             * @param transpose if swap x and y first
+             * @param flip_x if reverse x of source
+             * @param flip_y if reverse y of source
+             */
+            static inline void orient(const Executor &threads, const ImageView &image,
+                                      bool transpose, bool flip_x, bool flip_y, const SeetaAIPImageData &output) {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                if (ImageData::IsYUV420(format)) {
+                    throw Exception(std::string("AIP image rotate not support YUV format, got ") +
+                                    format_string(format));
+                }
+                auto W = int32_t(image.width);
+                auto H = int32_t(image.height);
+                auto dst_width = transpose ? H : W;
+                auto dst_height = transpose ? W : H;
+                if (output.format != image.format || output.number != image.number
+                    || int32_t(output.width) != dst_width || int32_t(output.height) != dst_height
+                    || ImageData::GetChannels(format, output.channels)
+                       != ImageData::GetChannels(format, image.channels)) {
+                    throw Exception("AIP image rotate got mismatched output image.");
+                }
+                auto element = size_t(ImageData::GetElementWidth(format));
+                auto channels = size_t(ImageData::GetChannels(format, image.channels));
+                auto pixel = element * channels;
+                auto planes = int32_t(image.number);
+                auto row_stride = ptrdiff_t(ImageData::GetRowStride(image));
+                auto plane_step = ptrdiff_t(ImageData::GetImageStride(image));
+                bool is_chw = (format & 0xffff0000) == 0x80000;
+                if (is_chw) {
+                    if (!ImageData::IsPacked(image)) {
+                        throw Exception("Strided image only support HWC format.");
+                    }
+                    // each channel is one image
+                    pixel = element;
+                    planes *= int32_t(channels);
+                    row_stride = ptrdiff_t(W) * element;
+                    plane_step = row_stride * H;
+                }
+                if (planes == 0 || W == 0 || H == 0) return;
+
+                // source pixel of dst (x, y) is (sx, sy) = transpose ? (y, x) : (x, y), then flipped
+                auto src = reinterpret_cast<const uint8_t *>(image.data);
+                ptrdiff_t step_x = ptrdiff_t(pixel);    // bytes when sx increased
+                ptrdiff_t step_y = row_stride;          // bytes when sy increased
+                if (flip_x) {
+                    src += (W - 1) * step_x;
+                    step_x = -step_x;
+                }
+                if (flip_y) {
+                    src += (H - 1) * step_y;
+                    step_y = -step_y;
+                }
+                OrientView view = {src, transpose ? step_y : step_x, transpose ? step_x : step_y};
+                orient(threads, pixel, view, plane_step, planes,
+                       reinterpret_cast<uint8_t *>(output.data), dst_width, dst_height);
+            }
+        }
+
+        /**
+         * Rotate image by multiple of 90 degrees, pixels are moved exactly without sampling.
+         * @param threads executor running kernels, or number of threads
+         * @param image source image of any type, could be strided HWC view
+         * @param angle counterclockwise degrees, must be multiple of 90, negative means clockwise
+         * @param output packed image with same format, size swapped when rotated 90 or 270 degrees
+         */
+        static inline void rotate_image(const Executor &threads, const ImageView &image, int angle,
+                                        const SeetaAIPImageData &output) {
+            if (angle % 90 != 0) {
+                throw Exception("AIP image rotate angle must be multiple of 90, got " + std::to_string(angle));
+            }
+            switch ((angle % 360 + 360) % 360) {
+                default:
+                case 0:
+                    _::orient(threads, image, false, false, false, output);
+                    break;
+                case 90:
+                    _::orient(threads, image, true, true, false, output);
+                    break;
+                case 180:
+                    _::orient(threads, image, false, true, true, output);
+                    break;
+                case 270:
+                    _::orient(threads, image, true, false, true, output);
+                    break;
+            }
+        }
+
+        /**
+         * @param threads executor running kernels, or number of threads
+         * @param image source image of any type, could be strided HWC view
+         * @param angle counterclockwise degrees, must be multiple of 90, negative means clockwise
+         * @return rotated image
+         */
+        static inline ImageData rotate_image(const Executor &threads, const ImageView &image, int angle) {
+            bool swapped = (angle % 180 + 180) % 180 != 0;
+            ImageData output(SEETA_AIP_IMAGE_FORMAT(image.format), image.number,
+                             swapped ? image.height : image.width, swapped ? image.width : image.height,
+                             image.channels);
+            rotate_image(threads, image, angle, output);
+            return output;
+        }
+
+        /**
+         * Flip image, pixels are moved exactly without sampling.
+         * @param threads executor running kernels, or number of threads
+         * @param image source image of any type, could be strided HWC view
+         * @param x if flip left and right
+         * @param y if flip top and bottom
+         * @param output packed image with same format and size
+         */
+        static inline void flip_image(const Executor &threads, const ImageView &image, bool x, bool y,
+                                      const SeetaAIPImageData &output) {
+            _::orient(threads, image, false, x, y, output);
+        }
+
+        /**
+         * @param threads executor running kernels, or number of threads
+         * @param image source image of any type, could be strided HWC view
+         * @param x if flip left and right
+         * @param y if flip top and bottom
+         * @return flipped image
+         */
+        static inline ImageData flip_image(const Executor &threads, const ImageView &image, bool x, bool y) {
+            ImageData output(SEETA_AIP_IMAGE_FORMAT(image.format), image.number, image.width, image.height,
+                             image.channels);
+            flip_image(threads, image, x, y, output);
+            return output;
+        }
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_ROTATE_H
@@ -0,0 +1,1215 @@
+#ifndef SEETA_AIP_SEETA_AIP_SIMD_H
+#define SEETA_AIP_SEETA_AIP_SIMD_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+/**
+ * SIMD kernels for byte image, selected at runtime by CPU features.
+ * Define SEETA_AIP_NO_SIMD to use scalar code only.
+ * x86 kernels are compiled with function target attributes, so no global -msse4.1 or -mavx2 needed.
+ */
+
+#if !defined(SEETA_AIP_NO_SIMD)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SEETA_AIP_SIMD_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SEETA_AIP_SIMD_NEON 1
+#endif
+#endif
+
+#if defined(SEETA_AIP_SIMD_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SEETA_AIP_TARGET_SSE41
+#define SEETA_AIP_TARGET_AVX2
+#else
+#define SEETA_AIP_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SEETA_AIP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(SEETA_AIP_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace seeta {
+    namespace aip {
+        namespace simd {
+            enum Level {
+                NONE = 0,
+                SSE41 = 1,
+                AVX2 = 2,
+                NEON = 3,
+            };
+
+            static inline const char *level_string(Level level) {
+                switch (level) {
+                    default: return "Unknown";
+                    case NONE: return "NONE";
+                    case SSE41: return "SSE4.1";
+                    case AVX2: return "AVX2";
+                    case NEON: return "NEON";
+                }
+            }
+
+            namespace _ {
+                static inline Level detect() {
+#if defined(SEETA_AIP_SIMD_X86)
+#if defined(_MSC_VER)
+                    int info[4];
+                    __cpuid(info, 0);
+                    auto ids = info[0];
+                    __cpuid(info, 1);
+                    bool sse41 = (info[2] & (1 << 19)) != 0;
+                    bool osxsave = (info[2] & (1 << 27)) != 0;
+                    bool avx = (info[2] & (1 << 28)) != 0;
+                    bool avx2 = false;
+                    if (ids >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+                        __cpuidex(info, 7, 0);
+                        avx2 = (info[1] & (1 << 5)) != 0;
+                    }
+#else
+                    __builtin_cpu_init();
+                    bool sse41 = __builtin_cpu_supports("sse4.1");
+                    bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+                    if (avx2) return AVX2;
+                    if (sse41) return SSE41;
+                    return NONE;
+#elif defined(SEETA_AIP_SIMD_NEON)
+                    return NEON;
+#else
+                    return NONE;
+#endif
+                }
+            }
+
+            /**
+             * @return best SIMD level supported by running CPU, detected once
+             */
+            static inline Level level() {
+                static const Level detected = _::detect();
+                return detected;
+            }
+
+            /**
+             * Convert N pixels, return number of converted pixels.
+             * The rest pixels (less than one block) should be converted by scalar code.
+             */
+            using UImageKernel = int32_t (*)(const uint8_t *src, uint8_t *dst, int32_t N);
+
+            struct UImageKernels {
+                UImageKernel bgr2rgb;
+                UImageKernel bgr2bgra;
+                UImageKernel bgr2rgba;
+                UImageKernel bgra2bgr;
+                UImageKernel bgra2rgb;
+                UImageKernel bgra2rgba;
+                UImageKernel y2bgr;
+                UImageKernel y2bgra;
+                UImageKernel bgr2y;
+                UImageKernel bgra2y;
+                UImageKernel rgb2y;
+                UImageKernel rgba2y;
+            };
+
+            /**
+             * Bilinear sample `N` pixels along one output row of affine warp,
+             * 2x2 neighbors of every pixel must be inside image.
+             * Source position of i-th pixel is (X + i * A, Y + i * D) in 32.32 fixed point.
+             * Weights are 15 bits, `a + (((b - a) * w + (1 << 14)) >> 15)` for each lerp, same as scalar code.
+             * @param src first byte of image
+             * @param row_stride bytes between two rows
+             * @param bytes readable bytes from src
+             * @return number of sampled pixels, the rest pixels should be sampled by scalar code
+             */
+            using AffineRowKernel = int32_t (*)(const uint8_t *src, int32_t row_stride, int32_t bytes,
+                                                uint8_t *dst, int32_t N,
+                                                int64_t X, int64_t Y, int64_t A, int64_t D);
+
+            struct AffineKernels {
+                AffineRowKernel c3;
+                AffineRowKernel c4;
+            };
+
+            /**
+             * Horizontal pass of resize on one source row, with 11 bits fixed point weights and even taps.
+             * dst[i * C + c] = sum(src[index[i * taps + k] * C + c] * weight[i * taps + k]) for k in [0, taps)
+             * @param src first byte of source row
+             * @param width source row width in pixels, no byte after row is read
+             * @param dst output row, one int32 after last written pixel may be overwritten
+             * @return number of output pixels, the rest pixels should be computed by scalar code
+             */
+            using ResizeRowKernel = int32_t (*)(const uint8_t *src, int32_t width, int32_t *dst, int32_t N,
+                                                const int32_t *index, const int16_t *weight, int32_t taps);
+
+            /**
+             * Vertical pass of resize, dst[i] = (sum(rows[k][i] * weight[k]) + (1 << 21)) >> 22,
+             * weights are 11 bits fixed point, rows come from ResizeRowKernel.
+             * @return number of output bytes, the rest bytes should be computed by scalar code
+             */
+            using ResizeColumnKernel = int32_t (*)(const int32_t *const *rows, const int16_t *weight, int32_t taps,
+                                                   uint8_t *dst, int32_t N);
+
+            struct ResizeKernels {
+                ResizeRowKernel c3;
+                ResizeRowKernel c4;
+                ResizeColumnKernel column;
+            };
+
+            /**
+             * Transpose 8x8 pixels, dst[r][c] = src[c][r], strides are bytes between rows and could be negative.
+             */
+            using TransposeKernel = void (*)(const uint8_t *src, ptrdiff_t src_stride,
+                                             uint8_t *dst, ptrdiff_t dst_stride);
+
+            /**
+             * Reverse pixels of one row, dst[i] = src[N - 1 - i].
+             * @return number of leading dst pixels written, the rest pixels should be written by scalar code
+             */
+            using ReverseKernel = int32_t (*)(const uint8_t *src, uint8_t *dst, int32_t N);
+
+            /**
+             * Kernels of rotation and flip, indexed by bytes of one pixel, nullptr if not supported.
+             */
+            struct OrientKernels {
+                TransposeKernel transpose[5];
+                ReverseKernel reverse[5];
+            };
+
+            /**
+             * Blend N pixels of C channels with constant color, for each byte
+             * dst = (dst * (255 - alpha) + color * alpha) / 255, same as scalar plot code.
+             * @param color C bytes, alpha channel of color should be 255 to blend alpha channel to opaque
+             * @param alpha in [0, 255]
+             * @return number of blended pixels, the rest pixels should be blended by scalar code
+             */
+            using BlendKernel = int32_t (*)(uint8_t *dst, int32_t N, const uint8_t *color, int32_t alpha);
+
+            /**
+             * Same as BlendKernel, with per pixel alpha `alpha * coverage[i] / 255`.
+             */
+            using BlendMaskKernel = int32_t (*)(uint8_t *dst, int32_t N, const uint8_t *color, int32_t alpha,
+                                                const uint8_t *coverage);
+
+            /**
+             * Fill N pixels of C channels with color of C bytes.
+             * @return number of filled pixels, the rest pixels should be filled by scalar code
+             */
+            using FillKernel = int32_t (*)(uint8_t *dst, int32_t N, const uint8_t *color);
+
+            /**
+             * Kernels of plot, indexed by channels, nullptr if not supported.
+             */
+            struct BlendKernels {
+                BlendKernel blend[5];
+                BlendMaskKernel blend_mask[5];
+                FillKernel fill[5];
+            };
+
+            namespace _ {
+                /*
+                 * Gray uses same fixed point as scalar code: Y = (R * 19595 + G * 38469 + B * 7472) >> 16.
+                 * 38469 does not fit int16, so G is multiplied with 38469 - 65536 in madd, and G is added back after shift.
+                 */
+                static const int32_t gray_bg_coef = int32_t((38469u << 16) | 7472u);
+                static const int32_t gray_r_coef = 19595;
+
+#if defined(SEETA_AIP_SIMD_X86)
+                // shuffle masks to split 16 packed 3-channel pixels into planes, [plane][vector]
+                static const int8_t deinterleave3_mask[3][3][16] = {
+                        {
+                                {0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+                                {-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1},
+                                {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13},
+                        },
+                        {
+                                {1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+                                {-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1},
+                                {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14},
+                        },
+                        {
+                                {2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+                                {-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1},
+                                {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15},
+                        },
+                };
+
+                // shuffle masks to merge 3 planes into 16 packed 3-channel pixels, [vector][plane]
+                static const int8_t interleave3_mask[3][3][16] = {
+                        {
+                                {0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5},
+                                {-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1},
+                                {-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1},
+                        },
+                        {
+                                {-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1},
+                                {5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10},
+                                {-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1},
+                        },
+                        {
+                                {-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1},
+                                {-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1},
+                                {10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15},
+                        },
+                };
+
+                // transpose 4x4 bytes in each 4-channel vector, it is inverse of itself
+                static const int8_t transpose4_mask[16] = {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15};
+
+                /**
+                 * SSE4.1, one block is 16 pixels in one 128-bit vector per plane.
+                 */
+                struct SSE41Ops {
+                    using V = __m128i;
+                    static const int32_t block = 16;
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V mask(const int8_t *m) {
+                        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(m));
+                    }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V zero() { return _mm_setzero_si128(); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V load(const uint8_t *p, int32_t) {
+                        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                    }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline void store(uint8_t *p, int32_t, V v) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+                    }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V shuffle(V a, V m) { return _mm_shuffle_epi8(a, m); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V bitwise_or(V a, V b) { return _mm_or_si128(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpacklo_epi8(V a, V b) { return _mm_unpacklo_epi8(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpackhi_epi8(V a, V b) { return _mm_unpackhi_epi8(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpacklo_epi16(V a, V b) { return _mm_unpacklo_epi16(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpackhi_epi16(V a, V b) { return _mm_unpackhi_epi16(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpacklo_epi32(V a, V b) { return _mm_unpacklo_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpackhi_epi32(V a, V b) { return _mm_unpackhi_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpacklo_epi64(V a, V b) { return _mm_unpacklo_epi64(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V unpackhi_epi64(V a, V b) { return _mm_unpackhi_epi64(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V set1_epi32(int32_t a) { return _mm_set1_epi32(a); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V madd_epi16(V a, V b) { return _mm_madd_epi16(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V add_epi32(V a, V b) { return _mm_add_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V srai_epi32(V a) { return _mm_srai_epi32(a, 16); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V packs_epi32(V a, V b) { return _mm_packs_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_SSE41
+                    static inline V packus_epi16(V a, V b) { return _mm_packus_epi16(a, b); }
+                };
+
+                /**
+                 * AVX2, one block is 32 pixels, each 128-bit lane holds 16 pixels,
+                 * so in-lane shuffles work same as SSE4.1.
+                 */
+                struct AVX2Ops {
+                    using V = __m256i;
+                    static const int32_t block = 32;
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V mask(const int8_t *m) {
+                        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(m)));
+                    }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V zero() { return _mm256_setzero_si256(); }
+
+                    /**
+                     * load 16 bytes from p into low lane, and 16 bytes from p + lane_step into high lane
+                     */
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V load(const uint8_t *p, int32_t lane_step) {
+                        return _mm256_inserti128_si256(
+                                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))),
+                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + lane_step)), 1);
+                    }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline void store(uint8_t *p, int32_t lane_step, V v) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_castsi256_si128(v));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + lane_step), _mm256_extracti128_si256(v, 1));
+                    }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V shuffle(V a, V m) { return _mm256_shuffle_epi8(a, m); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V bitwise_or(V a, V b) { return _mm256_or_si256(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpacklo_epi8(V a, V b) { return _mm256_unpacklo_epi8(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpackhi_epi8(V a, V b) { return _mm256_unpackhi_epi8(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpacklo_epi16(V a, V b) { return _mm256_unpacklo_epi16(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpackhi_epi16(V a, V b) { return _mm256_unpackhi_epi16(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpacklo_epi32(V a, V b) { return _mm256_unpacklo_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpackhi_epi32(V a, V b) { return _mm256_unpackhi_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpacklo_epi64(V a, V b) { return _mm256_unpacklo_epi64(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V unpackhi_epi64(V a, V b) { return _mm256_unpackhi_epi64(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V set1_epi32(int32_t a) { return _mm256_set1_epi32(a); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V madd_epi16(V a, V b) { return _mm256_madd_epi16(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V add_epi32(V a, V b) { return _mm256_add_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V srai_epi32(V a) { return _mm256_srai_epi32(a, 16); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V packs_epi32(V a, V b) { return _mm256_packs_epi32(a, b); }
+
+                    SEETA_AIP_TARGET_AVX2
+                    static inline V packus_epi16(V a, V b) { return _mm256_packus_epi16(a, b); }
+                };
+
+                /**
+                 * Kernel on x86 vector ISA, each member must have the target attribute of ISA,
+                 * so it is declared by macro for each ISA.
+                 * IN: input channels, 1, 3 or 4
+                 * OUT: output channels, 1 for gray, 3 or 4
+                 * SWAP: swap channel 0 and 2
+                 */
+#define SEETA_AIP_X86_UIMAGE(NAME, ISA, TARGET) \
+                template<int IN, int OUT, bool SWAP> \
+                struct NAME { \
+                    using V = ISA::V; \
+                    struct Masks { \
+                        V deinterleave3[3][3]; \
+                        V interleave3[3][3]; \
+                        V transpose4; \
+                        V gray_bg; \
+                        V gray_r; \
+                    }; \
+                    TARGET static inline void masks(Masks *m) { \
+                        for (int i = 0; i < 3; ++i) { \
+                            for (int j = 0; j < 3; ++j) { \
+                                m->deinterleave3[i][j] = ISA::mask(deinterleave3_mask[i][j]); \
+                                m->interleave3[i][j] = ISA::mask(interleave3_mask[i][j]); \
+                            } \
+                        } \
+                        m->transpose4 = ISA::mask(transpose4_mask); \
+                        m->gray_bg = ISA::set1_epi32(gray_bg_coef); \
+                        m->gray_r = ISA::set1_epi32(gray_r_coef); \
+                    } \
+                    TARGET static inline void transpose(V v0, V v1, V v2, V v3, V *p0, V *p1, V *p2, V *p3) { \
+                        V t0 = ISA::unpacklo_epi32(v0, v1); \
+                        V t1 = ISA::unpacklo_epi32(v2, v3); \
+                        V t2 = ISA::unpackhi_epi32(v0, v1); \
+                        V t3 = ISA::unpackhi_epi32(v2, v3); \
+                        *p0 = ISA::unpacklo_epi64(t0, t1); \
+                        *p1 = ISA::unpackhi_epi64(t0, t1); \
+                        *p2 = ISA::unpacklo_epi64(t2, t3); \
+                        *p3 = ISA::unpackhi_epi64(t2, t3); \
+                    } \
+                    /* load one block of pixels into planes, alpha is 0 if input has no alpha */ \
+                    TARGET static inline void load(const Masks &m, const uint8_t *src, V *p0, V *p1, V *p2, V *p3) { \
+                        if (IN == 1) { \
+                            /* 1-channel block is contiguous in both lanes */ \
+                            *p0 = *p1 = *p2 = ISA::load(src, 16); \
+                            *p3 = ISA::zero(); \
+                        } else if (IN == 3) { \
+                            V v0 = ISA::load(src, 48), v1 = ISA::load(src + 16, 48), v2 = ISA::load(src + 32, 48); \
+                            V *p[3] = {p0, p1, p2}; \
+                            for (int c = 0; c < 3; ++c) { \
+                                *p[c] = ISA::bitwise_or( \
+                                        ISA::bitwise_or(ISA::shuffle(v0, m.deinterleave3[c][0]), \
+                                                        ISA::shuffle(v1, m.deinterleave3[c][1])), \
+                                        ISA::shuffle(v2, m.deinterleave3[c][2])); \
+                            } \
+                            *p3 = ISA::zero(); \
+                        } else { \
+                            transpose(ISA::shuffle(ISA::load(src, 64), m.transpose4), \
+                                      ISA::shuffle(ISA::load(src + 16, 64), m.transpose4), \
+                                      ISA::shuffle(ISA::load(src + 32, 64), m.transpose4), \
+                                      ISA::shuffle(ISA::load(src + 48, 64), m.transpose4), \
+                                      p0, p1, p2, p3); \
+                        } \
+                    } \
+                    TARGET static inline void store(const Masks &m, uint8_t *dst, V p0, V p1, V p2, V p3) { \
+                        if (OUT == 3) { \
+                            for (int v = 0; v < 3; ++v) { \
+                                V out = ISA::bitwise_or( \
+                                        ISA::bitwise_or(ISA::shuffle(p0, m.interleave3[v][0]), \
+                                                        ISA::shuffle(p1, m.interleave3[v][1])), \
+                                        ISA::shuffle(p2, m.interleave3[v][2])); \
+                                ISA::store(dst + v * 16, 48, out); \
+                            } \
+                        } else { \
+                            V v0, v1, v2, v3; \
+                            transpose(p0, p1, p2, p3, &v0, &v1, &v2, &v3); \
+                            ISA::store(dst, 64, ISA::shuffle(v0, m.transpose4)); \
+                            ISA::store(dst + 16, 64, ISA::shuffle(v1, m.transpose4)); \
+                            ISA::store(dst + 32, 64, ISA::shuffle(v2, m.transpose4)); \
+                            ISA::store(dst + 48, 64, ISA::shuffle(v3, m.transpose4)); \
+                        } \
+                    } \
+                    /* 4 gray int32 values of 16-bit b, g, r */ \
+                    TARGET static inline V gray4(const Masks &m, V bg, V r0, V g0) { \
+                        V sum = ISA::add_epi32(ISA::madd_epi16(bg, m.gray_bg), ISA::madd_epi16(r0, m.gray_r)); \
+                        return ISA::add_epi32(ISA::srai_epi32(sum), g0); \
+                    } \
+                    TARGET static inline V gray8(const Masks &m, V b16, V g16, V r16) { \
+                        auto zero = ISA::zero(); \
+                        V lo = gray4(m, ISA::unpacklo_epi16(b16, g16), ISA::unpacklo_epi16(r16, zero), \
+                                     ISA::unpacklo_epi16(g16, zero)); \
+                        V hi = gray4(m, ISA::unpackhi_epi16(b16, g16), ISA::unpackhi_epi16(r16, zero), \
+                                     ISA::unpackhi_epi16(g16, zero)); \
+                        return ISA::packs_epi32(lo, hi); \
+                    } \
+                    TARGET static inline V gray(const Masks &m, V b, V g, V r) { \
+                        auto zero = ISA::zero(); \
+                        V lo = gray8(m, ISA::unpacklo_epi8(b, zero), ISA::unpacklo_epi8(g, zero), \
+                                     ISA::unpacklo_epi8(r, zero)); \
+                        V hi = gray8(m, ISA::unpackhi_epi8(b, zero), ISA::unpackhi_epi8(g, zero), \
+                                     ISA::unpackhi_epi8(r, zero)); \
+                        return ISA::packus_epi16(lo, hi); \
+                    } \
+                    TARGET static int32_t run(const uint8_t *src, uint8_t *dst, int32_t N) { \
+                        Masks m; \
+                        masks(&m); \
+                        int32_t i = 0; \
+                        for (; i + ISA::block <= N; i += ISA::block) { \
+                            V p0, p1, p2, p3; \
+                            load(m, src + i * IN, &p0, &p1, &p2, &p3); \
+                            if (SWAP) { V t = p0; p0 = p2; p2 = t; } \
+                            if (OUT == 1) { \
+                                ISA::store(dst + i, 16, gray(m, p0, p1, p2)); \
+                            } else { \
+                                store(m, dst + i * OUT, p0, p1, p2, p3); \
+                            } \
+                        } \
+                        return i; \
+                    } \
+                };
+
+                SEETA_AIP_X86_UIMAGE(SSE41UImage, SSE41Ops, SEETA_AIP_TARGET_SSE41)
+
+                SEETA_AIP_X86_UIMAGE(AVX2UImage, AVX2Ops, SEETA_AIP_TARGET_AVX2)
+
+#undef SEETA_AIP_X86_UIMAGE
+
+                template<int IN, int OUT, bool SWAP>
+                static int32_t sse41_uimage(const uint8_t *src, uint8_t *dst, int32_t N) {
+                    return SSE41UImage<IN, OUT, SWAP>::run(src, dst, N);
+                }
+
+                template<int IN, int OUT, bool SWAP>
+                static int32_t avx2_uimage(const uint8_t *src, uint8_t *dst, int32_t N) {
+                    return AVX2UImage<IN, OUT, SWAP>::run(src, dst, N);
+                }
+#endif
+
+#if defined(SEETA_AIP_SIMD_NEON)
+                static inline uint8x8_t neon_gray8(uint8x8_t b, uint8x8_t g, uint8x8_t r) {
+                    uint16x8_t b16 = vmovl_u8(b);
+                    uint16x8_t g16 = vmovl_u8(g);
+                    uint16x8_t r16 = vmovl_u8(r);
+                    uint32x4_t lo = vmull_n_u16(vget_low_u16(b16), 7472);
+                    lo = vmlal_n_u16(lo, vget_low_u16(g16), 38469);
+                    lo = vmlal_n_u16(lo, vget_low_u16(r16), 19595);
+                    uint32x4_t hi = vmull_n_u16(vget_high_u16(b16), 7472);
+                    hi = vmlal_n_u16(hi, vget_high_u16(g16), 38469);
+                    hi = vmlal_n_u16(hi, vget_high_u16(r16), 19595);
+                    return vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)));
+                }
+
+                /**
+                 * NEON, one block is 16 pixels, vld3/vld4 split planes directly.
+                 */
+                template<int IN, int OUT, bool SWAP>
+                static int32_t neon_uimage(const uint8_t *src, uint8_t *dst, int32_t N) {
+                    int32_t i = 0;
+                    for (; i + 16 <= N; i += 16) {
+                        uint8x16_t p0, p1, p2, p3 = vdupq_n_u8(0);
+                        if (IN == 1) {
+                            p0 = p1 = p2 = vld1q_u8(src + i);
+                        } else if (IN == 3) {
+                            uint8x16x3_t v = vld3q_u8(src + i * 3);
+                            p0 = v.val[0]; p1 = v.val[1]; p2 = v.val[2];
+                        } else {
+                            uint8x16x4_t v = vld4q_u8(src + i * 4);
+                            p0 = v.val[0]; p1 = v.val[1]; p2 = v.val[2]; p3 = v.val[3];
+                        }
+                        if (SWAP) {
+                            uint8x16_t t = p0;
+                            p0 = p2;
+                            p2 = t;
+                        }
+                        if (OUT == 1) {
+                            vst1q_u8(dst + i, vcombine_u8(
+                                    neon_gray8(vget_low_u8(p0), vget_low_u8(p1), vget_low_u8(p2)),
+                                    neon_gray8(vget_high_u8(p0), vget_high_u8(p1), vget_high_u8(p2))));
+                        } else if (OUT == 3) {
+                            uint8x16x3_t v;
+                            v.val[0] = p0; v.val[1] = p1; v.val[2] = p2;
+                            vst3q_u8(dst + i * 3, v);
+                        } else {
+                            uint8x16x4_t v;
+                            v.val[0] = p0; v.val[1] = p1; v.val[2] = p2; v.val[3] = p3;
+                            vst4q_u8(dst + i * 4, v);
+                        }
+                    }
+                    return i;
+                }
+#endif
+
+#if defined(SEETA_AIP_SIMD_X86)
+                /**
+                 * AVX2 affine row, 8 pixels each block, 4 bytes of each neighbor fetched by gather.
+                 * 3-channel pixels read one byte more, which is dropped.
+                 */
+                template<int C>
+                SEETA_AIP_TARGET_AVX2
+                static int32_t avx2_affine_row(const uint8_t *src, int32_t row_stride, int32_t bytes,
+                                               uint8_t *dst, int32_t N,
+                                               int64_t X, int64_t Y, int64_t A, int64_t D) {
+                    alignas(32) int32_t offset[8];
+                    alignas(32) int32_t wx[8];
+                    alignas(32) int32_t wy[8];
+                    alignas(32) uint8_t packed[32];
+                    const __m256i lo_index = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+                    const __m256i hi_index = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+                    const __m128i compact3 = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+                    auto base = reinterpret_cast<const int *>(src);
+                    auto right = reinterpret_cast<const int *>(src + C);
+                    auto below = reinterpret_cast<const int *>(src + row_stride);
+                    auto below_right = reinterpret_cast<const int *>(src + row_stride + C);
+                    int32_t i = 0;
+                    for (; i + 8 <= N; i += 8) {
+                        int32_t max_offset = 0;
+                        for (int k = 0; k < 8; ++k) {
+                            auto x = X + (i + k) * A;
+                            auto y = Y + (i + k) * D;
+                            offset[k] = int32_t(y >> 32) * row_stride + int32_t(x >> 32) * C;
+                            wx[k] = int32_t((x >> 17) & 0x7fff);
+                            wy[k] = int32_t((y >> 17) & 0x7fff);
+                            max_offset = std::max(max_offset, offset[k]);
+                        }
+                        // every gather reads 4 bytes
+                        if (int64_t(max_offset) + row_stride + C + 4 > bytes) break;
+                        auto index = _mm256_load_si256(reinterpret_cast<const __m256i *>(offset));
+                        auto p00 = _mm256_i32gather_epi32(base, index, 1);
+                        auto p01 = _mm256_i32gather_epi32(right, index, 1);
+                        auto p10 = _mm256_i32gather_epi32(below, index, 1);
+                        auto p11 = _mm256_i32gather_epi32(below_right, index, 1);
+                        auto vx = _mm256_load_si256(reinterpret_cast<const __m256i *>(wx));
+                        auto vy = _mm256_load_si256(reinterpret_cast<const __m256i *>(wy));
+                        vx = _mm256_or_si256(vx, _mm256_slli_epi32(vx, 16));
+                        vy = _mm256_or_si256(vy, _mm256_slli_epi32(vy, 16));
+                        __m256i half[2];
+                        for (int h = 0; h < 2; ++h) {
+                            auto wx16 = _mm256_permutevar8x32_epi32(vx, h ? hi_index : lo_index);
+                            auto wy16 = _mm256_permutevar8x32_epi32(vy, h ? hi_index : lo_index);
+#define __SEETA_AIP_WIDEN(v) _mm256_cvtepu8_epi16(h ? _mm256_extracti128_si256(v, 1) : _mm256_castsi256_si128(v))
+                            auto a00 = __SEETA_AIP_WIDEN(p00);
+                            auto a01 = __SEETA_AIP_WIDEN(p01);
+                            auto a10 = __SEETA_AIP_WIDEN(p10);
+                            auto a11 = __SEETA_AIP_WIDEN(p11);
+#undef __SEETA_AIP_WIDEN
+                            auto top = _mm256_add_epi16(a00, _mm256_mulhrs_epi16(_mm256_sub_epi16(a01, a00), wx16));
+                            auto bottom = _mm256_add_epi16(a10, _mm256_mulhrs_epi16(_mm256_sub_epi16(a11, a10), wx16));
+                            half[h] = _mm256_add_epi16(top, _mm256_mulhrs_epi16(_mm256_sub_epi16(bottom, top), wy16));
+                        }
+                        auto result = _mm256_permute4x64_epi64(_mm256_packus_epi16(half[0], half[1]), 0xD8);
+                        if (C == 4) {
+                            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), result);
+                        } else {
+                            auto lo = _mm_shuffle_epi8(_mm256_castsi256_si128(result), compact3);
+                            auto hi = _mm_shuffle_epi8(_mm256_extracti128_si256(result, 1), compact3);
+                            _mm_store_si128(reinterpret_cast<__m128i *>(packed), lo);
+                            _mm_store_si128(reinterpret_cast<__m128i *>(packed + 16), hi);
+                            std::memcpy(dst + i * 3, packed, 12);
+                            std::memcpy(dst + i * 3 + 12, packed + 16, 12);
+                        }
+                    }
+                    return i;
+                }
+#endif
+
+#if defined(SEETA_AIP_SIMD_X86)
+                /**
+                 * AVX2 resize row, 8 pixels each block, taps are fetched two by two with gathers.
+                 * Bytes of two taps are interleaved to int16 pairs, then multiplied with weight pairs by madd.
+                 */
+                template<int C>
+                SEETA_AIP_TARGET_AVX2
+                static int32_t avx2_resize_row(const uint8_t *src, int32_t width, int32_t *dst, int32_t N,
+                                               const int32_t *index, const int16_t *weight, int32_t taps) {
+                    const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+                    const __m256i zero = _mm256_setzero_si256();
+                    const __m256i pick[4] = {
+                            _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4),
+                            _mm256_setr_epi32(1, 1, 1, 1, 5, 5, 5, 5),
+                            _mm256_setr_epi32(2, 2, 2, 2, 6, 6, 6, 6),
+                            _mm256_setr_epi32(3, 3, 3, 3, 7, 7, 7, 7),
+                    };
+                    const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                             _mm256_set1_epi32(taps));
+                    auto bytes = int64_t(width) * C;
+                    auto base = reinterpret_cast<const int *>(src);
+                    int32_t i = 0;
+                    for (; i + 8 <= N; i += 8) {
+                        // taps never decrease, so checking last one is enough, every gather reads 4 bytes
+                        if (int64_t(index[(i + 8) * taps - 1]) * C + 4 > bytes) break;
+                        __m256i sum[4] = {zero, zero, zero, zero};
+                        for (int32_t k = 0; k < taps; k += 2) {
+                            __m256i i0, i1, w;
+                            if (taps == 2) {
+                                auto a = _mm256_permutevar8x32_epi32(
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index + i * 2)), split);
+                                auto b = _mm256_permutevar8x32_epi32(
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index + i * 2 + 8)), split);
+                                i0 = _mm256_permute2x128_si256(a, b, 0x20);
+                                i1 = _mm256_permute2x128_si256(a, b, 0x31);
+                                w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weight + i * 2));
+                            } else {
+                                auto offset = i * taps + k;
+                                i0 = _mm256_i32gather_epi32(index + offset, lanes, 4);
+                                i1 = _mm256_i32gather_epi32(index + offset + 1, lanes, 4);
+                                // taps are even, so each weight pair is one int32
+                                w = _mm256_i32gather_epi32(reinterpret_cast<const int *>(weight + offset), lanes, 2);
+                            }
+                            if (C == 4) {
+                                i0 = _mm256_slli_epi32(i0, 2);
+                                i1 = _mm256_slli_epi32(i1, 2);
+                            } else {
+                                i0 = _mm256_add_epi32(i0, _mm256_slli_epi32(i0, 1));
+                                i1 = _mm256_add_epi32(i1, _mm256_slli_epi32(i1, 1));
+                            }
+                            auto p0 = _mm256_i32gather_epi32(base, i0, 1);
+                            auto p1 = _mm256_i32gather_epi32(base, i1, 1);
+                            auto lo = _mm256_unpacklo_epi8(p0, p1);     // pixels 0, 1 | 4, 5
+                            auto hi = _mm256_unpackhi_epi8(p0, p1);     // pixels 2, 3 | 6, 7
+                            sum[0] = _mm256_add_epi32(sum[0], _mm256_madd_epi16(
+                                    _mm256_unpacklo_epi8(lo, zero), _mm256_permutevar8x32_epi32(w, pick[0])));
+                            sum[1] = _mm256_add_epi32(sum[1], _mm256_madd_epi16(
+                                    _mm256_unpackhi_epi8(lo, zero), _mm256_permutevar8x32_epi32(w, pick[1])));
+                            sum[2] = _mm256_add_epi32(sum[2], _mm256_madd_epi16(
+                                    _mm256_unpacklo_epi8(hi, zero), _mm256_permutevar8x32_epi32(w, pick[2])));
+                            sum[3] = _mm256_add_epi32(sum[3], _mm256_madd_epi16(
+                                    _mm256_unpackhi_epi8(hi, zero), _mm256_permutevar8x32_epi32(w, pick[3])));
+                        }
+                        // store in order, so 4th int32 of 3-channel pixel is overwritten by next pixel
+                        for (int k = 0; k < 4; ++k) {
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + k) * C),
+                                             _mm256_castsi256_si128(sum[k]));
+                        }
+                        for (int k = 0; k < 4; ++k) {
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + k + 4) * C),
+                                             _mm256_extracti128_si256(sum[k], 1));
+                        }
+                    }
+                    return i;
+                }
+
+                SEETA_AIP_TARGET_AVX2
+                static int32_t avx2_resize_column(const int32_t *const *rows, const int16_t *weight, int32_t taps,
+                                                  uint8_t *dst, int32_t N) {
+                    auto half = _mm256_set1_epi32(1 << 21);
+                    int32_t i = 0;
+                    for (; i + 16 <= N; i += 16) {
+                        __m256i v[2] = {half, half};
+                        for (int32_t k = 0; k < taps; ++k) {
+                            auto w = _mm256_set1_epi32(weight[k]);
+                            for (int h = 0; h < 2; ++h) {
+                                auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[k] + i + h * 8));
+                                v[h] = _mm256_add_epi32(v[h], _mm256_mullo_epi32(a, w));
+                            }
+                        }
+                        v[0] = _mm256_srai_epi32(v[0], 22);
+                        v[1] = _mm256_srai_epi32(v[1], 22);
+                        auto packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(v[0], v[1]), 0xD8);
+                        auto bytes = _mm_packus_epi16(_mm256_castsi256_si128(packed),
+                                                      _mm256_extracti128_si256(packed, 1));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), bytes);
+                    }
+                    return i;
+                }
+#endif
+
+#if defined(SEETA_AIP_SIMD_X86)
+                SEETA_AIP_TARGET_SSE41
+                static void sse41_transpose8x8_1(const uint8_t *src, ptrdiff_t src_stride,
+                                                 uint8_t *dst, ptrdiff_t dst_stride) {
+                    __m128i r[8];
+                    for (int i = 0; i < 8; ++i) {
+                        r[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i * src_stride));
+                    }
+                    auto a0 = _mm_unpacklo_epi8(r[0], r[1]);
+                    auto a1 = _mm_unpacklo_epi8(r[2], r[3]);
+                    auto a2 = _mm_unpacklo_epi8(r[4], r[5]);
+                    auto a3 = _mm_unpacklo_epi8(r[6], r[7]);
+                    auto b0 = _mm_unpacklo_epi16(a0, a1);   // columns 0 - 3 of rows 0 - 3
+                    auto b1 = _mm_unpackhi_epi16(a0, a1);   // columns 4 - 7 of rows 0 - 3
+                    auto b2 = _mm_unpacklo_epi16(a2, a3);
+                    auto b3 = _mm_unpackhi_epi16(a2, a3);
+                    __m128i c[4] = {
+                            _mm_unpacklo_epi32(b0, b2),     // columns 0, 1
+                            _mm_unpackhi_epi32(b0, b2),     // columns 2, 3
+                            _mm_unpacklo_epi32(b1, b3),     // columns 4, 5
+                            _mm_unpackhi_epi32(b1, b3),     // columns 6, 7
+                    };
+                    for (int i = 0; i < 4; ++i) {
+                        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + (i * 2) * dst_stride), c[i]);
+                        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + (i * 2 + 1) * dst_stride),
+                                         _mm_unpackhi_epi64(c[i], c[i]));
+                    }
+                }
+
+                SEETA_AIP_TARGET_SSE41
+                static void sse41_transpose8x8_2(const uint8_t *src, ptrdiff_t src_stride,
+                                                 uint8_t *dst, ptrdiff_t dst_stride) {
+                    __m128i r[8];
+                    for (int i = 0; i < 8; ++i) {
+                        r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * src_stride));
+                    }
+                    __m128i a[8];
+                    for (int i = 0; i < 4; ++i) {
+                        a[i * 2] = _mm_unpacklo_epi16(r[i * 2], r[i * 2 + 1]);      // columns 0 - 3
+                        a[i * 2 + 1] = _mm_unpackhi_epi16(r[i * 2], r[i * 2 + 1]);  // columns 4 - 7
+                    }
+                    __m128i b[8] = {
+                            _mm_unpacklo_epi32(a[0], a[2]), _mm_unpackhi_epi32(a[0], a[2]),   // rows 0 - 3
+                            _mm_unpacklo_epi32(a[4], a[6]), _mm_unpackhi_epi32(a[4], a[6]),   // rows 4 - 7
+                            _mm_unpacklo_epi32(a[1], a[3]), _mm_unpackhi_epi32(a[1], a[3]),
+                            _mm_unpacklo_epi32(a[5], a[7]), _mm_unpackhi_epi32(a[5], a[7]),
+                    };
+                    for (int i = 0; i < 4; ++i) {
+                        auto top = b[(i / 2) * 4 + i % 2];
+                        auto bottom = b[(i / 2) * 4 + i % 2 + 2];
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i * 2) * dst_stride),
+                                         _mm_unpacklo_epi64(top, bottom));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i * 2 + 1) * dst_stride),
+                                         _mm_unpackhi_epi64(top, bottom));
+                    }
+                }
+
+                /**
+                 * Transpose 4x4 int32 in registers.
+                 */
+                SEETA_AIP_TARGET_SSE41
+                static inline void sse41_transpose4x4_32(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+                    auto a0 = _mm_unpacklo_epi32(r0, r1);
+                    auto a1 = _mm_unpackhi_epi32(r0, r1);
+                    auto a2 = _mm_unpacklo_epi32(r2, r3);
+                    auto a3 = _mm_unpackhi_epi32(r2, r3);
+                    r0 = _mm_unpacklo_epi64(a0, a2);
+                    r1 = _mm_unpackhi_epi64(a0, a2);
+                    r2 = _mm_unpacklo_epi64(a1, a3);
+                    r3 = _mm_unpackhi_epi64(a1, a3);
+                }
+
+                SEETA_AIP_TARGET_SSE41
+                static void sse41_transpose4x4_4(const uint8_t *src, ptrdiff_t src_stride,
+                                                 uint8_t *dst, ptrdiff_t dst_stride) {
+                    auto r0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                    auto r1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + src_stride));
+                    auto r2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * src_stride));
+                    auto r3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * src_stride));
+                    sse41_transpose4x4_32(r0, r1, r2, r3);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), r0);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + dst_stride), r1);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * dst_stride), r2);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 3 * dst_stride), r3);
+                }
+
+                SEETA_AIP_TARGET_SSE41
+                static void sse41_transpose8x8_4(const uint8_t *src, ptrdiff_t src_stride,
+                                                 uint8_t *dst, ptrdiff_t dst_stride) {
+                    sse41_transpose4x4_4(src, src_stride, dst, dst_stride);
+                    sse41_transpose4x4_4(src + 16, src_stride, dst + 4 * dst_stride, dst_stride);
+                    sse41_transpose4x4_4(src + 4 * src_stride, src_stride, dst + 16, dst_stride);
+                    sse41_transpose4x4_4(src + 4 * src_stride + 16, src_stride, dst + 4 * dst_stride + 16, dst_stride);
+                }
+
+                /**
+                 * Transpose 4x4 pixels of 3 bytes, padded to 4 bytes, transposed as int32, then packed back.
+                 * @tparam RIGHT if source pixels are 4 - 7 of 8 pixels, which are loaded from byte 8 to 23
+                 */
+                template<bool RIGHT>
+                SEETA_AIP_TARGET_SSE41
+                static void sse41_transpose4x4_3(const uint8_t *src, ptrdiff_t src_stride,
+                                                 uint8_t *dst, ptrdiff_t dst_stride) {
+                    const __m128i pad = RIGHT
+                                        ? _mm_setr_epi8(4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1)
+                                        : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+                    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+                    src += RIGHT ? 8 : 0;
+                    auto r0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), pad);
+                    auto r1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + src_stride)), pad);
+                    auto r2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * src_stride)), pad);
+                    auto r3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * src_stride)), pad);
+                    sse41_transpose4x4_32(r0, r1, r2, r3);
+                    __m128i rows[4] = {r0, r1, r2, r3};
+                    for (int i = 0; i < 4; ++i) {
+                        auto row = _mm_shuffle_epi8(rows[i], pack);
+                        auto out = dst + i * dst_stride;
+                        _mm_storel_epi64(reinterpret_cast<__m128i *>(out), row);
+                        auto tail = _mm_extract_epi32(row, 2);
+                        std::memcpy(out + 8, &tail, 4);
+                    }
+                }
+
+                SEETA_AIP_TARGET_SSE41
+                static void sse41_transpose8x8_3(const uint8_t *src, ptrdiff_t src_stride,
+                                                 uint8_t *dst, ptrdiff_t dst_stride) {
+                    sse41_transpose4x4_3<false>(src, src_stride, dst, dst_stride);
+                    sse41_transpose4x4_3<true>(src, src_stride, dst + 4 * dst_stride, dst_stride);
+                    sse41_transpose4x4_3<false>(src + 4 * src_stride, src_stride, dst + 12, dst_stride);
+                    sse41_transpose4x4_3<true>(src + 4 * src_stride, src_stride, dst + 4 * dst_stride + 12, dst_stride);
+                }
+
+                /**
+                 * Reverse 3 bytes pixels 5 each block. Block is loaded from one byte before its first pixel,
+                 * and stored with one more byte, which is overwritten by next block or scalar code.
+                 */
+                SEETA_AIP_TARGET_SSE41
+                static int32_t sse41_reverse3(const uint8_t *src, uint8_t *dst, int32_t N) {
+                    const __m128i mask = _mm_setr_epi8(13, 14, 15, 10, 11, 12, 7, 8, 9, 4, 5, 6, 1, 2, 3, -1);
+                    int32_t i = 0;
+                    for (; i + 6 <= N; i += 5) {
+                        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (N - i - 5) * 3 - 1));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 3), _mm_shuffle_epi8(v, mask));
+                    }
+                    return i;
+                }
+
+                template<int S>
+                SEETA_AIP_TARGET_SSE41
+                static int32_t sse41_reverse(const uint8_t *src, uint8_t *dst, int32_t N) {
+                    const __m128i mask = S == 1
+                                         ? _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+                                         : S == 2
+                                           ? _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1)
+                                           : _mm_setr_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+                    const int32_t step = 16 / S;
+                    int32_t i = 0;
+                    for (; i + step <= N; i += step) {
+                        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (N - i - step) * S));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * S), _mm_shuffle_epi8(v, mask));
+                    }
+                    return i;
+                }
+
+                /**
+                 * 16 pixels of C channels are C vectors, byte j of vector k is channel (16 * k + j) % C of
+                 * pixel (16 * k + j) / C. Products fit uint16, exact x / 255 is (x + 1 + (x >> 8)) >> 8.
+                 */
+                template<int C>
+                SEETA_AIP_TARGET_SSE41
+                static inline void sse41_color_pattern(const uint8_t *color, __m128i *pattern) {
+                    alignas(16) uint8_t bytes[16 * C];
+                    for (int i = 0; i < 16 * C; ++i) bytes[i] = color[i % C];
+                    for (int k = 0; k < C; ++k) {
+                        pattern[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes + 16 * k));
+                    }
+                }
+
+                SEETA_AIP_TARGET_SSE41
+                static inline __m128i sse41_div255(__m128i x) {
+                    const __m128i one = _mm_set1_epi16(1);
+                    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+                }
+
+                /**
+                 * Blend 16 bytes, `keep` and `alpha` are uint16 weights of low and high 8 bytes.
+                 */
+                SEETA_AIP_TARGET_SSE41
+                static inline __m128i sse41_blend16(__m128i dst, __m128i target,
+                                                     __m128i keep_lo, __m128i keep_hi,
+                                                     __m128i alpha_lo, __m128i alpha_hi) {
+                    const __m128i zero = _mm_setzero_si128();
+                    auto lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), keep_lo),
+                                            _mm_mullo_epi16(_mm_unpacklo_epi8(target, zero), alpha_lo));
+                    auto hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), keep_hi),
+                                            _mm_mullo_epi16(_mm_unpackhi_epi8(target, zero), alpha_hi));
+                    return _mm_packus_epi16(sse41_div255(lo), sse41_div255(hi));
+                }
+
+                template<int C>
+                SEETA_AIP_TARGET_SSE41
+                static int32_t sse41_blend(uint8_t *dst, int32_t N, const uint8_t *color, int32_t alpha) {
+                    __m128i pattern[C];
+                    sse41_color_pattern<C>(color, pattern);
+                    auto a = _mm_set1_epi16(int16_t(alpha));
+                    auto keep = _mm_set1_epi16(int16_t(255 - alpha));
+                    int32_t i = 0;
+                    for (; i + 16 <= N; i += 16, dst += 16 * C) {
+                        for (int k = 0; k < C; ++k) {
+                            auto p = reinterpret_cast<__m128i *>(dst + 16 * k);
+                            _mm_storeu_si128(p, sse41_blend16(_mm_loadu_si128(p), pattern[k], keep, keep, a, a));
+                        }
+                    }
+                    return i;
+                }
+
+                template<int C>
+                SEETA_AIP_TARGET_SSE41
+                static int32_t sse41_blend_mask(uint8_t *dst, int32_t N, const uint8_t *color, int32_t alpha,
+                                                const uint8_t *coverage) {
+                    __m128i pattern[C];
+                    __m128i spread[C];
+                    sse41_color_pattern<C>(color, pattern);
+                    for (int k = 0; k < C; ++k) {
+                        alignas(16) uint8_t index[16];
+                        for (int j = 0; j < 16; ++j) index[j] = uint8_t((16 * k + j) / C);
+                        spread[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(index));
+                    }
+                    const __m128i zero = _mm_setzero_si128();
+                    const __m128i full = _mm_set1_epi16(255);
+                    auto a = _mm_set1_epi16(int16_t(alpha));
+                    int32_t i = 0;
+                    for (; i + 16 <= N; i += 16, dst += 16 * C) {
+                        auto cover = _mm_loadu_si128(reinterpret_cast<const __m128i *>(coverage + i));
+                        auto pixel_alpha = _mm_packus_epi16(
+                                sse41_div255(_mm_mullo_epi16(_mm_unpacklo_epi8(cover, zero), a)),
+                                sse41_div255(_mm_mullo_epi16(_mm_unpackhi_epi8(cover, zero), a)));
+                        for (int k = 0; k < C; ++k) {
+                            auto byte_alpha = _mm_shuffle_epi8(pixel_alpha, spread[k]);
+                            auto alpha_lo = _mm_unpacklo_epi8(byte_alpha, zero);
+                            auto alpha_hi = _mm_unpackhi_epi8(byte_alpha, zero);
+                            auto p = reinterpret_cast<__m128i *>(dst + 16 * k);
+                            _mm_storeu_si128(p, sse41_blend16(_mm_loadu_si128(p), pattern[k],
+                                                              _mm_sub_epi16(full, alpha_lo),
+                                                              _mm_sub_epi16(full, alpha_hi),
+                                                              alpha_lo, alpha_hi));
+                        }
+                    }
+                    return i;
+                }
+
+                template<int C>
+                SEETA_AIP_TARGET_SSE41
+                static int32_t sse41_fill(uint8_t *dst, int32_t N, const uint8_t *color) {
+                    __m128i pattern[C];
+                    sse41_color_pattern<C>(color, pattern);
+                    int32_t i = 0;
+                    for (; i + 16 <= N; i += 16, dst += 16 * C) {
+                        for (int k = 0; k < C; ++k) {
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16 * k), pattern[k]);
+                        }
+                    }
+                    return i;
+                }
+#endif
+
+#define SEETA_AIP_SIMD_UIMAGE_KERNELS(kernel) \
+                { \
+                    kernel<3, 3, true>,     /* bgr2rgb */ \
+                    kernel<3, 4, false>,    /* bgr2bgra */ \
+                    kernel<3, 4, true>,     /* bgr2rgba */ \
+                    kernel<4, 3, false>,    /* bgra2bgr */ \
+                    kernel<4, 3, true>,     /* bgra2rgb */ \
+                    kernel<4, 4, true>,     /* bgra2rgba */ \
+                    kernel<1, 3, false>,    /* y2bgr */ \
+                    kernel<1, 4, false>,    /* y2bgra */ \
+                    kernel<3, 1, false>,    /* bgr2y */ \
+                    kernel<4, 1, false>,    /* bgra2y */ \
+                    kernel<3, 1, true>,     /* rgb2y */ \
+                    kernel<4, 1, true>,     /* rgba2y */ \
+                }
+            }
+
+            /**
+             * @param level wanted SIMD level, must be supported by running CPU
+             * @return kernels of level, nullptr if level has no kernels
+             */
+            static inline const UImageKernels *uimage_kernels(Level level) {
+                switch (level) {
+                    default:
+                        return nullptr;
+#if defined(SEETA_AIP_SIMD_X86)
+                    case SSE41: {
+                        static const UImageKernels kernels = SEETA_AIP_SIMD_UIMAGE_KERNELS(_::sse41_uimage);
+                        return &kernels;
+                    }
+                    case AVX2: {
+                        static const UImageKernels kernels = SEETA_AIP_SIMD_UIMAGE_KERNELS(_::avx2_uimage);
+                        return &kernels;
+                    }
+#endif
+#if defined(SEETA_AIP_SIMD_NEON)
+                    case NEON: {
+                        static const UImageKernels kernels = SEETA_AIP_SIMD_UIMAGE_KERNELS(_::neon_uimage);
+                        return &kernels;
+                    }
+#endif
+                }
+            }
+
+            /**
+             * @return kernels of running CPU, nullptr if no SIMD supported
+             */
+            static inline const UImageKernels *uimage_kernels() {
+                return uimage_kernels(level());
+            }
+
+            /**
+             * @param level wanted SIMD level, must be supported by running CPU
+             * @return affine kernels of level, nullptr if level has no kernels, only AVX2 has gathers for now
+             */
+            static inline const AffineKernels *affine_kernels(Level level) {
+                switch (level) {
+                    default:
+                        return nullptr;
+#if defined(SEETA_AIP_SIMD_X86)
+                    case AVX2: {
+                        static const AffineKernels kernels = {_::avx2_affine_row<3>, _::avx2_affine_row<4>};
+                        return &kernels;
+                    }
+#endif
+                }
+            }
+
+            /**
+             * @return affine kernels of running CPU, nullptr if not supported
+             */
+            static inline const AffineKernels *affine_kernels() {
+                return affine_kernels(level());
+            }
+
+            /**
+             * @param level wanted SIMD level, must be supported by running CPU
+             * @return resize kernels of level, nullptr if level has no kernels, only AVX2 has gathers for now
+             */
+            static inline const ResizeKernels *resize_kernels(Level level) {
+                switch (level) {
+                    default:
+                        return nullptr;
+#if defined(SEETA_AIP_SIMD_X86)
+                    case AVX2: {
+                        static const ResizeKernels kernels = {
+                                _::avx2_resize_row<3>, _::avx2_resize_row<4>, _::avx2_resize_column};
+                        return &kernels;
+                    }
+#endif
+                }
+            }
+
+            /**
+             * @return resize kernels of running CPU, nullptr if not supported
+             */
+            static inline const ResizeKernels *resize_kernels() {
+                return resize_kernels(level());
+            }
+
+            /**
+             * @param level wanted SIMD level, must be supported by running CPU
+             * @return rotation and flip kernels of level, nullptr if level has no kernels
+             */
+            static inline const OrientKernels *orient_kernels(Level level) {
+                switch (level) {
+                    default:
+                        return nullptr;
+#if defined(SEETA_AIP_SIMD_X86)
+                    case SSE41:
+                    case AVX2: {
+                        // 16 bytes shuffles are enough, AVX2 has no cross lane byte shuffle
+                        static const OrientKernels kernels = {
+                                {nullptr, _::sse41_transpose8x8_1, _::sse41_transpose8x8_2,
+                                 _::sse41_transpose8x8_3, _::sse41_transpose8x8_4},
+                                {nullptr, _::sse41_reverse<1>, _::sse41_reverse<2>,
+                                 _::sse41_reverse3, _::sse41_reverse<4>},
+                        };
+                        return &kernels;
+                    }
+#endif
+                }
+            }
+
+            /**
+             * @return rotation and flip kernels of running CPU, nullptr if not supported
+             */
+            static inline const OrientKernels *orient_kernels() {
+                return orient_kernels(level());
+            }
+
+            /**
+             * @param level wanted SIMD level, must be supported by running CPU
+             * @return plot kernels of level, nullptr if level has no kernels
+             */
+            static inline const BlendKernels *blend_kernels(Level level) {
+                switch (level) {
+                    default:
+                        return nullptr;
+#if defined(SEETA_AIP_SIMD_X86)
+                    case SSE41:
+                    case AVX2: {
+                        // memory bound, 16 bytes vectors are enough
+                        static const BlendKernels kernels = {
+                                {nullptr, _::sse41_blend<1>, _::sse41_blend<2>,
+                                 _::sse41_blend<3>, _::sse41_blend<4>},
+                                {nullptr, _::sse41_blend_mask<1>, _::sse41_blend_mask<2>,
+                                 _::sse41_blend_mask<3>, _::sse41_blend_mask<4>},
+                                {nullptr, _::sse41_fill<1>, _::sse41_fill<2>,
+                                 _::sse41_fill<3>, _::sse41_fill<4>},
+                        };
+                        return &kernels;
+                    }
+#endif
+                }
+            }
+
+            /**
+             * @return plot kernels of running CPU, nullptr if not supported
+             */
+            static inline const BlendKernels *blend_kernels() {
+                return blend_kernels(level());
+            }
+        }
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_SIMD_H
@@ -15,6 +15,8 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <functional>
+#include <mutex>
 
 #if defined(_MSC_VER)
 #define SEETA_AIP_NOEXCEPT
@@ -479,7 +481,17 @@ namespace seeta {
                          : data;
             }
 
+            /**
+             * use external memory, deleter will be called with data once destructed.
+             * @param data external memory
+             * @param deleter nullptr for borrowed memory
+             */
+            AlignMemory(void *data, const std::function<void(void *)> &deleter)
+                : m_data(reinterpret_cast<uint8_t *>(data))
+                , m_deleter(deleter) {}
+
             ~AlignMemory() {
+                if (m_deleter) m_deleter(m_data);
                 free(m_memory);
             }
 
@@ -498,6 +510,34 @@ namespace seeta {
             ImageAlign m_align;
             uint8_t *m_data = nullptr;
             uint8_t *m_memory = nullptr;
+            std::function<void(void *)> m_deleter;
+        };
+
+        class ImageData;
+
+        /**
+         * Strided image accepted by image functions, made from SeetaAIPImageData, SeetaAIPImageDataV2 or ImageData.
+         * SeetaAIPImageData is viewed with zero strides, as packed. No copy happens.
+         */
+        class ImageView : public SeetaAIPImageDataV2 {
+        public:
+            using self = ImageView;
+            using supper = SeetaAIPImageDataV2;
+
+            ImageView() : supper() {}
+
+            ImageView(const SeetaAIPImageDataV2 &image) : supper(image) {}
+
+            ImageView(const SeetaAIPImageData &image) : supper() {
+                format = image.format;
+                data = image.data;
+                number = image.number;
+                height = image.height;
+                width = image.width;
+                channels = image.channels;
+            }
+
+            ImageView(const ImageData &image);
         };
 
         class ImageData : public Wrapper<SeetaAIPImageData> {
@@ -513,6 +553,7 @@ namespace seeta {
                 this->m_raw.height = 0;
                 this->m_raw.channels = 0;
                 m_memory.reset(new AlignMemory({0, 0}, 1));
+                this->m_raw.data = m_memory->data();
             }
 
             ImageData(SEETA_AIP_IMAGE_FORMAT format,
@@ -530,6 +571,7 @@ namespace seeta {
                 this->m_raw.channels = GetChannels(format, channels);
                 auto bytes = this->bytes();
                 m_memory.reset(new AlignMemory({0, 0}, bytes));
+                this->m_raw.data = m_memory->data();
                 if (data) {
                     std::memcpy(m_memory->data(), data, bytes);
                 }
@@ -559,6 +601,7 @@ namespace seeta {
                 this->m_raw.channels = GetChannels(format, channels);
                 auto bytes = this->bytes();
                 m_memory.reset(new AlignMemory(align, bytes));
+                this->m_raw.data = m_memory->data();
                 if (data) {
                     std::memcpy(m_memory->data(), data, bytes);
                 }
@@ -573,6 +616,46 @@ namespace seeta {
                     : self(format, align, 1, width, height, channels, data) {
             }
 
+            /**
+             * Wrap image without copy, the image's data must be kept while using returned image.
+             * @param image
+             * @return borrowed image
+             */
+            static self Borrow(const SeetaAIPImageData &image) {
+                self borrowed;
+                borrowed.m_raw = image;
+                borrowed.m_raw.channels = GetChannels(SEETA_AIP_IMAGE_FORMAT(image.format), image.channels);
+                borrowed.m_type = GetType(SEETA_AIP_IMAGE_FORMAT(image.format));
+                borrowed.m_memory.reset(new AlignMemory(image.data, nullptr));
+                return borrowed;
+            }
+
+            /**
+             * Wrap strided image without copy, the image's data must be kept while using returned image.
+             * @param image strided image, like padded camera buffer
+             * @return borrowed view
+             */
+            static self Borrow(const ImageView &image) {
+                self borrowed = Borrow(SeetaAIPImageData({image.format, image.data,
+                                                          image.number, image.height, image.width, image.channels}));
+                borrowed.m_row_stride = image.row_stride;
+                borrowed.m_image_stride = image.image_stride;
+                borrowed.m_packed = std::make_shared<PackedCopy>();
+                return borrowed;
+            }
+
+            /**
+             * Take ownership of image's data without copy, like buffer allocated by decoder.
+             * @param image packed image
+             * @param deleter called with image's data once the last copy of returned image released
+             * @return image owning the data
+             */
+            static self Adopt(const SeetaAIPImageData &image, const std::function<void(void *)> &deleter) {
+                self adopted = Borrow(image);
+                adopted.m_memory.reset(new AlignMemory(image.data, deleter));
+                return adopted;
+            }
+
             static uint32_t GetChannels(SEETA_AIP_IMAGE_FORMAT format, int channels) {
                 format = SEETA_AIP_IMAGE_FORMAT(format & 0x0000ffff);
                 switch (format) {
@@ -588,6 +671,9 @@ namespace seeta {
                     case SEETA_AIP_FORMAT_U8BGRA:
                         return 4;
                     case SEETA_AIP_FORMAT_U8Y:
+                    case SEETA_AIP_FORMAT_U8NV12:
+                    case SEETA_AIP_FORMAT_U8NV21:
+                    case SEETA_AIP_FORMAT_U8I420:
                         return 1;
                 }
             }
@@ -602,6 +688,9 @@ namespace seeta {
                     case SEETA_AIP_FORMAT_U8RGBA:
                     case SEETA_AIP_FORMAT_U8BGRA:
                     case SEETA_AIP_FORMAT_U8Y:
+                    case SEETA_AIP_FORMAT_U8NV12:
+                    case SEETA_AIP_FORMAT_U8NV21:
+                    case SEETA_AIP_FORMAT_U8I420:
                         return SEETA_AIP_VALUE_BYTE;
                     case SEETA_AIP_FORMAT_F32RAW:
                         return SEETA_AIP_VALUE_FLOAT32;
@@ -610,6 +699,16 @@ namespace seeta {
                 }
             }
 
+            /**
+             * @param format
+             * @return if format is YUV 4:2:0, which has a Y plane followed by chroma planes
+             */
+            static bool IsYUV420(SEETA_AIP_IMAGE_FORMAT format) {
+                return format == SEETA_AIP_FORMAT_U8NV12
+                       || format == SEETA_AIP_FORMAT_U8NV21
+                       || format == SEETA_AIP_FORMAT_U8I420;
+            }
+
             SEETA_AIP_VALUE_TYPE type() const { return m_type; }
 
             _SEETA_AIP_WRAPPER_DECLARE_GETTER(format, SEETA_AIP_IMAGE_FORMAT)
@@ -642,12 +741,100 @@ namespace seeta {
             }
 
             uint32_t bytes() const {
+                if (IsYUV420(format())) return number() * height() * width() * 3 / 2;
                 return number() * height() * width() * channels() * element_width();
             }
 
-            void *data() { return m_memory->data(); }
+            static uint32_t GetElementWidth(SEETA_AIP_IMAGE_FORMAT format) {
+                switch (GetType(format)) {
+                    default: return 0;
+                    case SEETA_AIP_VALUE_BYTE: return 1;
+                    case SEETA_AIP_VALUE_INT32: return 4;
+                    case SEETA_AIP_VALUE_FLOAT32: return 4;
+                }
+            }
+
+            static uint32_t GetBytes(const SeetaAIPImageData &image) {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                if (IsYUV420(format)) return image.number * image.height * image.width * 3 / 2;
+                return image.number * image.height * image.width * GetChannels(format, image.channels)
+                       * GetElementWidth(format);
+            }
+
+            /**
+             * @param image strided image
+             * @return bytes between two rows, packed width if row_stride is 0
+             */
+            static uint32_t GetRowStride(const ImageView &image) {
+                if (image.row_stride) return image.row_stride;
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                return image.width * GetChannels(format, image.channels) * GetElementWidth(format);
+            }
+
+            /**
+             * @param image strided image
+             * @return bytes between two images, packed height if image_stride is 0
+             */
+            static uint32_t GetImageStride(const ImageView &image) {
+                if (image.image_stride) return image.image_stride;
+                if (IsYUV420(SEETA_AIP_IMAGE_FORMAT(image.format))) return image.height * GetRowStride(image) * 3 / 2;
+                return image.height * GetRowStride(image);
+            }
+
+            /**
+             * @param image strided image
+             * @return if image's rows and images are packed, same layout as SeetaAIPImageData
+             */
+            static bool IsPacked(const ImageView &image) {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                auto row = image.width * GetChannels(format, image.channels) * GetElementWidth(format);
+                auto packed_image = IsYUV420(format) ? row * image.height * 3 / 2 : row * image.height;
+                return GetRowStride(image) == row
+                       && (image.number <= 1 || GetImageStride(image) == packed_image);
+            }
+
+            /**
+             * Copy strided image into packed dst, dst must have same size and enough memory.
+             * @param src strided image
+             * @param dst packed memory
+             */
+            static void Pack(const ImageView &src, void *dst) {
+                if (((src.format & 0xffff0000) == 0x80000 || IsYUV420(SEETA_AIP_IMAGE_FORMAT(src.format)))
+                    && !IsPacked(src)) {   // CHW or YUV format
+                    throw Exception("Strided image only support HWC format.");
+                }
+                auto format = SEETA_AIP_IMAGE_FORMAT(src.format);
+                auto row = src.width * GetChannels(format, src.channels) * GetElementWidth(format);
+                auto row_stride = GetRowStride(src);
+                auto image_stride = GetImageStride(src);
+                auto src_data = reinterpret_cast<const uint8_t *>(src.data);
+                auto dst_data = reinterpret_cast<uint8_t *>(dst);
+                for (uint32_t n = 0; n < src.number; ++n) {
+                    auto src_image = src_data + size_t(n) * image_stride;
+                    for (uint32_t y = 0; y < src.height; ++y) {
+                        std::memcpy(dst_data, src_image + size_t(y) * row_stride, row);
+                        dst_data += row;
+                    }
+                }
+            }
 
-            const void *data() const { return  m_memory->data(); }
+            /**
+             * @param buffer pre-allocated image buffer
+             * @param image wanted image
+             * @return if image can be written into buffer, with same format and enough memory.
+             */
+            static bool Fits(const SeetaAIPImageData &buffer, const SeetaAIPImageData &image) {
+                return buffer.data != nullptr
+                       && buffer.format == image.format
+                       && GetBytes(buffer) >= GetBytes(image);
+            }
+
+            /**
+             * @return pointer to the first pixel, rows are row_stride() bytes apart
+             */
+            void *data() { return m_memory->data<uint8_t>() + m_offset; }
+
+            const void *data() const { return  m_memory->data<uint8_t>() + m_offset; }
 
             template<typename T>
             T *data() { return reinterpret_cast<T *>(data()); }
@@ -669,8 +856,121 @@ namespace seeta {
 
             std::vector<uint32_t> dims() const { return {number(), height(), width(), channels()}; }
 
+            /**
+             * @return bytes between two rows
+             */
+            uint32_t row_stride() const {
+                return GetRowStride(*this);
+            }
+
+            /**
+             * @return bytes between two images
+             */
+            uint32_t image_stride() const {
+                return GetImageStride(*this);
+            }
+
+            /**
+             * @return if data is packed, as SeetaAIPImageData declared
+             */
+            bool packed() const {
+                return IsPacked(*this);
+            }
+
+            /**
+             * Get non-owning view of region, sharing memory with this image.
+             * Only HWC format supported.
+             * @param x left of region
+             * @param y top of region
+             * @param width width of region
+             * @param height height of region
+             * @return strided view
+             */
+            self roi(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const {
+                if ((this->format() & 0xffff0000) == 0x80000 || IsYUV420(this->format())) {   // CHW or YUV format
+                    throw Exception("ROI only support HWC format.");
+                }
+                if (x > this->width() || y > this->height()
+                    || width > this->width() - x || height > this->height() - y) {
+                    std::ostringstream oss;
+                    oss << "ROI(" << x << ", " << y << ", " << width << ", " << height << ") out of image("
+                        << this->width() << ", " << this->height() << ")";
+                    throw Exception(oss.str());
+                }
+                self view = *this;
+                view.m_row_stride = this->row_stride();
+                view.m_image_stride = this->image_stride();
+                view.m_offset = m_offset + size_t(y) * this->row_stride() + size_t(x) * channels() * element_width();
+                view.m_raw.width = width;
+                view.m_raw.height = height;
+                view.m_raw.data = view.data();
+                view.m_packed = std::make_shared<PackedCopy>();
+                return view;
+            }
+
+            /**
+             * Get Y plane of YUV 4:2:0 image as U8Y format, sharing memory with this image.
+             * @return gray view, strided if number > 1
+             */
+            self y_plane() const {
+                if (!IsYUV420(this->format())) {
+                    std::ostringstream oss;
+                    oss << "Y plane only exists in YUV format, got format " << int(format());
+                    throw Exception(oss.str());
+                }
+                self view = *this;
+                view.m_raw.format = SEETA_AIP_FORMAT_U8Y;
+                view.m_raw.channels = 1;
+                view.m_row_stride = this->row_stride();
+                view.m_image_stride = this->image_stride();
+                view.m_packed = std::make_shared<PackedCopy>();
+                return view;
+            }
+
+            /**
+             * @return packed image, it is this image if already packed, or a packed copy of view
+             */
+            self compact() const {
+                if (packed()) return *this;
+                self dolly(format(), number(), width(), height(), channels());
+                Pack(*this, dolly.data());
+                return dolly;
+            }
+
+            /**
+             * Export strided view, no copy happens.
+             */
+            operator SeetaAIPImageDataV2() const {
+                SeetaAIPImageDataV2 image;
+                image.format = m_raw.format;
+                image.data = const_cast<void *>(data());
+                image.number = m_raw.number;
+                image.height = m_raw.height;
+                image.width = m_raw.width;
+                image.channels = m_raw.channels;
+                image.row_stride = m_row_stride;
+                image.image_stride = m_image_stride;
+                return image;
+            }
+
+            /**
+             * SeetaAIPImageData has no strides, so view will be exported as packed copy.
+             * The copy is made once at first export and shared by copies of the view,
+             * pixels written into view after that are not exported, export compact() instead.
+             * Exporting same image from many threads is safe, data of packed image is never rewritten.
+             */
             void exporter() override {
-                m_raw.data = m_memory->data();
+                if (packed()) {
+                    if (m_raw.data != data()) m_raw.data = data();
+                    return;
+                }
+                auto copy = m_packed.get();
+                std::unique_lock<std::mutex> _locker(copy->mutex);
+                if (!copy->memory) {
+                    copy->memory.reset(new AlignMemory({0, 0}, bytes()));
+                    Pack(*this, copy->memory->data());
+                }
+                if (m_raw.data != copy->memory->data()) m_raw.data = copy->memory->data();
             }
 
             void importer() override {
@@ -678,6 +978,11 @@ namespace seeta {
                 auto bytes = this->bytes();
                 m_memory.reset(new AlignMemory({0, 0}, bytes));
                 std::memcpy(m_memory->data(), m_raw.data, bytes);
+                m_raw.data = m_memory->data();
+                m_packed.reset();
+                m_offset = 0;
+                m_row_stride = 0;
+                m_image_stride = 0;
             }
 
             using supper::raw;
@@ -688,6 +993,11 @@ namespace seeta {
                 auto bytes = this->bytes();
                 m_memory.reset(new AlignMemory(align, bytes));
                 std::memcpy(m_memory->data(), m_raw.data, bytes);
+                m_raw.data = m_memory->data();
+                m_packed.reset();
+                m_offset = 0;
+                m_row_stride = 0;
+                m_image_stride = 0;
             }
 
             const ImageAlign &align() const { return m_memory->align(); }
@@ -699,9 +1009,19 @@ namespace seeta {
             }
         private:
             std::shared_ptr<AlignMemory> m_memory;
+            struct PackedCopy {
+                std::mutex mutex;
+                std::shared_ptr<AlignMemory> memory;
+            };
+            std::shared_ptr<PackedCopy> m_packed;   ///< packed copy exported for strided view, new for each view
             SEETA_AIP_VALUE_TYPE m_type;
+            size_t m_offset = 0;        ///< offset of first pixel in memory
+            uint32_t m_row_stride = 0;  ///< 0 for packed
+            uint32_t m_image_stride = 0;    ///< 0 for packed
         };
 
+        inline ImageView::ImageView(const ImageData &image) : supper(SeetaAIPImageDataV2(image)) {}
+
         class Device : public Wrapper<SeetaAIPDevice> {
         public:
             using self = Device;
@@ -760,6 +1080,9 @@ namespace seeta {
                 case SEETA_AIP_FORMAT_U8RGBA: return "U8RGBA";
                 case SEETA_AIP_FORMAT_U8BGRA: return "U8BGRA";
                 case SEETA_AIP_FORMAT_U8Y: return "U8Y";
+                case SEETA_AIP_FORMAT_U8NV12: return "U8NV12";
+                case SEETA_AIP_FORMAT_U8NV21: return "U8NV21";
+                case SEETA_AIP_FORMAT_U8I420: return "U8I420";
                 case SEETA_AIP_FORMAT_CHW_U8RAW: return "CHW_U8Raw";
                 case SEETA_AIP_FORMAT_CHW_F32RAW: return "CHW_F32RAW";
                 case SEETA_AIP_FORMAT_CHW_I32RAW: return "CHW_I32RAW";
@@ -771,6 +1094,15 @@ namespace seeta {
             }
         }
 
+        /**
+         * Read-only property name, which is non-zero if package accepts input images in given format.
+         * @param format image format
+         * @return property name like "accept_format.U8NV12"
+         */
+        static inline std::string accept_format_property(int format) {
+            return std::string("accept_format.") + format_string(format);
+        }
+
         static inline const char *type_string(int type) {
             switch (type) {
                 default: return "Unknown";
@@ -0,0 +1,283 @@
+#ifndef SEETA_AIP_SEETA_AIP_WARP_H
+#define SEETA_AIP_SEETA_AIP_WARP_H
+
+#include "seeta_aip_affine.h"
+
+#include <vector>
+
+namespace seeta {
+    namespace aip {
+        namespace _ {
+            /**
+             * Border pixel of warp map, partly inside source, sampled exactly at 32.32 fixed point position.
+             */
+            struct WarpBorder {
+                int32_t i;
+                int64_t X;
+                int64_t Y;
+            };
+
+            /**
+             * Compiled row of affine warp, pixels in [begin, end) have all 2x2 neighbors inside source,
+             * pixels out of [first, last) are all outside, others are border pixels.
+             */
+            struct WarpRow {
+                int32_t first;
+                int32_t begin;
+                int32_t end;
+                int32_t last;
+                int64_t X;              ///< fixed point source x of pixel begin
+                int64_t Y;              ///< fixed point source y of pixel begin
+                size_t border;          ///< first border pixel of row
+                size_t border_end;      ///< last border pixel of row (not included)
+            };
+
+            static inline void warp_border(const AffinePlanes &src, const WarpBorder &border,
+                                           uint8_t *out, size_t out_shift) {
+                sample_linear_pixel(src, float(double(border.X) / fixed_one), float(double(border.Y) / fixed_one),
+                                    out, out_shift);
+            }
+
+            static inline void warp_border(const AffinePlanes &src, const WarpBorder &border,
+                                           float *out, size_t out_shift) {
+                sample_linear_pixel(src, float(double(border.X) / fixed_one), float(double(border.Y) / fixed_one),
+                                    out, out_shift);
+            }
+
+            static inline void warp_border(const AffinePlanes &src, const WarpBorder &border,
+                                           int32_t *out, size_t out_shift) {
+                auto half = to_fixed(0.5);
+                sample_nearest_pixel(src, (border.X + half) >> 32, (border.Y + half) >> 32, out, out_shift);
+            }
+
+            /**
+             * Interior of warp row, same kernels as affine_sample2d.
+             */
+            static inline void warp_interior(const AffinePlanes &src, uint8_t *out, int32_t N,
+                                             int64_t X, int64_t Y, int64_t A, int64_t D) {
+                auto C = src.channels;
+                auto image_bytes = (int64_t(src.height) - 1) * int64_t(src.row_stride) + int64_t(src.width) * C;
+                auto kernels = simd::affine_kernels();
+                simd::AffineRowKernel kernel = nullptr;
+                if (kernels && image_bytes < INT32_MAX) {
+                    kernel = C == 3 ? kernels->c3 : (C == 4 ? kernels->c4 : nullptr);
+                }
+                int32_t done = 0;
+                if (kernel) {
+                    done = kernel(src.data, int32_t(src.row_stride), int32_t(image_bytes), out, N, X, Y, A, D);
+                }
+                affine_row_uint8(src.data, src.row_stride, out + size_t(done) * C, N - done, C,
+                                 X + done * A, Y + done * D, A, D);
+            }
+
+            static inline void warp_interior(const AffinePlanes &src, float *out, int32_t N,
+                                             int64_t X, int64_t Y, int64_t A, int64_t D) {
+                affine_row_float(src.data, src.row_stride, out, N, src.channels, X, Y, A, D);
+            }
+
+            static inline void warp_interior(const AffinePlanes &src, int32_t *out, int32_t N,
+                                             int64_t X, int64_t Y, int64_t A, int64_t D) {
+                auto pixel = size_t(src.channels) * sizeof(int32_t);
+                auto half = to_fixed(0.5);
+                X += half;
+                Y += half;
+                for (int32_t i = 0; i < N; ++i, X += A, Y += D, out += src.channels) {
+                    std::memcpy(out, src.data + size_t(Y >> 32) * src.row_stride + size_t(X >> 32) * pixel, pixel);
+                }
+            }
+        }
+
+        /**
+         * Affine warp compiled for fixed transform, source size and output size.
+         * Each output row is split once into outside, border and interior pixels, with fixed point source
+         * position of interior pixels, so applying the warp to each frame only fills, samples border pixels
+         * and runs interior kernels. Result is same as affine_sample2d with same arguments.
+         * The map is never changed after built, so one map could be applied by many threads at same time.
+         */
+        class WarpMap {
+        public:
+            using self = WarpMap;
+
+            WarpMap() = default;
+
+            /**
+             * @param M affine 3x3 matrix, src = M * dst, same as affine_sample2d
+             * @param src_width width of images to be warped
+             * @param src_height height of images to be warped
+             * @param x sample dest image start x
+             * @param y sample dest image start y
+             * @param width warped image width
+             * @param height warped image height
+             */
+            WarpMap(const float *M, int32_t src_width, int32_t src_height,
+                    int32_t x, int32_t y, int32_t width, int32_t height)
+                    : m_src_width(src_width), m_src_height(src_height), m_width(width), m_height(height) {
+                if (src_width < 0 || src_height < 0 || width < 0 || height < 0) {
+                    throw Exception("Warp map got negative size.");
+                }
+                std::copy(M, M + 9, m_M);
+                build(x, y);
+            }
+
+            /**
+             * @param M affine transform, src = M * dst
+             * @param src_width width of images to be warped
+             * @param src_height height of images to be warped
+             * @param width warped image width
+             * @param height warped image height
+             */
+            WarpMap(const Trans2D<float> &M, int32_t src_width, int32_t src_height, int32_t width, int32_t height)
+                    : self(M.data(), src_width, src_height, 0, 0, width, height) {}
+
+            int32_t src_width() const { return m_src_width; }
+
+            int32_t src_height() const { return m_src_height; }
+
+            int32_t width() const { return m_width; }
+
+            int32_t height() const { return m_height; }
+
+            /**
+             * Warp image into caller provided memory.
+             * @param threads executor running kernels, or number of threads
+             * @param image source image of `src_width x src_height`, could be strided HWC view.
+             *              BYTE and FLOAT32 are bilinear sampled, INT32 is nearest sampled.
+             * @param output packed image with same format, number and channels, shape `width x height`
+             */
+            void apply(const Executor &threads, const ImageView &image,
+                       const SeetaAIPImageData &output) const {
+                auto format = SEETA_AIP_IMAGE_FORMAT(image.format);
+                _::affine_check(image);
+                if (int32_t(image.width) != m_src_width || int32_t(image.height) != m_src_height) {
+                    throw Exception("Warp map built for " + std::to_string(m_src_width) + "x" +
+                                    std::to_string(m_src_height) + " image, got " + std::to_string(image.width) +
+                                    "x" + std::to_string(image.height));
+                }
+                if (output.format != image.format || output.number != image.number
+                    || int32_t(output.width) != m_width || int32_t(output.height) != m_height
+                    || ImageData::GetChannels(format, output.channels)
+                       != ImageData::GetChannels(format, image.channels)) {
+                    throw Exception("Warp map got mismatched output image.");
+                }
+                auto src = _::affine_planes(image);
+                if (src.number == 0 || m_width == 0 || m_height == 0) return;
+                switch (ImageData::GetType(format)) {
+                    default:
+                    case SEETA_AIP_VALUE_BYTE:
+                        apply(threads, src, reinterpret_cast<uint8_t *>(output.data));
+                        break;
+                    case SEETA_AIP_VALUE_FLOAT32:
+                        apply(threads, src, reinterpret_cast<float *>(output.data));
+                        break;
+                    case SEETA_AIP_VALUE_INT32:
+                        apply(threads, src, reinterpret_cast<int32_t *>(output.data));
+                        break;
+                }
+            }
+
+            /**
+             * @param threads executor running kernels, or number of threads
+             * @param image source image of `src_width x src_height`, could be strided HWC view
+             * @return warped image with same format, shape `width x height`
+             */
+            ImageData apply(const Executor &threads, const ImageView &image) const {
+                ImageData output(SEETA_AIP_IMAGE_FORMAT(image.format), image.number, m_width, m_height,
+                                 ImageData::GetChannels(SEETA_AIP_IMAGE_FORMAT(image.format), image.channels));
+                apply(threads, image, output);
+                return output;
+            }
+
+        private:
+            /**
+             * Split each row same as affine_sample2d, continuous interior pixels and border pixels on both sides.
+             */
+            void build(int32_t left, int32_t top) {
+                auto A = _::to_fixed(m_M[0]);
+                auto D = _::to_fixed(m_M[3]);
+                auto SRC_W = int64_t(m_src_width);
+                auto SRC_H = int64_t(m_src_height);
+                m_A = A;
+                m_D = D;
+                auto inside = [&](int64_t px, int64_t py) {
+                    return px >= 0 && py >= 0 && (px >> 32) < SRC_W - 1 && (py >> 32) < SRC_H - 1;
+                };
+                // same test as GetSampleRatio, on position passed to it
+                auto touched = [&](int64_t px, int64_t py) {
+                    auto x = float(double(px) / _::fixed_one);
+                    auto y = float(double(py) / _::fixed_one);
+                    return x >= -1 && x < float(SRC_W) && y >= -1 && y < float(SRC_H);
+                };
+                m_rows.resize(m_height);
+                for (int32_t j = 0; j < m_height; ++j) {
+                    auto X = _::to_fixed(double(m_M[0]) * left + double(m_M[1]) * (top + j) + double(m_M[2]));
+                    auto Y = _::to_fixed(double(m_M[3]) * left + double(m_M[4]) * (top + j) + double(m_M[5]));
+                    auto &row = m_rows[j];
+                    row.border = m_borders.size();
+                    row.first = m_width;
+                    row.last = 0;
+                    auto border = [&](int32_t i) {
+                        auto px = X + int64_t(i) * A;
+                        auto py = Y + int64_t(i) * D;
+                        if (!touched(px, py)) return;
+                        _::WarpBorder pixel = {i, px, py};
+                        m_borders.push_back(pixel);
+                        row.first = std::min(row.first, i);
+                        row.last = std::max(row.last, i + 1);
+                    };
+                    int32_t begin = 0;
+                    while (begin < m_width && !inside(X + begin * A, Y + begin * D)) border(begin++);
+                    int32_t end = m_width;
+                    while (end > begin && !inside(X + (end - 1) * A, Y + (end - 1) * D)) border(--end);
+                    row.border_end = m_borders.size();
+                    row.begin = begin;
+                    row.end = std::max(begin, end);
+                    if (row.begin < row.end) {
+                        row.first = std::min(row.first, row.begin);
+                        row.last = std::max(row.last, row.end);
+                    }
+                    if (row.first > row.last) row.first = row.last = 0;
+                    row.X = X + begin * A;
+                    row.Y = Y + begin * D;
+                }
+            }
+
+            template<typename T>
+            void apply(const Executor &threads, const _::AffinePlanes &src, T *out) const {
+                auto C = src.channels;
+                auto out_shift = size_t(m_width) * m_height * C;
+                parallel_for(threads, 0, m_height, [&](int32_t j) {
+                    auto &row = m_rows[j];
+                    auto row_out = out + size_t(j) * m_width * C;
+                    for (int32_t n = 0; n < src.number; ++n) {
+                        auto plane_out = row_out + size_t(n) * out_shift;
+                        std::fill(plane_out, plane_out + size_t(row.first) * C, T(0));
+                        std::fill(plane_out + size_t(row.last) * C, plane_out + size_t(m_width) * C, T(0));
+                    }
+                    for (auto b = row.border; b < row.border_end; ++b) {
+                        auto &border = m_borders[b];
+                        _::warp_border(src, border, row_out + size_t(border.i) * C, out_shift);
+                    }
+                    if (row.begin >= row.end) return;
+                    auto plane = src;
+                    for (int32_t n = 0; n < src.number; ++n) {
+                        plane.data = src.data + size_t(n) * src.image_stride;
+                        _::warp_interior(plane, row_out + size_t(n) * out_shift + size_t(row.begin) * C,
+                                         row.end - row.begin, row.X, row.Y, m_A, m_D);
+                    }
+                });
+            }
+
+            float m_M[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+            int32_t m_src_width = 0;
+            int32_t m_src_height = 0;
+            int32_t m_width = 0;
+            int32_t m_height = 0;
+            int64_t m_A = 0;    ///< fixed point source x step along row
+            int64_t m_D = 0;    ///< fixed point source y step along row
+            std::vector<_::WarpRow> m_rows;
+            std::vector<_::WarpBorder> m_borders;
+        };
+    }
+}
+
+#endif //SEETA_AIP_SEETA_AIP_WARP_H
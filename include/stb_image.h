@@ -1811,6 +1811,7 @@ typedef struct
 
    int scan_n, order[4];
    int restart_interval, todo;
+   int scale;  // seeta_aip: decode to 1/(1<<scale) size in DCT domain, 0..3
 
 // kernels
    void (*idct_block_kernel)(stbi_uc *out, int out_stride, short data[64]);
@@ -2750,6 +2751,52 @@ static void stbi__jpeg_reset(stbi__jpeg *j)
    // since we don't even allow 1<<30 pixels
 }
 
+// seeta_aip: reduced size IDCT, the 8x8 block's continuous reconstruction sampled at centers of NxN pixels,
+// using only the NxN lowest frequency coefficients. table[N][u][x] = C(u) / 2 * cos((2x+1)u*pi/(2N))
+static const float stbi__idct_reduced_table[3][4][4] = {
+   { { 0.35355339f } },
+   { { 0.35355339f, 0.35355339f }, { 0.35355339f, -0.35355339f } },
+   { { 0.35355339f, 0.35355339f, 0.35355339f, 0.35355339f },
+     { 0.46193977f, 0.19134172f, -0.19134172f, -0.46193977f },
+     { 0.35355339f, -0.35355339f, -0.35355339f, 0.35355339f },
+     { 0.19134172f, -0.46193977f, 0.46193977f, -0.19134172f } },
+};
+
+static void stbi__idct_reduced(stbi_uc *out, int out_stride, short data[64], int scale)
+{
+   int n = 8 >> scale, u, v, x, y;
+   const float (*t)[4] = stbi__idct_reduced_table[3 - scale];
+   float rows[4][4];
+   if (scale == 3) {
+      out[0] = stbi__clamp(((data[0] + 4) >> 3) + 128);
+      return;
+   }
+   // columns of each used frequency row, then rows
+   for (v=0; v < n; ++v)
+      for (x=0; x < n; ++x) {
+         float sum = 0;
+         for (u=0; u < n; ++u) sum += t[u][x] * data[v*8+u];
+         rows[v][x] = sum;
+      }
+   for (y=0; y < n; ++y)
+      for (x=0; x < n; ++x) {
+         float sum = 128.5f;
+         for (v=0; v < n; ++v) sum += t[v][y] * rows[v][x];
+         out[y*out_stride+x] = stbi__clamp((int) floorf(sum));
+      }
+}
+
+// seeta_aip: idct of block at (x, y) of component in full resolution pixels
+static void stbi__jpeg_idct_at(stbi__jpeg *z, int n, int x, int y, short data[64])
+{
+   stbi_uc *out = z->img_comp[n].data;
+   int w2 = z->img_comp[n].w2;
+   if (z->scale)
+      stbi__idct_reduced(out + w2*(y >> z->scale) + (x >> z->scale), w2, data, z->scale);
+   else
+      z->idct_block_kernel(out + w2*y + x, w2, data);
+}
+
 static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
 {
    stbi__jpeg_reset(z);
@@ -2768,7 +2815,7 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                int ha = z->img_comp[n].ha;
                if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               stbi__jpeg_idct_at(z, n, i*8, j*8, data);
                // every data block is an MCU, so countdown the restart interval
                if (--z->todo <= 0) {
                   if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
@@ -2796,7 +2843,7 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
                         int y2 = (j*z->img_comp[n].v + y)*8;
                         int ha = z->img_comp[n].ha;
                         if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-                        z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
+                        stbi__jpeg_idct_at(z, n, x2, y2, data);
                      }
                   }
                }
@@ -2893,7 +2940,7 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
                stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               stbi__jpeg_idct_at(z, n, i*8, j*8, data);
             }
          }
       }
@@ -3128,6 +3175,11 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       z->img_comp[i].coeff = 0;
       z->img_comp[i].raw_coeff = 0;
       z->img_comp[i].linebuf = NULL;
+      // seeta_aip: coefficients are kept in full size, pixels in reduced size
+      z->img_comp[i].coeff_w = z->img_comp[i].w2 / 8;
+      z->img_comp[i].coeff_h = z->img_comp[i].h2 / 8;
+      z->img_comp[i].w2 >>= z->scale;
+      z->img_comp[i].h2 >>= z->scale;
       z->img_comp[i].raw_data = stbi__malloc_mad2(z->img_comp[i].w2, z->img_comp[i].h2, 15);
       if (z->img_comp[i].raw_data == NULL)
          return stbi__free_jpeg_components(z, i+1, stbi__err("outofmem", "Out of memory"));
@@ -3135,9 +3187,7 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       z->img_comp[i].data = (stbi_uc*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
       if (z->progressive) {
          // w2, h2 are multiples of 8 (see above)
-         z->img_comp[i].coeff_w = z->img_comp[i].w2 / 8;
-         z->img_comp[i].coeff_h = z->img_comp[i].h2 / 8;
-         z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].w2, z->img_comp[i].h2, sizeof(short), 15);
+         z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].coeff_w * 8, z->img_comp[i].coeff_h * 8, sizeof(short), 15);
          if (z->img_comp[i].raw_coeff == NULL)
             return stbi__free_jpeg_components(z, i+1, stbi__err("outofmem", "Out of memory"));
          z->img_comp[i].coeff = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
@@ -3595,6 +3645,7 @@ static void stbi__YCbCr_to_RGB_simd(stbi_uc *out, stbi_uc const *y, stbi_uc cons
 // set up the kernels
 static void stbi__setup_jpeg(stbi__jpeg *j)
 {
+   j->scale = 0;
    j->idct_block_kernel = stbi__idct_block;
    j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_row;
    j->resample_row_hv_2_kernel = stbi__resample_row_hv_2;
@@ -3648,6 +3699,17 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
    // load a jpeg image from whichever source, but leave in YCbCr format
    if (!stbi__decode_jpeg_image(z)) { stbi__cleanup_jpeg(z); return NULL; }
 
+   // seeta_aip: components were decoded in reduced size
+   if (z->scale) {
+      int k, round = (1 << z->scale) - 1;
+      z->s->img_x = (z->s->img_x + round) >> z->scale;
+      z->s->img_y = (z->s->img_y + round) >> z->scale;
+      for (k=0; k < z->s->img_n; ++k) {
+         z->img_comp[k].x = (z->img_comp[k].x + round) >> z->scale;
+         z->img_comp[k].y = (z->img_comp[k].y + round) >> z->scale;
+      }
+   }
+
    // determine actual number of components to generate
    n = req_comp ? req_comp : z->s->img_n >= 3 ? 3 : 1;
 
@@ -1071,7 +1071,9 @@ static void stbiw__encode_png_line(unsigned char *pixels, int stride_bytes, int
    }
 }
 
-STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len)
+// seeta_aip: zlib level of each call, bgr for B, G, R ordered channels.
+// Filters work on each channel alone, so filtered BGR line is swapped into RGB order.
+static unsigned char *stbiw__png_to_mem_ex(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len, int level, int bgr)
 {
    int force_filter = stbi_write_force_png_filter;
    int ctype[5] = { -1, 0, 4, 2, 6 };
@@ -1115,11 +1117,19 @@ STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int s
          }
       }
       // when we get here, filter_type contains the filter type, and line_buffer contains the data
+      if (bgr && n >= 3) {
+         int i;
+         for (i = 0; i < x*n; i += n) {
+            signed char t = line_buffer[i];
+            line_buffer[i] = line_buffer[i+2];
+            line_buffer[i+2] = t;
+         }
+      }
       filt[j*(x*n+1)] = (unsigned char) filter_type;
       STBIW_MEMMOVE(filt+j*(x*n+1)+1, line_buffer, x*n);
    }
    STBIW_FREE(line_buffer);
-   zlib = stbi_zlib_compress(filt, y*( x*n+1), &zlen, stbi_write_png_compression_level);
+   zlib = stbi_zlib_compress(filt, y*( x*n+1), &zlen, level);
    STBIW_FREE(filt);
    if (!zlib) return 0;
 
@@ -1157,6 +1167,11 @@ STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int s
    return out;
 }
 
+STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len)
+{
+   return stbiw__png_to_mem_ex(pixels, stride_bytes, x, y, n, out_len, stbi_write_png_compression_level, 0);
+}
+
 #ifndef STBI_WRITE_NO_STDIO
 STBIWDEF int stbi_write_png(char const *filename, int x, int y, int comp, const void *data, int stride_bytes)
 {
@@ -1336,7 +1351,8 @@ static int stbiw__jpg_processDU(stbi__write_context *s, int *bitBuf, int *bitCnt
    return DU[0];
 }
 
-static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, int comp, const void* data, int quality) {
+// seeta_aip: rows of stride_bytes apart, bgr for B, G, R ordered channels, so no converted copy is needed
+static int stbiw__jpg_core_ex(stbi__write_context *s, int width, int height, int comp, const void* data, int quality, int stride_bytes, int bgr) {
    // Constants that don't pollute global namespace
    static const unsigned char std_dc_luminance_nrcodes[] = {0,0,1,5,1,1,1,1,1,1,0,0,0,0,0,0,0};
    static const unsigned char std_dc_luminance_values[] = {0,1,2,3,4,5,6,7,8,9,10,11};
@@ -1466,21 +1482,23 @@ static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, in
       int DCY=0, DCU=0, DCV=0;
       int bitBuf=0, bitCnt=0;
       // comp == 2 is grey+alpha (alpha is ignored)
-      int ofsG = comp > 2 ? 1 : 0, ofsB = comp > 2 ? 2 : 0;
+      int ofsR = comp > 2 && bgr ? 2 : 0, ofsG = comp > 2 ? 1 : 0, ofsB = comp > 2 && !bgr ? 2 : 0;
       int x, y, pos;
+      if (stride_bytes == 0)
+         stride_bytes = width*comp;
       for(y = 0; y < height; y += 8) {
          for(x = 0; x < width; x += 8) {
             float YDU[64], UDU[64], VDU[64];
             for(row = y, pos = 0; row < y+8; ++row) {
                // row >= height => use last input row
                int clamped_row = (row < height) ? row : height - 1;
-               int base_p = (stbi__flip_vertically_on_write ? (height-1-clamped_row) : clamped_row)*width*comp;
+               int base_p = (stbi__flip_vertically_on_write ? (height-1-clamped_row) : clamped_row)*stride_bytes;
                for(col = x; col < x+8; ++col, ++pos) {
                   float r, g, b;
                   // if col >= width => use pixel from last input column
                   int p = base_p + ((col < width) ? col : (width-1))*comp;
 
-                  r = imageData[p+0];
+                  r = imageData[p+ofsR];
                   g = imageData[p+ofsG];
                   b = imageData[p+ofsB];
                   YDU[pos]=+0.29900f*r+0.58700f*g+0.11400f*b-128;
@@ -1506,6 +1524,10 @@ static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, in
    return 1;
 }
 
+static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, int comp, const void* data, int quality) {
+   return stbiw__jpg_core_ex(s, width, height, comp, data, quality, 0, 0);
+}
+
 STBIWDEF int stbi_write_jpg_to_func(stbi_write_func *func, void *context, int x, int y, int comp, const void *data, int quality)
 {
    stbi__write_context s;
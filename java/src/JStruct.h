@@ -410,6 +410,9 @@ public:
         this->bind("U8Rgba", SEETA_AIP_FORMAT_U8RGBA);
         this->bind("U8Bgra", SEETA_AIP_FORMAT_U8BGRA);
         this->bind("U8Y", SEETA_AIP_FORMAT_U8Y);
+        this->bind("U8Nv12", SEETA_AIP_FORMAT_U8NV12);
+        this->bind("U8Nv21", SEETA_AIP_FORMAT_U8NV21);
+        this->bind("U8I420", SEETA_AIP_FORMAT_U8I420);
     }
 };
 
@@ -451,7 +454,9 @@ public:
         auto java_width = jint(object.width);
         auto java_channels = jint(object.channels);
 
-        auto N = jsize(java_number * java_height * java_width * java_channels);
+        // YUV 4:2:0 images have 3/2 bytes per pixel, so count elements by bytes
+        auto N = jsize(seeta::aip::ImageData::GetBytes(object) /
+                       seeta::aip::ImageData::GetElementWidth(SEETA_AIP_IMAGE_FORMAT(object.format)));
 
         auto java_image = AutoJObject(env, construct());
 
@@ -517,8 +522,6 @@ public:
 
         auto native_format = clazz_image_format.convert(java_format);
 
-        auto N = jsize(java_number * java_height * java_width * java_channels);
-
         auto result = NativeObject(SEETA_AIP_IMAGE_FORMAT(native_format),
                                    uint32_t(java_number),
                                    uint32_t(java_width),
@@ -526,6 +529,9 @@ public:
                                    uint32_t(java_channels));
         auto native_type = result.type();
 
+        // YUV 4:2:0 images have 3/2 bytes per pixel, so count elements by bytes
+        auto N = jsize(result.bytes() / result.element_width());
+
         switch (native_type) {
             default:
                 break;
@@ -89,7 +89,7 @@ public class ImageData {
       this.width = width;
       this.channels = channels;
       this.type = GetType(format);
-      int N = number * height * width * channels;
+      int N = GetLength(format, number, width, height, channels);
       data_byte = null;
       switch (this.type) {
          default:
@@ -171,7 +171,7 @@ public class ImageData {
    /**
     * Construct image with given byte data in format. Format must be U8xxx.
     * Be careful of the order of width and height.
-    * Length of data must be `number * width * height * channels`.
+    * Length of data must be `number * width * height * channels`, or `number * width * height * 3 / 2` in YUV 4:2:0.
     * @param data byte data.
     * @param number number of image, always be 1.
     * @param width width of image.
@@ -185,10 +185,10 @@ public class ImageData {
                     int height,
                     int channels,
                     ImageFormat format) {
-      int N = number * height * width * channels;
+      int N = GetLength(format, number, width, height, channels);
       if (N != data.length) {
-         throw new RuntimeException(String.format("data.length must be %d = %d x %d x %d x %d, got %d",
-            N, number, height, width, channels, data.length
+         throw new RuntimeException(String.format("data.length must be %d for %s image %d x %d x %d x %d, got %d",
+            N, format, number, height, width, channels, data.length
          ));
       }
       if (GetType(format) != ValueType.Byte) {
@@ -235,6 +235,9 @@ public class ImageData {
          case U8Rgba:
          case U8Bgra:
          case U8Y:
+         case U8Nv12:
+         case U8Nv21:
+         case U8I420:
              return ValueType.Byte;
          case F32Raw:
              return ValueType.Float;
@@ -243,6 +246,27 @@ public class ImageData {
       }
    }
 
+   /**
+    * Get length of data array.
+    * YUV 4:2:0 formats have 3/2 bytes each pixel, with Y plane then U and V planes of half width and height.
+    * @param format image format.
+    * @param number number of image.
+    * @param width width of image.
+    * @param height height of image.
+    * @param channels channels of image, ignored in YUV 4:2:0 formats.
+    * @return length of data array.
+    */
+   public static int GetLength(ImageFormat format, int number, int width, int height, int channels) {
+      switch (format) {
+         default:
+            return number * height * width * channels;
+         case U8Nv12:
+         case U8Nv21:
+         case U8I420:
+            return number * height * width * 3 / 2;
+      }
+   }
+
    /**
     * Get image format.
     * @return image format.
@@ -15,4 +15,7 @@ public enum ImageFormat {
     U8Rgba,
     U8Bgra,
     U8Y,
+    U8Nv12,
+    U8Nv21,
+    U8I420,
 }
@@ -29,14 +29,20 @@ public:
     void reset() override {
     }
 
+    seeta::aip::ImageData copy_image(size_t i, const SeetaAIPImageData &image) {
+        auto tmp = output_image(i, SEETA_AIP_IMAGE_FORMAT(image.format),
+                                image.number, image.width, image.height, image.channels);
+        std::memcpy(tmp.data(), image.data, tmp.bytes());
+        return tmp;
+    }
+
     void copy(const std::vector<SeetaAIPImageData> &images,
               const std::vector<SeetaAIPObject> &objects) {
         result.images.clear();
         for (auto &image : images) {
-            seeta::aip::ImageData tmp;
-            tmp.raw(image);
-            result.images.emplace_back(std::move(tmp));
+            result.images.emplace_back(copy_image(result.images.size(), image));
         }
+        result.objects.clear();
         for (auto &object : objects) {
             seeta::aip::Object tmp;
             tmp.raw(object);
@@ -49,9 +55,7 @@ public:
         result.images.clear();
         for (auto it = images.rbegin(); it != images.rend(); ++it) {
             auto &image = *it;
-            seeta::aip::ImageData tmp;
-            tmp.raw(image);
-            result.images.emplace_back(std::move(tmp));
+            result.images.emplace_back(copy_image(result.images.size(), image));
         }
         result.objects.clear();
         for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
@@ -4,6 +4,7 @@
 
 #include "seeta_aip_package_v2.h"
 #include "seeta_aip_shape.h"
+#include "seeta_aip_rotate.h"
 
 #include <iostream>
 
@@ -31,45 +32,7 @@ public:
     void reset() override {
     }
 
-    template <size_t N>
-    static inline void copy_pixel(uint8_t *dst, const uint8_t *src) {
-        class Block {
-        public:
-            uint8_t data[N];
-        };
-        reinterpret_cast<Block *>(dst)[0] = reinterpret_cast<const Block*>(src)[0];
-    }
-
-    static void copy_pixel(uint8_t *dst, const uint8_t *src, size_t N) {
-        switch (N) {
-            default:
-                std::memcpy(dst, src, N);
-                break;
-            case 0:
-                break;
-#define COPY_PIXEL_N(N) case N: copy_pixel<N>(dst, src); break;
-            COPY_PIXEL_N(1)
-            COPY_PIXEL_N(2)
-            COPY_PIXEL_N(3)
-            COPY_PIXEL_N(4)
-            COPY_PIXEL_N(5)
-            COPY_PIXEL_N(6)
-            COPY_PIXEL_N(7)
-            COPY_PIXEL_N(8)
-            COPY_PIXEL_N(9)
-            COPY_PIXEL_N(10)
-            COPY_PIXEL_N(11)
-            COPY_PIXEL_N(12)
-            COPY_PIXEL_N(13)
-            COPY_PIXEL_N(14)
-            COPY_PIXEL_N(15)
-            COPY_PIXEL_N(16)
-#undef COPY_PIXEL_N
-        }
-    }
-
-    template <int A>
-    void rotate(const SeetaAIPImageData &src, seeta::aip::ImageData &dst);
+    void rotate(const SeetaAIPImageData &src, int angle, seeta::aip::ImageData &dst);
 
     void forward_0(const std::vector<SeetaAIPImageData> &images,
                    const std::vector<SeetaAIPObject> &objects);
@@ -89,97 +52,13 @@ public:
 };
 
 
-template <>
-void MyPackage::rotate<0>(const SeetaAIPImageData &src, seeta::aip::ImageData &dst) {
-    dst = seeta::aip::ImageData(SEETA_AIP_IMAGE_FORMAT(src.format),
-                                src.number, src.width, src.height, src.channels, src.data);
-}
-
-template <>
-void MyPackage::rotate<90>(const SeetaAIPImageData &src, seeta::aip::ImageData &dst) {
-    dst = seeta::aip::ImageData(SEETA_AIP_IMAGE_FORMAT(src.format),
-                                src.number, src.height, src.width, src.channels);
-    for (int n = 0; n < src.number; ++n) {
-        for (int h = 0; h < src.height; ++h) {
-            auto dst_channels = src.channels;
-
-            auto dst_width = src.height;
-            auto dst_height = src.width;
-
-            auto dst_h = dst_height - 1;
-            auto dst_w = h;
-            auto dst_step = -(int64_t)dst_width * dst_channels;
-
-            auto src_step = src.channels;
-            auto src_data = reinterpret_cast<const uint8_t *>(src.data) + (n * src.height + h) * src.width * src.channels;
-            auto dst_data = reinterpret_cast<uint8_t *>(dst.data()) + ((n * dst_height + dst_h) * dst_width + dst_w) * dst_channels;
-
-            for (int w = 0; w < src.width; ++w) {
-                copy_pixel(dst_data, src_data, src.channels);
-
-                src_data += src_step;
-                dst_data += dst_step;
-            }
-        }
-    }
-}
-
-template <>
-void MyPackage::rotate<180>(const SeetaAIPImageData &src, seeta::aip::ImageData &dst) {
-    dst = seeta::aip::ImageData(SEETA_AIP_IMAGE_FORMAT(src.format),
-                                src.number, src.width, src.height, src.channels);
-    for (int n = 0; n < src.number; ++n) {
-        for (int h = 0; h < src.height; ++h) {
-            auto dst_channels = src.channels;
-
-            auto dst_width = src.width;
-            auto dst_height = src.height;
-
-            auto dst_h = dst_height - 1 - h;
-            auto dst_w = dst_width - 1;
-            auto dst_step = -(int64_t)dst_channels;
-
-            auto src_step = src.channels;
-            auto src_data = reinterpret_cast<const uint8_t *>(src.data) + (n * src.height + h) * src.width * src.channels;
-            auto dst_data = reinterpret_cast<uint8_t *>(dst.data()) + ((n * dst_height + dst_h) * dst_width + dst_w) * dst_channels;
-
-            for (int w = 0; w < src.width; ++w) {
-                copy_pixel(dst_data, src_data, src.channels);
-
-                src_data += src_step;
-                dst_data += dst_step;
-            }
-        }
-    }
-}
-
-template <>
-void MyPackage::rotate<270>(const SeetaAIPImageData &src, seeta::aip::ImageData &dst) {
-    dst = seeta::aip::ImageData(SEETA_AIP_IMAGE_FORMAT(src.format),
-                                src.number, src.height, src.width, src.channels);
-    for (int n = 0; n < src.number; ++n) {
-        for (int h = 0; h < src.height; ++h) {
-            auto dst_channels = src.channels;
-
-            auto dst_width = src.height;
-            auto dst_height = src.width;
-
-            auto dst_h = 0;
-            auto dst_w = dst_width - 1 - h;
-            auto dst_step = dst_width * dst_channels;
-
-            auto src_step = src.channels;
-            auto src_data = reinterpret_cast<const uint8_t *>(src.data) + (n * src.height + h) * src.width * src.channels;
-            auto dst_data = reinterpret_cast<uint8_t *>(dst.data()) + ((n * dst_height + dst_h) * dst_width + dst_w) * dst_channels;
-
-            for (int w = 0; w < src.width; ++w) {
-                copy_pixel(dst_data, src_data, src.channels);
-
-                src_data += src_step;
-                dst_data += dst_step;
-            }
-        }
-    }
+void MyPackage::rotate(const SeetaAIPImageData &src, int angle, seeta::aip::ImageData &dst) {
+    bool swapped = angle % 180 != 0;
+    dst = output_image(0, SEETA_AIP_IMAGE_FORMAT(src.format), src.number,
+                       swapped ? src.height : src.width,
+                       swapped ? src.width : src.height,
+                       src.channels);
+    seeta::aip::rotate_image(executor(), seeta::aip::ImageData::Borrow(src), angle, dst);
 }
 
 void MyPackage::forward_0(const std::vector<SeetaAIPImageData> &images, const std::vector<SeetaAIPObject> &objects) {
@@ -193,17 +72,11 @@ void MyPackage::forward_0(const std::vector<SeetaAIPImageData> &images, const st
     switch (fix_angle) {
         default:
             throw seeta::aip::Exception("Can not rotate to " + std::to_string(angle));
+        case 0:
         case 90:
-            rotate<90>(image, result.images[0]);
-            break;
         case 180:
-            rotate<180>(image, result.images[0]);
-            break;
         case 270:
-            rotate<270>(image, result.images[0]);
-            break;
-        case 0:
-            rotate<0>(image, result.images[0]);
+            rotate(image, fix_angle, result.images[0]);
             break;
     }
 }
@@ -46,6 +46,9 @@ public:
             uint32_t method_id,
             const std::vector<SeetaAIPImageData> &images,
             const std::vector<SeetaAIPObject> &objects) override {
+        if (images.empty()) {
+            throw seeta::aip::Exception(SEETA_AIP_ERROR_MISMATCH_REQUIRED_INPUT_IMAGE, "Input image required.");
+        }
         std::cout << "[aip] forawrd image 0: [" << images[0].number << ", " << images[0].height << ", " << images[0].width << ", " << images[0].channels << "]" << std::endl;
         std::cout << "[aip] image 0: data(0) = " << int(reinterpret_cast<char *>(images[0].data)[0]) << std::endl;
         result.objects.resize(1);
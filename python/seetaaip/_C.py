@@ -69,6 +69,9 @@ FORMAT_U8BGR = 1002   # byte format for BGR888
 FORMAT_U8RGBA = 1003  # byte format for RGBA8888
 FORMAT_U8BGRA = 1004  # byte format for BGRA8888
 FORMAT_U8Y = 1005     # byte format for gray image
+FORMAT_U8NV12 = 1006  # YUV 4:2:0, Y plane, then interleaved UV plane
+FORMAT_U8NV21 = 1007  # YUV 4:2:0, Y plane, then interleaved VU plane
+FORMAT_U8I420 = 1008  # YUV 4:2:0, Y plane, then U plane, then V plane
 
 '''
 * Unknown shape
@@ -250,6 +253,10 @@ class Package(Structure):
         ("tag", seeta_aip_tag),
         ("get", seeta_aip_get),
         ("set", seeta_aip_set),
+        ("forward_async", c_void_p),    # appended entry, not used in python
+        ("forward_batch", c_void_p),    # appended entry, not used in python
+        ("forward_into", c_void_p),     # appended entry, not used in python
+        ("set_executor", c_void_p),     # appended entry, not used in python
     ]
 
 
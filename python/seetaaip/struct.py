@@ -71,7 +71,7 @@ class Tensor(object):
             dtype = self._check_dtype_aip(dtype)
             self.__type = dtype
             self.__dims = tuple(shape)
-            self.__numpy = numpy.zeros(self.__dims, self._check_dtype_numpy(dtype))
+            self.__numpy = numpy.zeros(self._data_shape(fmt, self.__dims), self._check_dtype_numpy(dtype))
         elif isinstance(obj, Tensor):
             self.__type = obj.__type
             self.__dims = obj.__dims
@@ -285,6 +285,9 @@ class ImageData(object):
                 _C.FORMAT_U8BGR,
                 _C.FORMAT_U8RGBA,
                 _C.FORMAT_U8BGRA,
+                _C.FORMAT_U8NV12,
+                _C.FORMAT_U8NV21,
+                _C.FORMAT_U8I420,
                 _C.FORMAT_I32RAW,
                 _C.FORMAT_F32RAW,
             }
@@ -313,7 +316,7 @@ class ImageData(object):
             if number is None:
                 number = 1
             if channels is None:
-                channels = 3
+                channels = 1 if self._is_yuv420(fmt) else 3
             shape = [number, height, width, channels]
 
         if obj is None:
@@ -327,7 +330,7 @@ class ImageData(object):
             self.__fmt = fmt
             self.__type = dtype
             self.__dims = tuple(shape)
-            self.__numpy = numpy.zeros(self.__dims, self._check_dtype_numpy(dtype))
+            self.__numpy = numpy.zeros(self._data_shape(fmt, self.__dims), self._check_dtype_numpy(dtype))
         elif isinstance(obj, ImageData):
             self.__fmt = obj.__fmt
             self.__type = obj.__type
@@ -355,8 +358,17 @@ class ImageData(object):
                 self.__numpy = numpy.ascontiguousarray(obj, dtype=self._check_dtype_numpy(dtype))
             self.__type = self._check_dtype_aip(self.__numpy.dtype.type)
             self.__fmt = fmt
+            if shape is None and self._is_yuv420(fmt):
+                # planes stacked in rows, like [height * 3 / 2, width] or [number, height * 3 / 2, width]
+                shape = self.__numpy.shape
+                assert 2 <= len(shape) <= 3 and shape[-2] % 3 == 0, \
+                    "YUV 4:2:0 data must be in shape [number, height * 3 / 2, width]"
+                if len(shape) == 2:
+                    shape = [1, shape[0], shape[1]]
+                shape = [shape[0], shape[1] * 2 // 3, shape[2], 1]
             if shape is not None:
-                self.__numpy = numpy.reshape(self.__numpy, shape)
+                self.__numpy = numpy.reshape(self.__numpy, self._data_shape(fmt, shape))
+                self.__dims = tuple(shape)
             else:
                 shape = self.__numpy.shape
                 assert 2 <= len(shape) <= 4
@@ -365,7 +377,7 @@ class ImageData(object):
                 if len(shape) == 3:
                     shape = [1, shape[0], shape[1], shape[2]]
                 self.__numpy = numpy.reshape(self.__numpy, shape)
-            self.__dims = self.__numpy.shape
+                self.__dims = self.__numpy.shape
 
     def _import_raw(self):
         c_data = self.__raw.data
@@ -378,7 +390,7 @@ class ImageData(object):
         dims = [int(c_dims[i]) for i in range(len(c_dims))]
 
         c_dtype_data = _C.cast(c_data, _C.POINTER(self._to_ctype(int(c_type))))
-        self.__numpy = numpy.ctypeslib.as_array(c_dtype_data, shape=tuple(dims))
+        self.__numpy = numpy.ctypeslib.as_array(c_dtype_data, shape=self._data_shape(int(c_fmt), dims))
         self.__type = int(c_type)
         self.__fmt = int(c_fmt)
         self.__dims = tuple(dims)
@@ -392,6 +404,26 @@ class ImageData(object):
         }
         return dtype_map[dtype]
 
+    @staticmethod
+    def _is_yuv420(fmt: int) -> bool:
+        return fmt in {_C.FORMAT_U8NV12, _C.FORMAT_U8NV21, _C.FORMAT_U8I420}
+
+    def _data_shape(self, fmt: int, dims: Iterable[int]) -> Tuple[int]:
+        """
+        Shape of data array. YUV 4:2:0 image has 3/2 bytes each pixel,
+        its planes are stacked in rows as [number, height * 3 / 2, width, 1].
+        :param fmt: image format
+        :param dims: [number, height, width, channels]
+        :return: shape of data array
+        """
+        dims = tuple(int(dim) for dim in dims)
+        if self._is_yuv420(fmt):
+            number, height, width, _ = dims
+            assert height % 2 == 0 and width % 2 == 0, \
+                "YUV 4:2:0 image must have even width and height, got {}x{}".format(width, height)
+            return number, height * 3 // 2, width, 1
+        return dims
+
     def _fmt_to_dtype(self, fmt: int) -> int:
         fmt_map = {
             _C.FORMAT_U8RAW: _C.BYTE,
@@ -400,6 +432,9 @@ class ImageData(object):
             _C.FORMAT_U8BGR: _C.BYTE,
             _C.FORMAT_U8RGBA: _C.BYTE,
             _C.FORMAT_U8BGRA: _C.BYTE,
+            _C.FORMAT_U8NV12: _C.BYTE,
+            _C.FORMAT_U8NV21: _C.BYTE,
+            _C.FORMAT_U8I420: _C.BYTE,
             _C.FORMAT_I32RAW: _C.INT32,
             _C.FORMAT_F32RAW: _C.FLOAT32,
         }
@@ -1179,6 +1214,9 @@ FORMAT_U8BGR = _C.FORMAT_U8BGR   # byte format for BGR888
 FORMAT_U8RGBA = _C.FORMAT_U8RGBA  # byte format for RGBA8888
 FORMAT_U8BGRA = _C.FORMAT_U8BGRA  # byte format for BGRA8888
 FORMAT_U8Y = _C.FORMAT_U8Y     # byte format for gray image
+FORMAT_U8NV12 = _C.FORMAT_U8NV12  # YUV 4:2:0, Y plane, then interleaved UV plane
+FORMAT_U8NV21 = _C.FORMAT_U8NV21  # YUV 4:2:0, Y plane, then interleaved VU plane
+FORMAT_U8I420 = _C.FORMAT_U8I420  # YUV 4:2:0, Y plane, then U plane, then V plane
 
 '''
 * Unknown shape
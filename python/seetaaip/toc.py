@@ -29,6 +29,9 @@ FORMAT_U8BGR = 1002   # byte format for BGR888
 FORMAT_U8RGBA = 1003  # byte format for RGBA8888
 FORMAT_U8BGRA = 1004  # byte format for BGRA8888
 FORMAT_U8Y = 1005     # byte format for gray image
+FORMAT_U8NV12 = 1006  # YUV 4:2:0, Y plane, then interleaved UV plane
+FORMAT_U8NV21 = 1007  # YUV 4:2:0, Y plane, then interleaved VU plane
+FORMAT_U8I420 = 1008  # YUV 4:2:0, Y plane, then U plane, then V plane
 
 '''
 * Unknown shape
@@ -0,0 +1,38 @@
+from seetaaip.struct import *
+import numpy
+from seetaaip import _C
+
+if __name__ == '__main__':
+    height, width = 4, 6
+    failed = 0
+
+    for fmt, name in [(_C.FORMAT_U8NV12, "NV12"), (_C.FORMAT_U8NV21, "NV21"), (_C.FORMAT_U8I420, "I420")]:
+        # planes stacked in rows, 3/2 bytes each pixel
+        planes = numpy.arange(height * 3 // 2 * width, dtype=numpy.uint8).reshape([height * 3 // 2, width])
+
+        data = ImageData(planes, fmt=fmt)
+        if data.shape != (1, height, width, 1) or data.data.size != height * width * 3 // 2:
+            print("[FAILED] {} shape {}, data size {}".format(name, data.shape, data.data.size))
+            failed += 1
+            continue
+
+        # round trip through C struct
+        raw = data.ref
+        if (raw.number, raw.height, raw.width, raw.channels) != (1, height, width, 1):
+            print("[FAILED] {} raw shape mismatch".format(name))
+            failed += 1
+        data2 = ImageData(raw)
+        if data2.shape != data.shape or data2.fmt != fmt or \
+                not numpy.array_equal(data2.numpy.reshape(planes.shape), planes):
+            print("[FAILED] {} round trip mismatch".format(name))
+            failed += 1
+
+        empty = ImageData(fmt=fmt, number=1, width=width, height=height)
+        if empty.shape != (1, height, width, 1) or empty.data.size != height * width * 3 // 2:
+            print("[FAILED] {} empty image shape {}".format(name, empty.shape))
+            failed += 1
+
+    if failed:
+        print("{} checks failed.".format(failed))
+        exit(1)
+    print("All checks passed.")
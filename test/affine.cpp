@@ -3,11 +3,39 @@
 //
 
 #include "seeta_aip_affine.h"
-#include "seeta_aip_alignment.h"
+#include "seeta_aip_warp.h"
 #include "seeta_aip_image_io.h"
 
 #include "seeta_aip_opencv.h"
 
+#include <chrono>
+#include <cmath>
+
+/**
+ * per pixel float path, which affine_sample2d used before fixed point fast path
+ */
+static seeta::aip::ImageData exact_sample2d(const float *M, const seeta::aip::ImageData &image, int width, int height) {
+    seeta::aip::ImageData dst(image.format(), 1, width, height, image.channels());
+    auto C = int(image.channels());
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            auto x = M[0] * i + M[1] * j + M[2];
+            auto y = M[3] * i + M[4] * j + M[5];
+            seeta::aip::sample_uint8_pixel(image, x, y, dst.data<uint8_t>() + (j * width + i) * C, 0);
+        }
+    }
+    return dst;
+}
+
+template<typename FUNC>
+static double benchmark(FUNC func, int times = 20) {
+    func();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < times; ++i) func();
+    auto spent = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(spent).count() / times;
+}
+
 int main() {
     std::string path = "a.jpg";
 
@@ -49,6 +77,34 @@ int main() {
 
     cv::imwrite("test_affine_opencv.png", mat);
 
+    {
+        // benchmark fast path against exact path and OpenCV, rotate 30 degree around center
+        // correctness of fast path, warp map and alignment crop is checked in test/warp.cpp
+        using namespace seeta::aip;
+        auto M = affine::identity<float>();
+        stack(M, affine::translate<float>(-float(image.width() / 2), -float(image.height() / 2)));
+        stack(M, affine::rotate<float>(30));
+        stack(M, affine::translate<float>(image.width() / 2, image.height() / 2));
+        auto inv = affine::inverse(M);
+        auto W = int(image.width());
+        auto H = int(image.height());
+
+        cv::Mat src(H, W, CV_8UC(image.channels()), image.data<uint8_t>());
+        cv::Mat warp(2, 3, CV_32F, M.data());
+        cv::Mat out;
+
+        std::cout << "exact: " << benchmark([&]() { exact_sample2d(inv.data(), image, W, H); }) << "ms" << std::endl;
+        std::cout << "fast: " << benchmark([&]() { affine_sample2d(1, inv.data(), image, 0, 0, W, H); }) << "ms"
+                  << ", with 4 threads: " << benchmark([&]() { affine_sample2d(4, inv.data(), image, 0, 0, W, H); })
+                  << "ms" << std::endl;
+        cv::setNumThreads(1);
+        std::cout << "opencv: " << benchmark([&]() { cv::warpAffine(src, out, warp, src.size()); }) << "ms" << std::endl;
+
+        WarpMap map(inv, W, H, W, H);
+        auto mapped = map.apply(1, image);
+        std::cout << "warp map: " << benchmark([&]() { map.apply(1, image, mapped); }) << "ms" << std::endl;
+    }
+
     return 0;
 }
 
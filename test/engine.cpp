@@ -4,6 +4,8 @@
 
 #include "seeta_aip_engine.h"
 
+#include <cstring>
+
 void test1() {
     using namespace seeta::aip;
     Engine engine("../lib/test");
@@ -27,9 +29,337 @@ void test3() {
     instance.dispose();
 }
 
+static bool check_output(const seeta::aip::Instance::Output &output) {
+    if (output.images.size() != 0 || output.objects.size() != 1) return false;
+    auto &object = output.objects[0];
+    return !object.tags().empty() && object.tags()[0].label == 1 &&
+           object.extra().data<float>()[0] == 233;
+}
+
+int test4() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    Instance instance("../lib/test", "cpu", {"1"});
+    ImageData image(SEETA_AIP_FORMAT_U8RGB, 1, 4, 3, 3);
+    std::memset(image.data(), 7, image.bytes());
+
+    // synchronous result is borrowed, async requests must not overwrite it
+    auto borrowed = instance.forward(0, *image.raw());
+    auto borrowed_objects = borrowed.objects.data;
+
+    std::vector<std::future<Instance::Output>> futures;
+    for (int i = 0; i < 8; ++i) {
+        futures.emplace_back(instance.forward_async(0, image));
+    }
+    for (auto &future : futures) {
+        if (!check_output(future.get())) {
+            std::cout << "[FAILED] forward_async result mismatch." << std::endl;
+            ++failed;
+        }
+    }
+    if (borrowed_objects != borrowed.objects.data || borrowed.objects.size != 1 ||
+        static_cast<float *>(borrowed_objects[0].extra.data)[0] != 233) {
+        std::cout << "[FAILED] forward_async overwrote borrowed result of forward." << std::endl;
+        ++failed;
+    }
+
+    // error is reported by future, with message read inside callback
+    auto future = instance.forward_async(0, std::vector<ImageData>());
+    try {
+        future.get();
+        std::cout << "[FAILED] forward_async without image should fail." << std::endl;
+        ++failed;
+    } catch (const Exception &e) {
+        if (e.errcode() != SEETA_AIP_ERROR_MISMATCH_REQUIRED_INPUT_IMAGE ||
+            e.message() != "Input image required.") {
+            std::cout << "[FAILED] forward_async got error(" << e.errcode() << "): " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+
+    // requests after failed one still work
+    if (!check_output(instance.forward_async(0, image).get())) {
+        std::cout << "[FAILED] forward_async after error mismatch." << std::endl;
+        ++failed;
+    }
+
+    instance.dispose();
+    return failed;
+}
+
+int test5() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    // host built before entries appended only passes legacy size
+    Library library("../lib/test");
+    auto entry = library.symbol<seeta_aip_load_entry>("seeta_aip_load");
+    auto legacy_size = uint32_t(offsetof(SeetaAIP, forward_async));
+
+    SeetaAIP aip;
+    std::memset(&aip, 0xcc, sizeof(aip));
+    std::memset(&aip, 0, legacy_size);
+    auto errcode = entry(&aip, legacy_size);
+    SeetaAIP untouched;
+    std::memset(&untouched, 0xcc, sizeof(untouched));
+    if (errcode != 0 || aip.aip_version != SEETA_AIP_VERSION || aip.forward == nullptr) {
+        std::cout << "[FAILED] load with legacy size got " << errcode << std::endl;
+        ++failed;
+    } else if (std::memcmp(reinterpret_cast<char *>(&aip) + legacy_size,
+                           reinterpret_cast<char *>(&untouched) + legacy_size,
+                           sizeof(SeetaAIP) - legacy_size) != 0) {
+        std::cout << "[FAILED] load with legacy size wrote beyond size." << std::endl;
+        ++failed;
+    }
+
+    std::memset(&aip, 0, sizeof(aip));
+    errcode = entry(&aip, legacy_size - 1);
+    if (errcode != SEETA_AIP_LOAD_SIZE_NOT_ENOUGH || aip.aip_version != SEETA_AIP_VERSION) {
+        std::cout << "[FAILED] load with short size got " << errcode << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+static bool same_pixels(const SeetaAIPImageData &a, const seeta::aip::ImageData &b) {
+    return a.format == b.format() && a.number == b.number() && a.height == b.height() &&
+           a.width == b.width() && a.channels == b.channels() &&
+           std::memcmp(a.data, b.data(), b.bytes()) == 0;
+}
+
+static int check_forward_into(const SeetaAIP &aip, const std::string &name) {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    Instance instance(aip, "cpu", {});
+    ImageData rgb(SEETA_AIP_FORMAT_U8RGB, 1, 4, 3, 3);
+    ImageData gray(SEETA_AIP_FORMAT_U8Y, 1, 2, 2, 1);
+    for (uint32_t i = 0; i < rgb.bytes(); ++i) rgb.data<uint8_t>()[i] = uint8_t(i);
+    for (uint32_t i = 0; i < gray.bytes(); ++i) gray.data<uint8_t>()[i] = uint8_t(100 + i);
+    std::vector<SeetaAIPImageData> inputs = {*rgb.raw(), *gray.raw()};
+
+    // enough capacity, results written into caller's memory
+    ImageData rgb_buffer(SEETA_AIP_FORMAT_U8RGB, 1, 4, 3, 3);
+    ImageData gray_buffer(SEETA_AIP_FORMAT_U8Y, 1, 4, 4, 1);
+    std::vector<SeetaAIPImageData> outputs = {*rgb_buffer.raw(), *gray_buffer.raw()};
+    auto result = instance.forward_into(0, inputs, {}, outputs);
+    if (result.images.size != 2 || outputs.size() != 2 ||
+        outputs[0].data != rgb_buffer.data() || outputs[1].data != gray_buffer.data() ||
+        !same_pixels(outputs[0], rgb) || !same_pixels(outputs[1], gray)) {
+        std::cout << "[FAILED] " << name << " forward_into not written into buffers." << std::endl;
+        ++failed;
+    }
+
+    // empty outputs gets borrowed images
+    outputs.clear();
+    result = instance.forward_into(0, inputs, {}, outputs);
+    if (outputs.size() != 2 || !same_pixels(outputs[0], rgb) || !same_pixels(outputs[1], gray)) {
+        std::cout << "[FAILED] " << name << " forward_into with empty outputs." << std::endl;
+        ++failed;
+    }
+
+    // capacity exceeded
+    outputs = {*rgb_buffer.raw()};
+    try {
+        instance.forward_into(0, inputs, {}, outputs);
+        std::cout << "[FAILED] " << name << " forward_into should fail with too few buffers." << std::endl;
+        ++failed;
+    } catch (const Exception &e) {
+        if (e.errcode() != SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH || outputs.size() != 2 ||
+            outputs[0].data != rgb_buffer.data()) {
+            std::cout << "[FAILED] " << name << " forward_into with too few buffers got "
+                      << e.errcode() << ", " << outputs.size() << " outputs." << std::endl;
+            ++failed;
+        }
+    }
+
+    // buffer too small, needed shape returned with caller's data
+    ImageData small_buffer(SEETA_AIP_FORMAT_U8Y, 1, 1, 1, 1);
+    outputs = {*rgb_buffer.raw(), *small_buffer.raw()};
+    try {
+        instance.forward_into(0, inputs, {}, outputs);
+        std::cout << "[FAILED] " << name << " forward_into should fail with too small buffer." << std::endl;
+        ++failed;
+    } catch (const Exception &e) {
+        if (e.errcode() != SEETA_AIP_ERROR_OUTPUT_BUFFER_NOT_ENOUGH || outputs.size() != 2 ||
+            outputs[1].data != small_buffer.data() ||
+            outputs[1].width != 2 || outputs[1].height != 2 || outputs[1].channels != 1) {
+            std::cout << "[FAILED] " << name << " forward_into with too small buffer got "
+                      << e.errcode() << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+int test6() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    Engine engine("../lib/copy");
+    failed += check_forward_into(engine.aip(), "AIP");
+
+    // AIP without forward_into entry, done by engine
+    auto aip = engine.aip();
+    aip.forward_into = nullptr;
+    failed += check_forward_into(aip, "Fallback");
+    return failed;
+}
+
+int test7() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    // roi view reaches AIP as packed copy of its pixels
+    Instance instance("../lib/copy", "cpu", {});
+    ImageData image(SEETA_AIP_FORMAT_U8RGB, 1, 5, 4, 3);
+    for (uint32_t i = 0; i < image.bytes(); ++i) image.data<uint8_t>()[i] = uint8_t(i);
+    auto roi = image.roi(1, 2, 3, 2);
+    auto packed = roi.compact();
+
+    auto result = instance.forward(0, std::vector<ImageData>({roi}), std::vector<Object>());
+    if (result.images.size != 1 || !same_pixels(result.images.data[0], packed)) {
+        std::cout << "[FAILED] roi view not packed as documented." << std::endl;
+        ++failed;
+    }
+    if (roi.packed() || roi.data() != image.data<uint8_t>() + 2 * image.row_stride() + 3) {
+        std::cout << "[FAILED] roi view changed by forward." << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+struct OwnedOutput {
+    std::vector<seeta::aip::ImageData> images;
+    std::vector<seeta::aip::Object> objects;
+};
+
+static OwnedOutput own(const seeta::aip::Instance::Result &result) {
+    OwnedOutput output;
+    for (uint32_t i = 0; i < result.images.size; ++i) {
+        auto &image = result.images.data[i];
+        seeta::aip::ImageData tmp(SEETA_AIP_IMAGE_FORMAT(image.format), image.number,
+                                  image.width, image.height, image.channels);
+        std::memcpy(tmp.data(), image.data, tmp.bytes());
+        output.images.emplace_back(tmp);
+    }
+    for (uint32_t i = 0; i < result.objects.size; ++i) {
+        seeta::aip::Object tmp;
+        tmp.raw(result.objects.data[i]);
+        output.objects.emplace_back(tmp);
+    }
+    return output;
+}
+
+static int check_forward_batch(const SeetaAIP &aip, const std::string &name) {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    Instance instance(aip, "cpu", {});
+
+    // requests with different number of images and objects
+    std::vector<std::vector<ImageData>> images(3);
+    std::vector<std::vector<Object>> objects(3);
+    for (size_t i = 0; i < images.size(); ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            ImageData image(SEETA_AIP_FORMAT_U8RGB, 1, uint32_t(3 + i), uint32_t(2 + j), 3);
+            for (uint32_t k = 0; k < image.bytes(); ++k) image.data<uint8_t>()[k] = uint8_t(i * 50 + j * 7 + k);
+            images[i].push_back(image);
+        }
+        for (size_t j = 0; j < 2 - i % 2; ++j) {
+            Shape shape;
+            shape.type(SEETA_AIP_POINTS);
+            shape.landmarks({{float(i), float(j)}});
+            objects[i].emplace_back(shape, Object::Tags({{int32_t(i * 10 + j), 0.5f}}));
+        }
+    }
+    std::vector<std::vector<SeetaAIPImageData>> c_images;
+    std::vector<std::vector<SeetaAIPObject>> c_objects;
+    for (size_t i = 0; i < images.size(); ++i) {
+        c_images.push_back(Instance::Convert(images[i]));
+        c_objects.push_back(Instance::Convert(objects[i]));
+    }
+
+    std::vector<OwnedOutput> expected;
+    for (size_t i = 0; i < images.size(); ++i) {
+        expected.push_back(own(instance.forward(0, c_images[i], c_objects[i])));
+    }
+
+    std::vector<Instance::Request> requests;
+    for (size_t i = 0; i < images.size(); ++i) {
+        requests.push_back({0, c_images[i].data(), uint32_t(c_images[i].size()),
+                            c_objects[i].data(), uint32_t(c_objects[i].size())});
+    }
+    auto results = instance.forward_batch(requests);
+    if (results.size() != requests.size()) {
+        std::cout << "[FAILED] " << name << " forward_batch got " << results.size() << " results." << std::endl;
+        return failed + 1;
+    }
+    for (size_t i = 0; i < results.size(); ++i) {
+        auto &result = results[i];
+        auto &want = expected[i];
+        bool ok = result.images.size == want.images.size() && result.objects.size == want.objects.size();
+        for (uint32_t j = 0; ok && j < result.images.size; ++j) {
+            ok = same_pixels(result.images.data[j], want.images[j]);
+        }
+        for (uint32_t j = 0; ok && j < result.objects.size; ++j) {
+            Object got;
+            got.raw(result.objects.data[j]);
+            ok = got.tags().size() == 1 && got.tags()[0].label == want.objects[j].tags()[0].label &&
+                 got.shape().landmarks().size() == 1 &&
+                 got.shape().landmarks()[0].x == want.objects[j].shape().landmarks()[0].x &&
+                 got.shape().landmarks()[0].y == want.objects[j].shape().landmarks()[0].y;
+        }
+        if (!ok) {
+            std::cout << "[FAILED] " << name << " forward_batch result " << i
+                      << " differs from forward." << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+int test8() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    Library library("../lib/copy");
+    auto entry = library.symbol<seeta_aip_load_entry>("seeta_aip_load");
+
+    SeetaAIP aip;
+    std::memset(&aip, 0, sizeof(aip));
+    if (entry(&aip, sizeof(aip)) != 0 || aip.forward_batch == nullptr) {
+        std::cout << "[FAILED] AIP has no forward_batch entry." << std::endl;
+        return 1;
+    }
+    failed += check_forward_batch(aip, "AIP");
+
+    // AIP built against legacy SeetaAIP leaves forward_batch empty, done by engine
+    auto legacy_size = uint32_t(offsetof(SeetaAIP, forward_async));
+    std::memset(&aip, 0, sizeof(aip));
+    if (entry(&aip, legacy_size) != 0 || aip.forward_batch != nullptr) {
+        std::cout << "[FAILED] AIP loaded with legacy size has forward_batch entry." << std::endl;
+        return failed + 1;
+    }
+    failed += check_forward_batch(aip, "Fallback");
+    return failed;
+}
+
 int main() {
     test1();
     test2();
     test3();
+    int failed = 0;
+    failed += test4();
+    failed += test5();
+    failed += test6();
+    failed += test7();
+    failed += test8();
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
     return 0;
 }
@@ -0,0 +1,217 @@
+#include "seeta_aip_executor.h"
+#include "seeta_aip_package_v2.h"
+#include "seeta_aip_engine.h"
+
+#include <iostream>
+#include <set>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+/**
+ * Runs an executor() loop in forward, tagging result with threads used and executor size.
+ */
+class ExecutorPackage : public seeta::aip::PackageV2 {
+public:
+    void create(const SeetaAIPDevice &, const std::vector<std::string> &,
+                const std::vector<SeetaAIPObject> &) override {}
+
+    void free() override {}
+
+    void reset() override {}
+
+    void forward(uint32_t, const std::vector<SeetaAIPImageData> &,
+                 const std::vector<SeetaAIPObject> &) override {
+        auto executor = this->executor();
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+        seeta::aip::parallel_for(executor, 0, 64, [&](int32_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            std::unique_lock<std::mutex> _locker(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+        result.objects.clear();
+        result.objects.emplace_back(seeta::aip::Shape(), seeta::aip::Object::Tags(
+                {{int32_t(threads.size()), float(executor.size())}}));
+    }
+};
+
+/**
+ * Host executor counting calls, running on its pool.
+ */
+struct CountingExecutor {
+    std::shared_ptr<seeta::aip::ThreadPool> pool;
+    std::atomic<int> calls{0};
+
+    static void SEETA_AIP_CALL ParallelFor(void *context, int32_t begin, int32_t end, int32_t threads,
+                                           seeta_aip_executor_task *task, void *data) {
+        auto self = static_cast<CountingExecutor *>(context);
+        ++self->calls;
+        self->pool->parallel_for(begin, end, threads, task, data);
+    }
+
+    static int32_t SEETA_AIP_CALL Concurrency(void *context) {
+        return static_cast<CountingExecutor *>(context)->pool->concurrency();
+    }
+
+    SeetaAIPExecutor raw() {
+        SeetaAIPExecutor executor;
+        executor.context = this;
+        executor.parallel_for = ParallelFor;
+        executor.concurrency = Concurrency;
+        return executor;
+    }
+};
+
+/**
+ * Each worker running outer loop runs inner loop on same pool, all items must be done once.
+ */
+static int check_nested() {
+    using namespace seeta::aip;
+    int failed = 0;
+    auto pool = std::make_shared<ThreadPool>(3);
+    Executor executor(pool);
+    for (int round = 0; round < 20; ++round) {
+        std::atomic<int> count{0};
+        parallel_for(executor, 0, 8, [&](int32_t) {
+            parallel_for(executor, 0, 100, [&](int32_t) {
+                parallel_for(executor.limit(2), 0, 3, [&](int32_t) { ++count; });
+            });
+        });
+        if (count != 8 * 100 * 3) {
+            std::cout << "[FAILED] nested parallel_for got " << count << " items." << std::endl;
+            ++failed;
+            break;
+        }
+    }
+    return failed;
+}
+
+/**
+ * Exception of task is thrown in caller, serial executor throws the first chunk's one,
+ * and executor still works after it.
+ */
+static int check_exception() {
+    using namespace seeta::aip;
+    int failed = 0;
+    auto pool = std::make_shared<ThreadPool>(3);
+    for (auto executor : {Executor(1), Executor(pool)}) {
+        for (int round = 0; round < 10; ++round) {
+            try {
+                parallel_range(executor, 0, 1000, [&](int32_t first, int32_t) {
+                    throw std::runtime_error(std::to_string(first));
+                });
+                std::cout << "[FAILED] exception of task not thrown with "
+                          << executor.size() << " threads." << std::endl;
+                ++failed;
+            } catch (const std::runtime_error &e) {
+                if (executor.size() == 1 && std::string(e.what()) != "0") {
+                    std::cout << "[FAILED] serial executor got exception of chunk " << e.what() << std::endl;
+                    ++failed;
+                }
+            }
+        }
+        std::atomic<int> count{0};
+        parallel_for(executor, 0, 1000, [&](int32_t) { ++count; });
+        if (count != 1000) {
+            std::cout << "[FAILED] executor after exception got " << count << " items." << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+/**
+ * Threads running one job at same time, and distinct threads used, never exceed requested number.
+ */
+static int check_threads_limit() {
+    using namespace seeta::aip;
+    int failed = 0;
+    auto pool = std::make_shared<ThreadPool>(7);
+    if (pool->concurrency() != 8) {
+        std::cout << "[FAILED] pool concurrency " << pool->concurrency() << std::endl;
+        ++failed;
+    }
+    for (int threads : {1, 2, 3, 5, 8, 0}) {
+        Executor executor(pool, threads);
+        auto wanted = threads > 0 ? threads : pool->concurrency();
+        if (executor.size() != wanted) {
+            std::cout << "[FAILED] executor of " << threads << " threads got size " << executor.size() << std::endl;
+            ++failed;
+        }
+        std::mutex mutex;
+        std::set<std::thread::id> used;
+        std::atomic<int> active{0};
+        std::atomic<int> most{0};
+        parallel_for(executor, 0, 200, [&](int32_t) {
+            auto now = ++active;
+            auto seen = most.load();
+            while (now > seen && !most.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            {
+                std::unique_lock<std::mutex> _locker(mutex);
+                used.insert(std::this_thread::get_id());
+            }
+            --active;
+        });
+        if (most > wanted || int(used.size()) > wanted) {
+            std::cout << "[FAILED] executor of " << threads << " threads ran " << most << " at same time on "
+                      << used.size() << " threads." << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+/**
+ * Host executor shared by Instance::set_executor runs loops of package, and package uses its own after unset.
+ */
+static int check_shared_executor() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    SeetaAIP aip;
+    std::memset(&aip, 0, sizeof(aip));
+    static const char *support[] = {"cpu", nullptr};
+    setup_aip_header(aip, "Executor", "run loop on executor", "executor", "v1", "0.0.1", support);
+    setup_aip_entry<ExecutorPackage>(aip);
+    Instance instance(aip, "cpu", {});
+
+    CountingExecutor host;
+    host.pool = std::make_shared<ThreadPool>(3);
+    auto raw = host.raw();
+    if (!instance.set_executor(Executor(raw))) {
+        std::cout << "[FAILED] set_executor not supported." << std::endl;
+        return 1;
+    }
+    auto result = instance.forward(0, std::vector<SeetaAIPImageData>());
+    auto &tag = result.objects.data[0].tags.data[0];
+    if (host.calls != 1 || tag.score != 4 || tag.label < 1 || tag.label > 4) {
+        std::cout << "[FAILED] shared executor called " << host.calls << " times, package got size "
+                  << tag.score << " and " << tag.label << " threads." << std::endl;
+        ++failed;
+    }
+
+    instance.set_executor(Executor());
+    result = instance.forward(0, std::vector<SeetaAIPImageData>());
+    auto &own = result.objects.data[0].tags.data[0];
+    if (host.calls != 1 || own.score != 1 || own.label != 1) {
+        std::cout << "[FAILED] package still used shared executor after unset." << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+    failed += check_nested();
+    failed += check_exception();
+    failed += check_threads_limit();
+    failed += check_shared_executor();
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
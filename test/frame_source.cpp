@@ -0,0 +1,238 @@
+#include "seeta_aip_frame_source.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include <memory>
+#include <functional>
+#include <cstring>
+
+static void write_file(const std::string &filename, const std::string &content) {
+    std::unique_ptr<FILE, int (*)(FILE *)> file(std::fopen(filename.c_str(), "wb"), fclose);
+    std::fwrite(content.data(), 1, content.size(), file.get());
+}
+
+static std::string random_bytes(std::mt19937 &rand, size_t size) {
+    std::string bytes(size, '\0');
+    for (auto &byte : bytes) byte = char(rand());
+    return bytes;
+}
+
+static seeta::aip::ImageData copy(const seeta::aip::ImageData &image) {
+    seeta::aip::ImageData dolly(image.format(), image.number(), image.width(), image.height(), image.channels());
+    std::memcpy(dolly.data(), image.data(), image.bytes());
+    return dolly;
+}
+
+/**
+ * Read all frames, each frame is copied and released before next one.
+ */
+static std::vector<seeta::aip::ImageData> read_all(seeta::aip::FrameSource &source) {
+    std::vector<seeta::aip::ImageData> frames;
+    seeta::aip::ImageData frame;
+    while (source.next(frame)) {
+        frames.push_back(copy(frame));
+        frame = seeta::aip::ImageData();
+    }
+    return frames;
+}
+
+static bool same(const seeta::aip::ImageData &a, const seeta::aip::ImageData &b) {
+    return a.format() == b.format() && a.width() == b.width() && a.height() == b.height()
+           && a.channels() == b.channels() && a.bytes() == b.bytes()
+           && std::memcmp(a.data(), b.data(), a.bytes()) == 0;
+}
+
+/**
+ * Frames read with and without read-ahead must be the expected ones,
+ * and with a ring of 1, holding a frame makes next throw until it is released.
+ * @param open open frame source with ring size and read-ahead
+ * @return number of failed checks
+ */
+static int check(const std::string &name,
+                 const std::function<std::shared_ptr<seeta::aip::FrameSource>(int, bool)> &open,
+                 SEETA_AIP_IMAGE_FORMAT format, const std::vector<seeta::aip::ImageData> &expected) {
+    using namespace seeta::aip;
+    int failed = 0;
+    std::vector<ImageData> sync_frames;
+    for (bool read_ahead : {false, true}) {
+        auto mode = name + (read_ahead ? " read-ahead" : " sync");
+        auto source = open(4, read_ahead);
+        if (source->format() != format || source->width() != expected[0].width()
+            || source->height() != expected[0].height()) {
+            std::cout << "[FAILED] " << mode << ": got " << format_string(source->format()) << " "
+                      << source->width() << "x" << source->height() << std::endl;
+            ++failed;
+        }
+        auto frames = read_all(*source);
+        ImageData frame;
+        if (frames.size() != expected.size() || source->count() != int64_t(expected.size()) || source->next(frame)) {
+            std::cout << "[FAILED] " << mode << ": got " << frames.size() << " frames, count "
+                      << source->count() << ", expected " << expected.size() << std::endl;
+            ++failed;
+            continue;
+        }
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (!same(frames[i], expected[i])) {
+                std::cout << "[FAILED] " << mode << ": frame " << i << " differs" << std::endl;
+                ++failed;
+            }
+            if (read_ahead && !same(frames[i], sync_frames[i])) {
+                std::cout << "[FAILED] " << mode << ": frame " << i << " differs from sync" << std::endl;
+                ++failed;
+            }
+        }
+        if (!read_ahead) sync_frames = frames;
+    }
+
+    for (bool read_ahead : {false, true}) {
+        auto mode = name + (read_ahead ? " read-ahead" : " sync");
+        auto source = open(1, read_ahead);
+        ImageData held, frame;
+        source->next(held);
+        try {
+            source->next(frame);
+            std::cout << "[FAILED] " << mode << ": next with all slots held not thrown" << std::endl;
+            ++failed;
+        } catch (const Exception &e) {
+            if (std::string(e.message()).find("held") == std::string::npos) {
+                std::cout << "[FAILED] " << mode << ": unexpected error, " << e.message() << std::endl;
+                ++failed;
+            }
+        }
+        // copies of frame hold the slot too
+        auto second_copy = held;
+        held = ImageData();
+        try {
+            source->next(frame);
+            std::cout << "[FAILED] " << mode << ": next with copy of frame held not thrown" << std::endl;
+            ++failed;
+        } catch (const Exception &) {
+        }
+        second_copy = ImageData();
+        if (!source->next(frame) || !same(frame, expected[1])) {
+            std::cout << "[FAILED] " << mode << ": released slot not reused for next frame" << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+int main() {
+    using namespace seeta::aip;
+
+    std::mt19937 rand(4399);
+    const uint32_t width = 6, height = 4;
+    int failed = 0;
+
+    // Y4M 4:2:0, frame header with parameters
+    {
+        std::vector<ImageData> expected;
+        std::string content = "YUV4MPEG2 W6 H4 F30000:1001 Ip A1:1 C420jpeg XYSCSS=420JPEG\n";
+        for (int i = 0; i < 2; ++i) {
+            auto bytes = random_bytes(rand, width * height * 3 / 2);
+            content += i ? "FRAME Ixyz\n" : "FRAME\n";
+            content += bytes;
+            ImageData frame(SEETA_AIP_FORMAT_U8I420, 1, width, height, 1);
+            std::memcpy(frame.data(), bytes.data(), bytes.size());
+            expected.push_back(frame);
+        }
+        write_file("frame_source_420.y4m", content);
+        failed += check("Y4M C420jpeg", [](int ring, bool read_ahead) {
+            return FrameSource::Y4M("frame_source_420.y4m", ring, read_ahead);
+        }, SEETA_AIP_FORMAT_U8I420, expected);
+        auto fps = FrameSource::Y4M("frame_source_420.y4m")->fps();
+        if (std::fabs(fps - 30000.0 / 1001) > 1e-9) {
+            std::cout << "[FAILED] Y4M fps " << fps << std::endl;
+            ++failed;
+        }
+    }
+
+    // Y4M mono
+    {
+        std::vector<ImageData> expected;
+        std::string content = "YUV4MPEG2 W6 H4 F25:1 Cmono\n";
+        for (int i = 0; i < 2; ++i) {
+            auto bytes = random_bytes(rand, width * height);
+            content += "FRAME\n" + bytes;
+            ImageData frame(SEETA_AIP_FORMAT_U8Y, 1, width, height, 1);
+            std::memcpy(frame.data(), bytes.data(), bytes.size());
+            expected.push_back(frame);
+        }
+        write_file("frame_source_mono.y4m", content);
+        failed += check("Y4M Cmono", [](int ring, bool read_ahead) {
+            return FrameSource::Y4M("frame_source_mono.y4m", ring, read_ahead);
+        }, SEETA_AIP_FORMAT_U8Y, expected);
+    }
+
+    // raw I420, trailing bytes less than one frame ignored
+    {
+        std::vector<ImageData> expected;
+        std::string content;
+        for (int i = 0; i < 2; ++i) {
+            auto bytes = random_bytes(rand, width * height * 3 / 2);
+            content += bytes;
+            ImageData frame(SEETA_AIP_FORMAT_U8I420, 1, width, height, 1);
+            std::memcpy(frame.data(), bytes.data(), bytes.size());
+            expected.push_back(frame);
+        }
+        content += random_bytes(rand, width * height * 3 / 2 - 1);
+        write_file("frame_source.yuv", content);
+        failed += check("raw I420", [=](int ring, bool read_ahead) {
+            return FrameSource::Raw("frame_source.yuv", SEETA_AIP_FORMAT_U8I420, width, height, ring, read_ahead);
+        }, SEETA_AIP_FORMAT_U8I420, expected);
+    }
+
+    // two JPEGs in multipart boundaries
+    {
+        std::vector<ImageData> expected;
+        std::string content;
+        ImageEncoder encoder("jpg");
+        for (int i = 0; i < 2; ++i) {
+            ImageData image(SEETA_AIP_FORMAT_U8RGB, 1, 37, 29, 3);
+            for (size_t k = 0; k < image.bytes(); ++k) image.data<uint8_t>()[k] = uint8_t(k * (i + 3) / 7);
+            auto encoded = encoder.encode(image);
+            content += "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: "
+                       + std::to_string(encoded.size()) + "\r\n\r\n";
+            content.append(encoded.begin(), encoded.end());
+            content += "\r\n";
+            expected.push_back(decode(encoded.data(), int(encoded.size()), SEETA_AIP_FORMAT_U8BGR));
+        }
+        content += "--frame--\r\n";
+        write_file("frame_source.mjpeg", content);
+        failed += check("MJPEG", [](int ring, bool read_ahead) {
+            return FrameSource::MJPEG("frame_source.mjpeg", SEETA_AIP_FORMAT_U8BGR, ring, read_ahead);
+        }, SEETA_AIP_FORMAT_U8BGR, expected);
+    }
+
+    // bad headers and missing files are thrown
+    write_file("frame_source_bad.y4m", "YUV4MPEG2 W5 H4 C420jpeg\nFRAME\n");
+    for (auto &open : std::vector<std::function<void()>>{
+            []() { FrameSource::Y4M("frame_source_bad.y4m"); },
+            []() { FrameSource::Y4M("frame_source_missing.y4m"); },
+            []() { FrameSource::MJPEG("frame_source.yuv"); },
+            []() { FrameSource::Y4M("frame_source_420.y4m", 0); }}) {
+        try {
+            open();
+            std::cout << "[FAILED] bad frame source not thrown" << std::endl;
+            ++failed;
+        } catch (const Exception &e) {
+            std::cout << "rejected, " << e.message() << std::endl;
+        }
+    }
+
+    for (auto filename : {"frame_source_420.y4m", "frame_source_mono.y4m", "frame_source.yuv",
+                          "frame_source.mjpeg", "frame_source_bad.y4m"}) {
+        std::remove(filename);
+    }
+
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
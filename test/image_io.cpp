@@ -0,0 +1,509 @@
+#include "seeta_aip_image_io.h"
+
+#include "progressive_jpeg.h"
+
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+/**
+ * smooth RGB pattern, lossy codecs keep it close
+ */
+static seeta::aip::ImageData pattern(uint32_t width, uint32_t height) {
+    seeta::aip::ImageData image(SEETA_AIP_FORMAT_U8RGB, 1, width, height, 3);
+    auto data = image.data<uint8_t>();
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            auto pixel = data + (y * width + x) * 3;
+            pixel[0] = uint8_t(127 + 100 * std::sin(x / 31.0));
+            pixel[1] = uint8_t(127 + 100 * std::cos(y / 29.0));
+            pixel[2] = uint8_t((x + y) * 255 / (width + height));
+        }
+    }
+    return image;
+}
+
+/**
+ * @return if images have same shape and pixels, views are compared row by row
+ */
+static bool same(const seeta::aip::ImageData &a, const seeta::aip::ImageData &b) {
+    if (a.format() != b.format() || a.number() != b.number() || a.width() != b.width()
+        || a.height() != b.height() || a.channels() != b.channels()) {
+        return false;
+    }
+    auto lhs = a.compact();
+    auto rhs = b.compact();
+    return std::memcmp(lhs.data(), rhs.data(), lhs.bytes()) == 0;
+}
+
+/**
+ * Each decode target must be the RGB decoding converted,
+ * decoding into strided view only writes the view, size mismatch throws and truncated data fails.
+ */
+static int check_decode() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    auto source = pattern(67, 45);
+    SEETA_AIP_IMAGE_FORMAT formats[] = {SEETA_AIP_FORMAT_U8RGB, SEETA_AIP_FORMAT_U8BGR,
+                                        SEETA_AIP_FORMAT_U8BGRA, SEETA_AIP_FORMAT_U8Y};
+    for (auto &code : {"png", "jpg"}) {
+        auto encoded = encode(code, source);
+        auto rgb = decode(encoded.data(), int(encoded.size()));
+        if (rgb.width() != source.width() || rgb.height() != source.height()
+            || rgb.format() != SEETA_AIP_FORMAT_U8RGB) {
+            std::cout << "[FAILED] decode " << code << " RGB got wrong image" << std::endl;
+            ++failed;
+            continue;
+        }
+        if (std::string(code) == "png" && !same(rgb, source)) {
+            std::cout << "[FAILED] decode png RGB differs from source" << std::endl;
+            ++failed;
+        }
+        // alpha is kept from file, converting RGB would give alpha 0
+        auto rgba = decode(encoded.data(), int(encoded.size()), SEETA_AIP_FORMAT_U8RGBA);
+        auto rgba_colors = convert(1, SEETA_AIP_FORMAT_U8RGB, rgba);
+        if (!same(rgba_colors, rgb)) {
+            std::cout << "[FAILED] decode " << code << " RGBA colors differ from RGB" << std::endl;
+            ++failed;
+        }
+        for (auto format : formats) {
+            auto expected = convert(1, format, ImageData::GetChannels(format, 0) == 4 ? rgba : rgb);
+            auto decoded = decode(encoded.data(), int(encoded.size()), format);
+            if (!same(decoded, expected)) {
+                std::cout << "[FAILED] decode " << code << " " << format_string(format)
+                          << " differs from converted RGB" << std::endl;
+                ++failed;
+            }
+
+            ImageData into(format, 1, source.width(), source.height(), expected.channels());
+            if (!decode(encoded.data(), int(encoded.size()), into) || !same(into, expected)) {
+                std::cout << "[FAILED] decode " << code << " into " << format_string(format)
+                          << " differs from converted RGB" << std::endl;
+                ++failed;
+            }
+
+            // roi keeps 5 pixels at left, 3 rows at top, and some at right and bottom
+            ImageData canvas(format, 1, source.width() + 11, source.height() + 7, expected.channels());
+            std::memset(canvas.data(), 0x5a, canvas.bytes());
+            auto roi = canvas.roi(5, 3, source.width(), source.height());
+            if (!decode(encoded.data(), int(encoded.size()), roi) || !same(roi, expected)) {
+                std::cout << "[FAILED] decode " << code << " into strided " << format_string(format)
+                          << " differs from converted RGB" << std::endl;
+                ++failed;
+            }
+            size_t outside = 0;
+            auto C = canvas.channels();
+            for (uint32_t y = 0; y < canvas.height(); ++y) {
+                for (uint32_t x = 0; x < canvas.width(); ++x) {
+                    if (x >= 5 && x < 5 + source.width() && y >= 3 && y < 3 + source.height()) continue;
+                    auto pixel = canvas.data<uint8_t>() + (y * canvas.width() + x) * C;
+                    for (uint32_t c = 0; c < C; ++c) outside += pixel[c] != 0x5a;
+                }
+            }
+            if (outside) {
+                std::cout << "[FAILED] decode " << code << " into strided " << format_string(format)
+                          << " wrote " << outside << " bytes out of view" << std::endl;
+                ++failed;
+            }
+        }
+
+        ImageData wrong(SEETA_AIP_FORMAT_U8BGR, 1, source.width() - 1, source.height(), 3);
+        try {
+            decode(encoded.data(), int(encoded.size()), wrong);
+            std::cout << "[FAILED] decode " << code << " into wrong size not thrown" << std::endl;
+            ++failed;
+        } catch (const Exception &e) {
+            std::cout << "decode " << code << " into wrong size: " << e.message() << std::endl;
+        }
+
+        // truncated after header, size matches but pixels could not be decoded
+        ImageData truncated(SEETA_AIP_FORMAT_U8BGR, 1, source.width(), source.height(), 3);
+        if (decode(encoded.data(), 40, truncated)) {
+            std::cout << "[FAILED] decode " << code << " of truncated data succeeded" << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+/**
+ * Batch slots must be each decoding resized, letterboxed in center, or filled with pad if corrupt.
+ */
+static int check_decode_batch() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    std::vector<std::vector<unsigned char>> buffers = {
+            encode("png", pattern(67, 45)),
+            encode("png", pattern(30, 90)),
+            encode("png", pattern(64, 48)),
+    };
+    buffers.push_back(buffers[0]);
+    // broken header and data
+    buffers[3].resize(40);
+    for (size_t i = 8; i < buffers[3].size(); ++i) buffers[3][i] = uint8_t(i * 37);
+
+    const int W = 64, H = 48;
+    const uint8_t pad = 114;
+    for (auto letterbox : {false, true}) {
+        const char *name = letterbox ? "letterbox" : "stretch";
+        std::vector<DecodeInfo> infos;
+        auto batch = decode_batch(4, buffers, SEETA_AIP_FORMAT_U8BGR, W, H, &infos, letterbox, pad);
+        if (batch.number() != buffers.size() || batch.width() != W || batch.height() != H
+            || batch.format() != SEETA_AIP_FORMAT_U8BGR || infos.size() != buffers.size()) {
+            std::cout << "[FAILED] decode batch " << name << " got wrong shape" << std::endl;
+            ++failed;
+            continue;
+        }
+        if (infos[3].decoded) {
+            std::cout << "[FAILED] decode batch " << name << " corrupt image decoded" << std::endl;
+            ++failed;
+        }
+        auto slot_bytes = size_t(W) * H * 3;
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            auto slot = batch.data<uint8_t>() + i * slot_bytes;
+            auto &info = infos[i];
+            auto image = decode(buffers[i].data(), int(buffers[i].size()), SEETA_AIP_FORMAT_U8BGR);
+            if (image.width() == 0) {
+                size_t not_pad = 0;
+                for (size_t k = 0; k < slot_bytes; ++k) not_pad += slot[k] != pad;
+                if (info.decoded || not_pad) {
+                    std::cout << "[FAILED] decode batch " << name << " corrupt image " << i
+                              << " not filled with pad" << std::endl;
+                    ++failed;
+                }
+                continue;
+            }
+
+            auto rw = W, rh = H;
+            if (letterbox) {
+                auto scale = std::min(float(W) / image.width(), float(H) / image.height());
+                rw = std::max(1, std::min(W, int(lroundf(image.width() * scale))));
+                rh = std::max(1, std::min(H, int(lroundf(image.height() * scale))));
+            }
+            auto left = (W - rw) / 2, top = (H - rh) / 2;
+            if (!info.decoded || info.width != image.width() || info.height != image.height()
+                || info.offset_x != float(left) || info.offset_y != float(top)) {
+                std::cout << "[FAILED] decode batch " << name << " image " << i << " got wrong info" << std::endl;
+                ++failed;
+                continue;
+            }
+
+            auto resized = rw == int(image.width()) && rh == int(image.height())
+                           ? image : resize(1, image, rw, rh);
+            ImageData expected(SEETA_AIP_FORMAT_U8BGR, 1, W, H, 3);
+            std::memset(expected.data(), pad, expected.bytes());
+            for (int y = 0; y < rh; ++y) {
+                std::memcpy(expected.data<uint8_t>() + ((top + y) * W + left) * 3,
+                            resized.data<uint8_t>() + y * rw * 3, size_t(rw) * 3);
+            }
+            if (std::memcmp(expected.data(), slot, slot_bytes) != 0) {
+                std::cout << "[FAILED] decode batch " << name << " image " << i
+                          << " differs from decode and resize" << std::endl;
+                ++failed;
+            }
+
+            // corners of placed image map back to corners of original
+            SeetaAIPPoint corners[] = {{float(left), float(top)}, {float(left + rw), float(top + rh)}};
+            SeetaAIPPoint originals[] = {{0, 0}, {float(image.width()), float(image.height())}};
+            for (int k = 0; k < 2; ++k) {
+                auto p = info.to_original(corners[k]);
+                if (std::fabs(p.x - originals[k].x) > 1e-3f || std::fabs(p.y - originals[k].y) > 1e-3f) {
+                    std::cout << "[FAILED] decode batch " << name << " image " << i << " maps (" << corners[k].x
+                              << ", " << corners[k].y << ") to (" << p.x << ", " << p.y << ")" << std::endl;
+                    ++failed;
+                }
+            }
+        }
+    }
+    return failed;
+}
+
+/**
+ * @return each `block x block` pixels of RGB image averaged, partial blocks at right and bottom averaged as is
+ */
+static seeta::aip::ImageData block_average(const seeta::aip::ImageData &image, uint32_t block) {
+    auto W = image.width(), H = image.height();
+    auto width = (W + block - 1) / block, height = (H + block - 1) / block;
+    seeta::aip::ImageData averaged(SEETA_AIP_FORMAT_U8RGB, 1, width, height, 3);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                uint32_t sum = 0, count = 0;
+                for (auto j = y * block; j < std::min(H, y * block + block); ++j) {
+                    for (auto i = x * block; i < std::min(W, x * block + block); ++i) {
+                        sum += image.data<uint8_t>()[(j * W + i) * 3 + c];
+                        ++count;
+                    }
+                }
+                averaged.data<uint8_t>()[(y * width + x) * 3 + c] = uint8_t((sum + count / 2) / count);
+            }
+        }
+    }
+    return averaged;
+}
+
+/**
+ * Reduced JPEG decoding must pick denominator by max_side, output ceil(size / denominator),
+ * stay close to full decoding resized, and be full decoding when max_side is 0.
+ */
+static int check_decode_reduced() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    const uint32_t W = 203, H = 147;
+    struct Source {
+        const char *name;
+        std::vector<unsigned char> data;
+    };
+    std::vector<Source> sources = {
+            {"baseline",    encode("jpg", pattern(W, H))},
+            {"progressive", std::vector<unsigned char>(progressive_jpeg,
+                                                       progressive_jpeg + sizeof(progressive_jpeg))},
+    };
+    for (auto &source : sources) {
+        auto data = source.data.data();
+        auto len = int(source.data.size());
+        auto full = decode(data, len);
+        if (full.width() != W || full.height() != H) {
+            std::cout << "[FAILED] decode " << source.name << " JPEG failed" << std::endl;
+            ++failed;
+            continue;
+        }
+
+        int denominator = 0;
+        auto same_size = decode_reduced(data, len, 0, SEETA_AIP_FORMAT_U8RGB, &denominator);
+        if (denominator != 1 || !same(same_size, full)) {
+            std::cout << "[FAILED] decode reduced " << source.name << " with max_side 0 differs from decode"
+                      << std::endl;
+            ++failed;
+        }
+
+        // long side 203 is 102, 51 and 26 after 1/2, 1/4 and 1/8
+        int cases[][2] = {{100, 2}, {51, 4}, {50, 4}, {20, 8}, {1, 8}};
+        for (auto &c : cases) {
+            auto max_side = c[0];
+            denominator = 0;
+            auto reduced = decode_reduced(data, len, max_side, SEETA_AIP_FORMAT_U8RGB, &denominator);
+            auto width = (W + c[1] - 1) / c[1];
+            auto height = (H + c[1] - 1) / c[1];
+            if (denominator != c[1] || reduced.width() != width || reduced.height() != height) {
+                std::cout << "[FAILED] decode reduced " << source.name << " with max_side " << max_side
+                          << " got 1/" << denominator << " " << reduced.width() << "x" << reduced.height()
+                          << ", expected 1/" << c[1] << " " << width << "x" << height << std::endl;
+                ++failed;
+                continue;
+            }
+            // DCT scaling averages aligned blocks, last ones are partial
+            auto expected = block_average(full, uint32_t(c[1]));
+            double sum = 0;
+            int max_diff = 0;
+            for (size_t i = 0; i < reduced.bytes(); ++i) {
+                auto diff = std::abs(int(reduced.data<uint8_t>()[i]) - int(expected.data<uint8_t>()[i]));
+                sum += diff;
+                max_diff = std::max(max_diff, diff);
+            }
+            auto mean = sum / double(reduced.bytes());
+            std::cout << "decode reduced " << source.name << " 1/" << denominator << ": mean diff " << mean
+                      << ", max diff " << max_diff << std::endl;
+            // 4:2:0 chroma is upsampled at reduced size, so edges of color changes differ most
+            if (mean > 3 || max_diff > 24) {
+                std::cout << "[FAILED] decode reduced " << source.name << " 1/" << denominator
+                          << " not close to decode and resize" << std::endl;
+                ++failed;
+            }
+        }
+    }
+    return failed;
+}
+
+/**
+ * probe must read same size as imread, imread_mapped must decode same as imread,
+ * FilePrefetcher must give files in order, empty mapping for missing file, then nullptr.
+ */
+static int check_mapped() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    std::vector<std::string> filenames = {"image_io_0.png", "image_io_1.jpg", "image_io_missing.png",
+                                          "image_io_2.png"};
+    imwrite(filenames[0], pattern(67, 45));
+    imwrite(filenames[1], pattern(30, 90));
+    imwrite(filenames[3], convert(1, SEETA_AIP_FORMAT_U8Y, pattern(64, 48)));
+
+    std::vector<std::vector<unsigned char>> contents;
+    for (auto &filename : filenames) {
+        std::vector<unsigned char> content;
+        std::unique_ptr<FILE, int (*)(FILE *)> file(std::fopen(filename.c_str(), "rb"), fclose);
+        if (file) {
+            unsigned char buffer[4096];
+            size_t n;
+            while ((n = std::fread(buffer, 1, sizeof(buffer), file.get())) > 0) {
+                content.insert(content.end(), buffer, buffer + n);
+            }
+        }
+        contents.push_back(content);
+
+        auto image = imread(filename);
+        auto info = probe(filename);
+        auto memory_info = content.empty() ? ImageInfo() : probe(content.data(), int(content.size()));
+        if (info.width != int32_t(image.width()) || info.height != int32_t(image.height())
+            || memory_info.width != info.width || memory_info.height != info.height
+            || memory_info.channels != info.channels) {
+            std::cout << "[FAILED] probe " << filename << " got " << info.width << "x" << info.height
+                      << ", imread got " << image.width() << "x" << image.height() << std::endl;
+            ++failed;
+        }
+        if (!info.empty() && info.channels != (filename == filenames[3] ? 1 : 3)) {
+            std::cout << "[FAILED] probe " << filename << " got " << info.channels << " channels" << std::endl;
+            ++failed;
+        }
+        for (auto format : {SEETA_AIP_FORMAT_U8RGB, SEETA_AIP_FORMAT_U8BGRA, SEETA_AIP_FORMAT_U8Y}) {
+            auto expected = imread(filename, format);
+            auto mapped = imread_mapped(filename, format);
+            if (mapped.width() != expected.width() || (expected.width() && !same(mapped, expected))) {
+                std::cout << "[FAILED] imread_mapped " << filename << " " << format_string(format)
+                          << " differs from imread" << std::endl;
+                ++failed;
+            }
+        }
+    }
+
+    for (size_t ahead : {1, 2, 8}) {
+        FilePrefetcher prefetcher(filenames, ahead);
+        for (size_t i = 0; i < filenames.size(); ++i) {
+            auto file = prefetcher.next();
+            if (!file || file->filename() != filenames[i] || file->size() != contents[i].size()
+                || file->empty() != contents[i].empty()
+                || (file->size() && std::memcmp(file->data(), contents[i].data(), file->size()) != 0)) {
+                std::cout << "[FAILED] prefetch " << ahead << " ahead got wrong file at " << i << std::endl;
+                ++failed;
+            }
+        }
+        if (prefetcher.next() || prefetcher.next()) {
+            std::cout << "[FAILED] prefetch " << ahead << " ahead got file after last one" << std::endl;
+            ++failed;
+        }
+    }
+
+    // stopped before all files taken
+    {
+        FilePrefetcher prefetcher(filenames, 1);
+        prefetcher.next();
+    }
+
+    for (auto &filename : filenames) std::remove(filename.c_str());
+    return failed;
+}
+
+static void append(void *context, void *data, int size) {
+    auto buffer = static_cast<std::vector<unsigned char> *>(context);
+    auto bytes = static_cast<const unsigned char *>(data);
+    buffer->insert(buffer->end(), bytes, bytes + size);
+}
+
+/**
+ * ImageEncoder of packed RGB must be same as stb writers,
+ * BGR, strided and gray images must encode to same pixels without converting first.
+ */
+static int check_encoder() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    auto source = pattern(67, 45);
+    auto W = int(source.width()), H = int(source.height());
+    auto data = source.data();
+
+    struct Setting {
+        const char *code;
+        int quality;
+        int compression;
+    };
+    Setting settings[] = {{"jpg", 90, 8}, {"jpg", 35, 8}, {"png", 90, 8}, {"png", 90, 2},
+                          {"bmp", 90, 8}, {"tga", 90, 8}};
+    for (auto &setting : settings) {
+        std::string code = setting.code;
+        std::vector<unsigned char> expected;
+        if (code == "jpg") {
+            stbi_write_jpg_to_func(append, &expected, W, H, 3, data, setting.quality);
+        } else if (code == "png") {
+            auto level = stbi_write_png_compression_level;
+            stbi_write_png_compression_level = setting.compression;
+            stbi_write_png_to_func(append, &expected, W, H, 3, data, W * 3);
+            stbi_write_png_compression_level = level;
+        } else if (code == "bmp") {
+            stbi_write_bmp_to_func(append, &expected, W, H, 3, data);
+        } else {
+            stbi_write_tga_to_func(append, &expected, W, H, 3, data);
+        }
+        ImageEncoder encoder(code);
+        encoder.quality(setting.quality).compression(setting.compression);
+        // encoded twice, reused buffer gives same bytes
+        for (int k = 0; k < 2; ++k) {
+            if (encoder.encode(source) != expected) {
+                std::cout << "[FAILED] encode " << code << " quality " << setting.quality << " compression "
+                          << setting.compression << " differs from stb writer" << std::endl;
+                ++failed;
+            }
+        }
+    }
+
+    // BGR and strided views are read in place, gray is written as 1 channel
+    auto bgr = convert(1, SEETA_AIP_FORMAT_U8BGR, source);
+    ImageData canvas(SEETA_AIP_FORMAT_U8RGB, 1, source.width() + 9, source.height() + 4, 3);
+    std::memset(canvas.data(), 0, canvas.bytes());
+    auto strided = canvas.roi(7, 2, source.width(), source.height());
+    for (int y = 0; y < H; ++y) {
+        std::memcpy(canvas.data<uint8_t>() + ((y + 2) * canvas.width() + 7) * 3,
+                    source.data<uint8_t>() + y * W * 3, size_t(W) * 3);
+    }
+    auto gray = convert(1, SEETA_AIP_FORMAT_U8Y, source);
+
+    for (auto code : {"png", "jpg"}) {
+        ImageEncoder encoder(code);
+        auto rgb_encoded = encoder.encode(source);
+        struct View {
+            const char *name;
+            ImageData image;
+        };
+        View views[] = {{"BGR", bgr}, {"strided RGB", strided}};
+        for (auto &view : views) {
+            auto encoded = encoder.encode(view.image);
+            if (encoded != rgb_encoded) {
+                std::cout << "[FAILED] encode " << code << " of " << view.name << " differs from RGB" << std::endl;
+                ++failed;
+            }
+            auto decoded = decode(encoded.data(), int(encoded.size()));
+            if (std::string(code) == "png" && !same(decoded, source)) {
+                std::cout << "[FAILED] encode png of " << view.name << " decoded differs from source" << std::endl;
+                ++failed;
+            }
+        }
+    }
+
+    auto png = encode("png", gray);
+    auto info = probe(png.data(), int(png.size()));
+    auto decoded = decode(png.data(), int(png.size()), SEETA_AIP_FORMAT_U8Y);
+    if (info.channels != 1 || !same(decoded, gray)) {
+        std::cout << "[FAILED] encode png of gray decoded differs from source" << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+    failed += check_decode();
+    failed += check_decode_batch();
+    failed += check_decode_reduced();
+    failed += check_mapped();
+    failed += check_encoder();
+
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -6,6 +6,143 @@
 #include "seeta_aip_color_map.h"
 #include "seeta_aip_image_io.h"
 #include "seeta_aip_plot_text.h"
+#include "seeta_aip_plot_objects.h"
+
+#include <iostream>
+#include <random>
+
+/**
+ * Draw object one by one with rectangle_rotate, line, circle and text, as draw_objects documented.
+ */
+static void draw_object_sequential(seeta::aip::ImageView image, const SeetaAIPObject &object,
+                                   const std::string &label, const seeta::aip::plot::ObjectStyle &style) {
+    using namespace seeta::aip;
+    auto &shape = object.shape;
+    auto points = shape.landmarks.data;
+    auto size = shape.landmarks.size;
+    auto color = style.color;
+    if (style.color_by_label && object.tags.size > 0) color = plot::rcolor(object.tags.data[0].label);
+    color = plot::Color(color, style.alpha);
+    auto lw = style.line_width;
+    switch (shape.type) {
+        default:
+            break;
+        case SEETA_AIP_POINTS:
+            for (uint32_t i = 0; i < size; ++i) plot::circle(image, points[i], style.point_radius, color, -1);
+            break;
+        case SEETA_AIP_LINES:
+            for (uint32_t i = 0; i + 1 < size; ++i) plot::line(image, points[i], points[i + 1], color, lw);
+            break;
+        case SEETA_AIP_POLYGON:
+            for (uint32_t i = 0; i < size; ++i) plot::line(image, points[i], points[(i + 1) % size], color, lw);
+            break;
+        case SEETA_AIP_RECTANGLE:
+            plot::rectangle_rotate(image, points[0], points[1], color, shape.rotate, lw);
+            break;
+        case SEETA_AIP_CIRCLE:
+            plot::circle(image, points[0], int(lroundf(shape.scale)), color, lw);
+            break;
+    }
+    if (label.empty() || style.font_scale <= 0) return;
+    SeetaAIPPoint anchor = points[0];
+    if (shape.type == SEETA_AIP_CIRCLE) {
+        anchor = {points[0].x - shape.scale, points[0].y - shape.scale};
+    } else {
+        for (uint32_t i = 1; i < size; ++i) {
+            anchor.x = std::min(anchor.x, points[i].x);
+            anchor.y = std::min(anchor.y, points[i].y);
+        }
+    }
+    auto text_height = float(plot::LetterFont::Height() + 1) * style.font_scale;
+    if (anchor.y >= text_height) anchor.y -= text_height;
+    plot::text(image, label, anchor, color, style.font_scale);
+}
+
+/**
+ * Banded parallel draw_objects must be byte for byte same as drawing objects one by one,
+ * with translucent objects overlapping each other across bands of several images.
+ */
+static int check_draw_objects() {
+    using namespace seeta::aip;
+    int failed = 0;
+    const int W = 320, H = 480, N = 2, COUNT = 40;
+    ImageData image(SEETA_AIP_FORMAT_U8RGB, N, W, H, 3);
+    for (size_t i = 0; i < image.bytes(); ++i) image.data<uint8_t>()[i] = uint8_t(i * 7 % 251);
+
+    std::mt19937 rand(4399);
+    auto coord = [&](int range) { return float(int(rand() % (range + 80)) - 40) + float(rand() % 4) / 4; };
+    SEETA_AIP_SHAPE_TYPE types[] = {SEETA_AIP_RECTANGLE, SEETA_AIP_CIRCLE, SEETA_AIP_POINTS,
+                                    SEETA_AIP_LINES, SEETA_AIP_POLYGON};
+    std::vector<std::vector<SeetaAIPPoint>> points(N * COUNT);
+    std::vector<SeetaAIPObjectTag> tags(N * COUNT * 2);
+    std::vector<std::vector<SeetaAIPObject>> objects(N);
+    for (int n = 0; n < N; ++n) {
+        for (int i = 0; i < COUNT; ++i) {
+            auto k = n * COUNT + i;
+            auto type = types[k % 5];
+            // tall shapes span several bands
+            auto x = coord(W);
+            auto y = coord(H);
+            points[k] = {{x, y}, {x + float(rand() % 120), y + float(rand() % 200)}, {coord(W), coord(H)}};
+            SeetaAIPObject object = {};
+            object.shape.type = type;
+            object.shape.landmarks = {points[k].data(), type == SEETA_AIP_RECTANGLE ? 2u : 3u};
+            object.shape.rotate = k % 3 == 0 ? float(rand() % 90) : 0;
+            object.shape.scale = float(rand() % 60);
+            tags[k * 2] = {int32_t(rand() % 6), float(rand() % 100) / 100};
+            tags[k * 2 + 1] = {int32_t(rand() % 6), float(rand() % 100) / 100};
+            object.tags = {&tags[k * 2], uint32_t(k % 3)};
+            objects[n].push_back(object);
+        }
+    }
+    auto resolver = [](uint32_t, int32_t label) { return label == 1 ? std::string("face") : std::string(); };
+
+    // own pool, so bands really run in parallel on single core machine
+    for (auto threads : {Executor(1), Executor(std::make_shared<ThreadPool>(3))}) {
+        for (uint8_t alpha : {uint8_t(255), uint8_t(100)}) {
+            plot::ObjectStyle style;
+            style.score = true;
+            style.alpha = alpha;
+            style.font_scale = alpha == 255 ? 1.0f : 1.5f;
+            style.line_width = alpha == 255 ? 3 : 2;
+
+            ImageData expected(image.format(), N, W, H, 3);
+            std::memcpy(expected.data(), image.data(), image.bytes());
+            for (int n = 0; n < N; ++n) {
+                ImageView view(expected);
+                view.number = 1;
+                view.data = expected.data<uint8_t>() + size_t(n) * W * H * 3;
+                for (auto &object : objects[n]) {
+                    std::string label;
+                    for (uint32_t t = 0; t < object.tags.size; ++t) {
+                        auto &tag = object.tags.data[t];
+                        auto name = resolver(t, tag.label);
+                        if (!label.empty()) label += " ";
+                        label += name.empty() ? std::to_string(tag.label) : name;
+                        char buffer[32];
+                        std::snprintf(buffer, sizeof(buffer), ":%.2f", tag.score);
+                        label += buffer;
+                    }
+                    draw_object_sequential(view, object, label, style);
+                }
+            }
+
+            ImageData got(image.format(), N, W, H, 3);
+            std::memcpy(got.data(), image.data(), image.bytes());
+            plot::draw_objects(threads, got, objects, resolver, style);
+            if (!std::equal(got.data<uint8_t>(), got.data<uint8_t>() + got.bytes(), expected.data<uint8_t>())) {
+                size_t diff = 0;
+                for (size_t i = 0; i < got.bytes(); ++i) {
+                    if (got.data<uint8_t>()[i] != expected.data<uint8_t>()[i]) ++diff;
+                }
+                std::cout << "[FAILED] draw_objects with " << threads.size() << " threads and alpha " << int(alpha)
+                          << " got " << diff << " bytes differ from drawing one by one." << std::endl;
+                ++failed;
+            }
+        }
+    }
+    return failed;
+}
 
 int main() {
     using namespace seeta::aip;
@@ -90,6 +227,29 @@ int main() {
 
     plot::put_uint8_ascii(image, 'a', {520, 100}, plot::Red, 3);
 
+    {
+        SeetaAIPPoint box[] = {{40, 560}, {140, 620}};
+        SeetaAIPPoint ring[] = {{220, 590}};
+        SeetaAIPObjectTag tags[] = {{1, 0.98f}, {2, 0.5f}};
+        SeetaAIPObject objects[2] = {};
+        objects[0].shape = {SEETA_AIP_RECTANGLE, {box, 2}, 15, 1};
+        objects[0].tags = {&tags[0], 1};
+        objects[1].shape = {SEETA_AIP_CIRCLE, {ring, 1}, 0, 20};
+        objects[1].tags = {&tags[1], 1};
+        plot::ObjectStyle style;
+        style.score = true;
+        plot::draw_objects(4, image, objects, 2, [](uint32_t, int32_t label) {
+            return label == 1 ? std::string("face") : std::string();
+        }, style);
+    }
+
     imwrite("test.png", image);
+
+    auto failed = check_draw_objects();
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
     return 0;
 }
\ No newline at end of file
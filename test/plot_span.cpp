@@ -0,0 +1,192 @@
+#include "seeta_aip_plot.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <functional>
+#include <cstring>
+
+using Coverage = std::function<float(int32_t x, int32_t y)>;
+
+/**
+ * per pixel reference, each pixel of whole image is plotted by put_uint8_pixel with its coverage
+ * @param coverage covered part of pixel, in [0, 1] after clamp
+ */
+static void reference(const seeta::aip::ImageData &image, const seeta::aip::plot::Color &color,
+                      const Coverage &coverage) {
+    using namespace seeta::aip::plot;
+    for (int32_t y = 0; y < int32_t(image.height()); ++y) {
+        for (int32_t x = 0; x < int32_t(image.width()); ++x) {
+            auto part = _coverage(coverage(x, y));
+            if (part <= 0) continue;
+            put_uint8_pixel(image, x, y, Color(color, uint8_t(color.c4 * part / 255)));
+        }
+    }
+}
+
+/**
+ * coverage of integer box [left, right) x [top, bottom)
+ */
+static Coverage box(int32_t left, int32_t top, int32_t right, int32_t bottom) {
+    return [=](int32_t x, int32_t y) {
+        return x >= left && x < right && y >= top && y < bottom ? 1.0f : 0.0f;
+    };
+}
+
+static Coverage rectangle(const SeetaAIPPoint &p1, const SeetaAIPPoint &p2, int line_width) {
+    auto area_width = p2.x - p1.x;
+    auto area_height = p2.y - p1.y;
+    if (line_width < 0) {
+        auto top = int32_t(lroundf(p1.y));
+        auto left = int32_t(lroundf(p1.x));
+        return box(left, top, int32_t(lroundf(left + area_width + 1)), int32_t(lroundf(top + area_height + 1)));
+    }
+    auto half = (line_width - 1) / 2;
+    auto top = int32_t(lroundf(p1.y - half));
+    auto bottom = int32_t(lroundf(top + area_height + float(line_width)));
+    auto left = int32_t(lroundf(p1.x - half));
+    auto right = int32_t(lroundf(left + area_width + float(line_width)));
+    auto outer = box(left, top, right, bottom);
+    auto inner = box(left + line_width, top + line_width, right - line_width, bottom - line_width);
+    return [=](int32_t x, int32_t y) { return outer(x, y) - inner(x, y); };
+}
+
+static Coverage circle(const SeetaAIPPoint &center, int radius, int line_width) {
+    using namespace seeta::aip::plot;
+    if (line_width < 0) {
+        return [=](int32_t x, int32_t y) {
+            return radius + 0.5f - _distance(center, {float(x), float(y)});
+        };
+    }
+    auto half = float(line_width) / 2;
+    auto inner = radius - half - 0.5f;
+    auto outer = radius + half + 0.5f;
+    return [=](int32_t x, int32_t y) {
+        auto d = _distance(center, {float(x), float(y)});
+        return std::min(outer - d, d - inner);
+    };
+}
+
+static Coverage line(const SeetaAIPPoint &p1, const SeetaAIPPoint &p2, int line_width) {
+    using namespace seeta::aip::plot;
+    if (_distance(p1, p2) < 1e-3) return circle(p1, line_width / 2, -1);
+    auto half = float(line_width) / 2;
+    _Segment segment(p1, p2);
+    return [=](int32_t x, int32_t y) {
+        return half + 0.5f - segment.distance(float(x), float(y));
+    };
+}
+
+static seeta::aip::ImageData copy(const seeta::aip::ImageData &image) {
+    seeta::aip::ImageData dolly(image.format(), image.number(), image.width(), image.height(), image.channels());
+    std::memcpy(dolly.data(), image.data(), image.bytes());
+    return dolly;
+}
+
+/**
+ * @return number of different bytes
+ */
+static int diff(const seeta::aip::ImageData &a, const seeta::aip::ImageData &b) {
+    int count = 0;
+    for (size_t i = 0; i < a.bytes(); ++i) {
+        if (a.data<uint8_t>()[i] != b.data<uint8_t>()[i]) ++count;
+    }
+    return count;
+}
+
+int main() {
+    using namespace seeta::aip;
+
+    std::mt19937 rand(4399);
+    const int width = 97, height = 71;
+
+    struct Shape {
+        const char *name;
+        std::function<void(const ImageView &, const plot::Color &)> plot;
+        Coverage coverage;
+    };
+
+    std::vector<Shape> shapes;
+    auto add_rectangle = [&](const char *name, SeetaAIPPoint p1, SeetaAIPPoint p2, int line_width) {
+        shapes.push_back({name, [=](const ImageView &image, const plot::Color &color) {
+            plot::rectangle(image, p1, p2, color, line_width);
+        }, rectangle(p1, p2, line_width)});
+    };
+    auto add_circle = [&](const char *name, SeetaAIPPoint center, int radius, int line_width) {
+        shapes.push_back({name, [=](const ImageView &image, const plot::Color &color) {
+            plot::circle(image, center, radius, color, line_width);
+        }, circle(center, radius, line_width)});
+    };
+    auto add_line = [&](const char *name, SeetaAIPPoint p1, SeetaAIPPoint p2, int line_width) {
+        shapes.push_back({name, [=](const ImageView &image, const plot::Color &color) {
+            plot::line(image, p1, p2, color, line_width);
+        }, line(p1, p2, line_width)});
+    };
+
+    add_rectangle("fill rectangle", {10.3f, 12.6f}, {40.5f, 30.2f}, -1);
+    add_rectangle("rectangle", {10.3f, 12.6f}, {40.5f, 30.2f}, 3);
+    add_rectangle("thick rectangle", {30, 20}, {31, 22}, 15);
+    add_rectangle("rectangle out of left top", {-20, -10}, {30, 40}, 4);
+    add_rectangle("fill rectangle out of right bottom", {80, 60}, {130, 90}, -1);
+    add_circle("fill circle", {48.5f, 35.2f}, 13, -1);
+    add_circle("circle", {48.5f, 35.2f}, 19, 3);
+    add_circle("thin circle", {20.7f, 50.1f}, 9, 1);
+    add_circle("fill circle out of left", {-5.5f, 30}, 17, -1);
+    add_circle("circle out of bottom right", {90, 66.5f}, 22, 4);
+    add_circle("circle around image", {48, 35}, 70, 5);
+    add_line("line", {5.5f, 7.2f}, {88.1f, 60.9f}, 1);
+    add_line("thick line", {60, 10}, {20, 50}, 7);
+    add_line("steep line", {30.2f, 2}, {33.7f, 69}, 3);
+    add_line("horizontal line", {3, 40}, {93, 40}, 2);
+    add_line("vertical line", {70.5f, 5}, {70.5f, 65}, 4);
+    add_line("point line", {50.2f, 50.7f}, {50.2f, 50.7f}, 6);
+    add_line("line out of image", {-30, -20}, {130, 100}, 5);
+    add_line("line through corner", {-10, 60}, {20, 90}, 9);
+
+    std::vector<plot::Color> colors = {{255, 40, 10, 255}, {20, 200, 90, 128}, {5, 6, 250, 17}};
+
+    int failed = 0;
+    for (int channels : {1, 3, 4}) {
+        auto format = channels == 1 ? SEETA_AIP_FORMAT_U8Y
+                                    : channels == 3 ? SEETA_AIP_FORMAT_U8BGR : SEETA_AIP_FORMAT_U8BGRA;
+        ImageData background(format, width, height, channels);
+        for (size_t i = 0; i < background.bytes(); ++i) background.data<uint8_t>()[i] = uint8_t(rand());
+        for (auto &shape : shapes) {
+            for (auto &color : colors) {
+                auto expected = copy(background);
+                auto got = copy(background);
+                reference(expected, color, shape.coverage);
+                shape.plot(got, color);
+                auto count = diff(expected, got);
+                if (count) {
+                    std::cout << shape.name << " with " << channels << " channels, alpha " << int(color.c4)
+                              << ": " << count << " bytes differ from per pixel reference" << std::endl;
+                    ++failed;
+                }
+            }
+        }
+    }
+
+    // spans of strided view stay in the view
+    {
+        ImageData image(SEETA_AIP_FORMAT_U8BGR, width, height, 3);
+        std::memset(image.data(), 7, image.bytes());
+        auto expected = copy(image);
+        auto view = image.roi(20, 10, 40, 30);
+        plot::circle(view, {20, 15}, 30, {255, 255, 255, 255}, -1);
+        for (int32_t y = 10; y < 40; ++y) {
+            std::memset(expected.data<uint8_t>() + (y * width + 20) * 3, 255, 40 * 3);
+        }
+        if (diff(expected, image)) {
+            std::cout << "fill circle over strided view differs" << std::endl;
+            ++failed;
+        }
+    }
+
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
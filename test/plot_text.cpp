@@ -0,0 +1,168 @@
+#include "seeta_aip_plot_text.h"
+
+#include <iostream>
+#include <random>
+#include <cstring>
+#include <thread>
+
+/**
+ * per letter reference, each letter is sampled from font by _prepare_ascii at snapped origin
+ * and plotted by put_uint8_pixel
+ */
+static int reference_text(const seeta::aip::ImageData &image, const std::string &msg,
+                          const SeetaAIPPoint &left_top, const seeta::aip::plot::Color &color,
+                          float font_scale, int endl) {
+    using namespace seeta::aip::plot;
+    TextEditor editor(left_top.x, left_top.y, font_scale, endl);
+    for (auto &ch : msg) {
+        auto cursor = editor.cursor();
+        if (!editor.advance(ch)) continue;
+        auto c = color;
+        for (auto &p : _prepare_ascii(image.width(), image.height(), ch, GlyphAtlas::Snap(cursor),
+                                      std::max(font_scale, 1.0f))) {
+            c.c4 = uint8_t(color.c4 * p.alpha / 255);
+            put_uint8_pixel(image, p.x, p.y, c);
+        }
+    }
+    return editor.line() + 1;
+}
+
+static seeta::aip::ImageData copy(const seeta::aip::ImageData &image) {
+    seeta::aip::ImageData dolly(image.format(), image.number(), image.width(), image.height(), image.channels());
+    std::memcpy(dolly.data(), image.data(), image.bytes());
+    return dolly;
+}
+
+int main() {
+    using namespace seeta::aip;
+
+    struct Case {
+        const char *msg;
+        SeetaAIPPoint left_top;
+        float scale;
+        int endl;
+    };
+    std::vector<Case> cases = {
+            {"Hello, World!",                  {3, 4},            1,     -1},
+            {"Hello, World!",                  {3.25f, 4.75f},    1,     -1},
+            {"gjpqy 0123456789",               {10.4f, 20.6f},    1.5f,  -1},
+            {"Scale 2.3, wrapped at endl",     {2.7f, 30.3f},     2.3f,  150},
+            {"tab\tnew\nline\r_back",          {5.5f, 60.1f},     1.75f, -1},
+            {"out of image",                   {-13.4f, -7.8f},   2.5f,  -1},
+            {"right bottom edge",              {140.6f, 105.3f},  3,     -1},
+            {"small scale clamp",              {20.2f, 90.9f},    0.5f,  -1},
+    };
+    std::vector<plot::Color> colors = {{250, 20, 60, 255}, {10, 220, 130, 100}};
+
+    std::mt19937 rand(4399);
+    int failed = 0;
+    for (int channels : {1, 3, 4}) {
+        auto format = channels == 1 ? SEETA_AIP_FORMAT_U8Y
+                                    : channels == 3 ? SEETA_AIP_FORMAT_U8BGR : SEETA_AIP_FORMAT_U8BGRA;
+        ImageData background(format, 173, 121, channels);
+        for (size_t i = 0; i < background.bytes(); ++i) background.data<uint8_t>()[i] = uint8_t(rand());
+        for (auto &c : cases) {
+            for (auto &color : colors) {
+                auto expected = copy(background);
+                auto got = copy(background);
+                auto expected_lines = reference_text(expected, c.msg, c.left_top, color, c.scale, c.endl);
+                auto lines = plot::text(got, c.msg, c.left_top, color, c.scale, c.endl);
+                int count = 0;
+                for (size_t i = 0; i < got.bytes(); ++i) {
+                    if (got.data<uint8_t>()[i] != expected.data<uint8_t>()[i]) ++count;
+                }
+                if (count || lines != expected_lines) {
+                    std::cout << "\"" << c.msg << "\" at (" << c.left_top.x << ", " << c.left_top.y
+                              << ") scale " << c.scale << " with " << channels << " channels, alpha "
+                              << int(color.c4) << ": " << count << " bytes differ, lines " << lines
+                              << " expected " << expected_lines << std::endl;
+                    ++failed;
+                }
+            }
+        }
+    }
+
+    // glyphs built by other thread are shared, result is same as building them here
+    {
+        plot::GlyphAtlas::Global().clear();
+        ImageData image(SEETA_AIP_FORMAT_U8BGR, 173, 121, 3);
+        std::memset(image.data(), 0, image.bytes());
+        auto expected = copy(image);
+        reference_text(expected, "Atlas", {7.5f, 9.25f}, plot::Color(0, 0, 255, 255), 2.5f, -1);
+        std::thread([&]() { plot::text(image, "Atlas", {7.5f, 9.25f}, plot::Color(0, 0, 255, 255), 2.5f); }).join();
+        std::memset(image.data(), 0, image.bytes());
+        plot::text(image, "Atlas", {7.5f, 9.25f}, plot::Color(0, 0, 255, 255), 2.5f);
+        if (std::memcmp(image.data(), expected.data(), image.bytes()) != 0) {
+            std::cout << "cached glyphs differ from per letter reference" << std::endl;
+            ++failed;
+        }
+    }
+
+    // origins on same 1/4 pixel share glyph, least recently used letter is dropped when full
+    {
+        plot::GlyphAtlas atlas(2);
+        auto a = atlas.get('a', {3.1f, 5.0f}, 1.5f);
+        if (atlas.get('a', {10.05f, 7.12f}, 1.5f) != a || atlas.get('a', {2.9f, 6.95f}, 1.5f) != a) {
+            std::cout << "origins snapped to same offset got different glyphs" << std::endl;
+            ++failed;
+        }
+        if (atlas.get('a', {3.25f, 5.0f}, 1.5f) == a || atlas.get('a', {3.0f, 5.0f}, 2.0f) == a) {
+            std::cout << "different offset or scale got same glyph" << std::endl;
+            ++failed;
+        }
+        atlas.clear();
+        a = atlas.get('a', {0, 0}, 1.0f);
+        auto b = atlas.get('b', {0, 0}, 1.0f);
+        atlas.get('a', {0, 0}, 1.0f);
+        atlas.get('c', {0, 0}, 1.0f);
+        if (atlas.get('a', {0, 0}, 1.0f) != a || atlas.get('b', {0, 0}, 1.0f) == b) {
+            std::cout << "atlas dropped recently used letter instead of least recently used" << std::endl;
+            ++failed;
+        }
+    }
+
+    // small atlas shared by threads keeps evicting, all letters still drawn same as reference
+    {
+        plot::GlyphAtlas atlas(3);
+        std::string msg = "The quick brown fox jumps over the lazy dog";
+        std::vector<std::thread> threads;
+        std::vector<int> mismatch(4, 0);
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int round = 0; round < 20; ++round) {
+                    SeetaAIPPoint origin = {t * 0.3f + round * 0.17f, 1.6f};
+                    for (size_t i = 0; i < msg.size(); ++i) {
+                        auto glyph = atlas.get(msg[i], origin, 1.0f + t * 0.5f);
+                        std::vector<plot::PutSpan> expected;
+                        for (auto &p : plot::_prepare_ascii(INT32_MAX, INT32_MAX, msg[i],
+                                                            plot::GlyphAtlas::Snap(origin), 1.0f + t * 0.5f)) {
+                            plot::_push_span(expected, INT32_MAX, INT32_MAX, p.x, p.x + 1, p.y, p.alpha);
+                        }
+                        std::vector<plot::PutSpan> got;
+                        plot::_blit_glyph(got, INT32_MAX, INT32_MAX, *glyph, origin);
+                        if (got.size() != expected.size() ||
+                            !std::equal(got.begin(), got.end(), expected.begin(), [](const plot::PutSpan &a, const plot::PutSpan &b) {
+                                return a.y == b.y && a.x0 == b.x0 && a.x1 == b.x1 && a.alpha == b.alpha;
+                            })) {
+                            ++mismatch[t];
+                        }
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        for (int t = 0; t < 4; ++t) {
+            if (mismatch[t]) {
+                std::cout << "thread " << t << " got " << mismatch[t] << " glyphs differ from reference" << std::endl;
+                ++failed;
+            }
+        }
+    }
+
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "seeta_aip_image.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cmath>
+
+/**
+ * HWC or CHW float value of pixel (x, y) channel c of image n
+ */
+static float at(const seeta::aip::ImageData &image, int n, int y, int x, int c) {
+    auto W = int(image.width()), H = int(image.height()), C = int(image.channels());
+    auto chw = (image.format() & 0xffff0000) == 0x80000;
+    auto index = chw ? ((size_t(n) * C + c) * H + y) * W + x : ((size_t(n) * H + y) * W + x) * C + c;
+    if (seeta::aip::ImageData::GetType(image.format()) == SEETA_AIP_VALUE_FLOAT32) return image.data<float>()[index];
+    return float(image.data<uint8_t>()[index]);
+}
+
+/**
+ * Compare single pass preprocess with resize, convert then normalize.
+ * @param reference resized and converted image, HWC
+ * @param tolerance max diff in source value units
+ * @return number of failed checks
+ */
+static int check(const char *name, const seeta::aip::ImageData &output, const seeta::aip::ImageData &reference,
+                 const seeta::aip::PreprocessParam &param, float tolerance) {
+    if (output.number() != reference.number() || output.width() != reference.width()
+        || output.height() != reference.height() || output.channels() != reference.channels()) {
+        std::cout << name << ": shape mismatch" << std::endl;
+        return 1;
+    }
+    float diff = 0;
+    for (int n = 0; n < int(output.number()); ++n) {
+        for (int y = 0; y < int(output.height()); ++y) {
+            for (int x = 0; x < int(output.width()); ++x) {
+                for (int c = 0; c < int(output.channels()); ++c) {
+                    auto expected = (at(reference, n, y, x, c) - param.mean[c]) / param.std[c];
+                    auto got = at(output, n, y, x, c);
+                    // value is in units of std
+                    diff = std::max(diff, std::fabs(got - expected) * param.std[c]);
+                }
+            }
+        }
+    }
+    std::cout << name << ": max diff " << diff << std::endl;
+    if (diff > tolerance) {
+        std::cout << name << ": diff over " << tolerance << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    using namespace seeta::aip;
+
+    std::mt19937 rand(4399);
+    const int number = 2, width = 67, height = 45;
+    const int out_width = 40, out_height = 32;
+
+    ImageData bgr(SEETA_AIP_FORMAT_U8BGR, number, width, height, 3);
+    for (size_t i = 0; i < bgr.bytes(); ++i) bgr.data<uint8_t>()[i] = uint8_t(rand());
+
+    PreprocessParam param(SEETA_AIP_FORMAT_U8RGB, {123.7f, 116.3f, 103.5f}, {58.4f, 57.1f, 57.4f});
+
+    int failed = 0;
+    // resize rounds to byte, so reference may be off by 0.5, and by fixed point weights
+    const float byte_tolerance = 1.5f;
+
+    auto resized = resize(1, bgr, out_width, out_height, RESIZE_LINEAR);
+    auto rgb = convert(1, SEETA_AIP_FORMAT_U8RGB, resized);
+    auto gray = convert(1, SEETA_AIP_FORMAT_U8Y, resized);
+
+    failed += check("BGR to F32RAW as RGB", preprocess(1, SEETA_AIP_FORMAT_F32RAW, bgr, out_width, out_height, param),
+                    rgb, param, byte_tolerance);
+    failed += check("BGR to CHW_F32RAW as RGB",
+                    preprocess(4, SEETA_AIP_FORMAT_CHW_F32RAW, bgr, out_width, out_height, param),
+                    rgb, param, byte_tolerance);
+    failed += check("BGR to CHW_U8RGB", preprocess(1, SEETA_AIP_FORMAT_CHW_U8RGB, bgr, out_width, out_height),
+                    rgb, PreprocessParam(), byte_tolerance + 0.5f);
+    failed += check("BGR to F32RAW as gray",
+                    preprocess(1, SEETA_AIP_FORMAT_F32RAW, bgr, out_width, out_height,
+                               PreprocessParam(SEETA_AIP_FORMAT_U8Y, {127.5f}, {128.0f})),
+                    gray, PreprocessParam(SEETA_AIP_FORMAT_U8Y, {127.5f}, {128.0f}), byte_tolerance + 1);
+    failed += check("BGR to F32RAW by default",
+                    preprocess(1, SEETA_AIP_FORMAT_F32RAW, bgr, out_width, out_height),
+                    resized, PreprocessParam(), byte_tolerance);
+
+    // raw sources keep channels with default param
+    ImageData raw(SEETA_AIP_FORMAT_F32RAW, number, width, height, 2);
+    for (size_t i = 0; i < raw.bytes() / sizeof(float); ++i) raw.data<float>()[i] = float(rand() % 10000) / 100.0f;
+    PreprocessParam raw_param;
+    raw_param.mean[0] = 10;
+    raw_param.mean[1] = 20;
+    raw_param.std[0] = 2;
+    raw_param.std[1] = 4;
+    auto raw_resized = resize(1, raw, out_width, out_height, RESIZE_LINEAR);
+    try {
+        failed += check("F32RAW to CHW_F32RAW",
+                        preprocess(1, SEETA_AIP_FORMAT_CHW_F32RAW, raw, out_width, out_height, raw_param),
+                        raw_resized, raw_param, 1e-3f);
+    } catch (const Exception &e) {
+        std::cout << "F32RAW to CHW_F32RAW: " << e.what() << std::endl;
+        ++failed;
+    }
+
+    ImageData raw_u8(SEETA_AIP_FORMAT_U8RAW, number, width, height, 4);
+    for (size_t i = 0; i < raw_u8.bytes(); ++i) raw_u8.data<uint8_t>()[i] = uint8_t(rand());
+    failed += check("U8RAW to F32RAW", preprocess(1, SEETA_AIP_FORMAT_F32RAW, raw_u8, out_width, out_height),
+                    resize(1, raw_u8, out_width, out_height, RESIZE_LINEAR), PreprocessParam(), byte_tolerance);
+
+    // color order from raw source is rejected with a hint
+    try {
+        preprocess(1, SEETA_AIP_FORMAT_F32RAW, raw, out_width, out_height, param);
+        std::cout << "F32RAW as RGB: not rejected" << std::endl;
+        ++failed;
+    } catch (const Exception &e) {
+        std::cout << "F32RAW as RGB: rejected, " << e.message() << std::endl;
+    }
+
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}
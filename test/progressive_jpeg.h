@@ -0,0 +1,131 @@
+#ifndef SEETA_AIP_TEST_PROGRESSIVE_JPEG_H
+#define SEETA_AIP_TEST_PROGRESSIVE_JPEG_H
+
+/**
+ * 203x147 progressive JPEG of smooth pattern, same as pattern() in test/image_io.cpp
+ */
+static const unsigned char progressive_jpeg[] = {
+        0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+        0x00, 0x01, 0x00, 0x00, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x0d, 0x09, 0x0a, 0x0b, 0x0a, 0x08, 0x0d,
+        0x0b, 0x0a, 0x0b, 0x0e, 0x0e, 0x0d, 0x0f, 0x13, 0x20, 0x15, 0x13, 0x12, 0x12, 0x13, 0x27, 0x1c,
+        0x1e, 0x17, 0x20, 0x2e, 0x29, 0x31, 0x30, 0x2e, 0x29, 0x2d, 0x2c, 0x33, 0x3a, 0x4a, 0x3e, 0x33,
+        0x36, 0x46, 0x37, 0x2c, 0x2d, 0x40, 0x57, 0x41, 0x46, 0x4c, 0x4e, 0x52, 0x53, 0x52, 0x32, 0x3e,
+        0x5a, 0x61, 0x5a, 0x50, 0x60, 0x4a, 0x51, 0x52, 0x4f, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x0e, 0x0e,
+        0x0e, 0x13, 0x11, 0x13, 0x26, 0x15, 0x15, 0x26, 0x4f, 0x35, 0x2d, 0x35, 0x4f, 0x4f, 0x4f, 0x4f,
+        0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f,
+        0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f,
+        0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0x4f, 0xff, 0xc2,
+        0x00, 0x11, 0x08, 0x00, 0x93, 0x00, 0xcb, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+        0x01, 0xff, 0xc4, 0x00, 0x18, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x03, 0x00, 0x04, 0xff, 0xc4, 0x00, 0x19, 0x01,
+        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x03, 0x02, 0x01, 0x00, 0x04, 0x05, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x10, 0x03,
+        0x10, 0x00, 0x00, 0x01, 0xf7, 0x20, 0xbe, 0x20, 0xe8, 0x82, 0xe7, 0x54, 0xde, 0xbb, 0xd3, 0xb7,
+        0xba, 0x74, 0xb3, 0x86, 0x94, 0x18, 0x69, 0x40, 0x86, 0x94, 0x0e, 0x9d, 0x2c, 0xed, 0x36, 0xb1,
+        0x20, 0xba, 0x9a, 0x0b, 0x9b, 0x44, 0x16, 0x3f, 0x9d, 0x62, 0xfe, 0x7b, 0xea, 0xb2, 0x5c, 0xda,
+        0xdc, 0xaf, 0x26, 0x9d, 0x9f, 0x57, 0x32, 0x65, 0x9a, 0x24, 0xd8, 0xd3, 0x0a, 0x05, 0x84, 0xa0,
+        0x38, 0x3a, 0xcd, 0xdc, 0xfa, 0xb3, 0x55, 0x8a, 0xda, 0xd9, 0x62, 0xf1, 0xb6, 0x58, 0xae, 0x7f,
+        0x2a, 0xc1, 0xf8, 0x3d, 0x5b, 0xac, 0x17, 0x36, 0xd7, 0x2e, 0xeb, 0xd7, 0xb3, 0x95, 0xda, 0x40,
+        0x6e, 0x19, 0x06, 0xc5, 0x90, 0x53, 0xce, 0xc8, 0x88, 0x0e, 0x67, 0xd6, 0x7a, 0x5c, 0xba, 0xb3,
+        0x65, 0x8d, 0xdb, 0xdd, 0xf9, 0xdf, 0x2e, 0xeb, 0x05, 0x8f, 0xe5, 0x58, 0x3f, 0x0f, 0xaf, 0x65,
+        0x8a, 0xe6, 0xda, 0xe3, 0x79, 0x35, 0xec, 0xba, 0xbb, 0x42, 0x25, 0x1b, 0x20, 0xa0, 0xa2, 0x4a,
+        0x79, 0xd4, 0x05, 0x03, 0x49, 0x9f, 0x59, 0xe9, 0x72, 0xea, 0xcd, 0x96, 0x0b, 0x6f, 0x75, 0x83,
+        0xc6, 0xdd, 0x60, 0xb9, 0xbc, 0xaf, 0x17, 0xe0, 0xf5, 0x6a, 0xb2, 0x5c, 0xda, 0x51, 0xdc, 0x9a,
+        0x43, 0x37, 0x94, 0x86, 0xce, 0x98, 0x50, 0x69, 0x85, 0x3c, 0xf6, 0x18, 0x81, 0x78, 0x75, 0x9b,
+        0xe1, 0x6b, 0x34, 0xb9, 0xde, 0xbd, 0x5e, 0x4b, 0x9b, 0x55, 0x9d, 0xc6, 0xc1, 0x07, 0xf3, 0xdd,
+        0x22, 0xb1, 0x95, 0x37, 0x52, 0xf7, 0x4d, 0xee, 0x36, 0x59, 0xc3, 0x4a, 0x09, 0x28, 0xa7, 0x9c,
+        0xcb, 0x10, 0x64, 0xee, 0xb2, 0xeb, 0x3b, 0x71, 0x23, 0x76, 0xda, 0x0f, 0x99, 0xa0, 0xb1, 0xb2,
+        0x7c, 0xbe, 0x62, 0x72, 0xe5, 0x8d, 0x2a, 0xbc, 0x86, 0x3e, 0xae, 0xce, 0x68, 0x6c, 0xf3, 0x3a,
+        0x14, 0x1c, 0xce, 0x85, 0x3c, 0xf9, 0x9d, 0x25, 0x86, 0x7c, 0xe5, 0x99, 0xe5, 0x6b, 0x25, 0xb7,
+        0x6f, 0x9f, 0x2e, 0x6e, 0x55, 0x63, 0x04, 0x9f, 0xc9, 0xd2, 0x92, 0xc6, 0x15, 0xdd, 0xbc, 0xfb,
+        0x59, 0xbd, 0x94, 0xd6, 0x5c, 0x62, 0x76, 0x28, 0x18, 0x9d, 0x8a, 0x06, 0x27, 0x62, 0x81, 0x94,
+        0xd7, 0xac, 0xf2, 0xba, 0x75, 0x60, 0x49, 0x75, 0x94, 0x9f, 0x29, 0x49, 0x63, 0xc6, 0x9f, 0xc8,
+        0x90, 0x9a, 0xc6, 0xce, 0xe9, 0x75, 0x32, 0xed, 0xa6, 0xf6, 0x33, 0x69, 0x67, 0x81, 0xdc, 0xa0,
+        0xe0, 0x77, 0x29, 0xe7, 0xc0, 0xee, 0x50, 0x71, 0xed, 0x7a, 0xcb, 0x2e, 0xd7, 0xab, 0x33, 0x5a,
+        0x5e, 0xb0, 0xd3, 0xe6, 0x09, 0xac, 0x62, 0xfb, 0xbe, 0x46, 0xa5, 0xdd, 0xcd, 0x6f, 0x77, 0x5d,
+        0x9d, 0xd5, 0xd2, 0x77, 0x5c, 0x13, 0xdd, 0x60, 0x4f, 0x72, 0x81, 0x3d, 0xd6, 0x13, 0xbb, 0xac,
+        0xfb, 0xbb, 0xab, 0x2a, 0xee, 0xdb, 0x4f, 0xbb, 0x95, 0x2e, 0xec, 0x7f, 0xff, 0xc4, 0x00, 0x1a,
+        0x10, 0x01, 0x01, 0x01, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x11, 0x00, 0x10, 0x20, 0x30, 0x70, 0x40, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01,
+        0x05, 0x02, 0xf0, 0x26, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x71,
+        0xe4, 0xe3, 0x38, 0xe3, 0x33, 0x8e, 0x33, 0x3c, 0x19, 0xf5, 0x12, 0x23, 0x08, 0xe8, 0x30, 0x88,
+        0x88, 0x88, 0x88, 0x8c, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x23, 0xeb, 0xff,
+        0xc4, 0x00, 0x19, 0x11, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x02, 0x11, 0x10, 0x12, 0xff, 0xda, 0x00, 0x08, 0x01, 0x03,
+        0x01, 0x01, 0x3f, 0x01, 0xcc, 0x7a, 0xda, 0xb5, 0x3e, 0x96, 0x62, 0xc9, 0x05, 0xcb, 0x92, 0x5a,
+        0x2d, 0x12, 0x49, 0x72, 0x0b, 0x24, 0x16, 0x48, 0xcd, 0xcb, 0x92, 0x5a, 0x2d, 0x12, 0x4e, 0x6e,
+        0x41, 0x64, 0x82, 0xc9, 0x05, 0xcb, 0x92, 0x5a, 0x2d, 0x12, 0x49, 0x72, 0x0b, 0x24, 0x16, 0x48,
+        0x2e, 0x5c, 0x92, 0xd1, 0x68, 0x92, 0x4b, 0x90, 0x59, 0x20, 0xb3, 0x1e, 0xb6, 0xad, 0x4f, 0xa5,
+        0x98, 0xb2, 0xc3, 0x76, 0xec, 0xb6, 0x9b, 0x4c, 0xb2, 0xdd, 0x86, 0xcb, 0x0d, 0x96, 0x1b, 0xb7,
+        0x65, 0xb4, 0xda, 0x65, 0x96, 0xec, 0x36, 0x58, 0x6c, 0xea, 0x35, 0x7d, 0x5f, 0x53, 0xab, 0x5a,
+        0xb5, 0xa9, 0xd5, 0xf5, 0x7d, 0x46, 0xac, 0xea, 0x35, 0x66, 0x3d, 0x6d, 0x5a, 0x99, 0xf0, 0xb3,
+        0x17, 0xff, 0xc4, 0x00, 0x1a, 0x11, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x11, 0x12, 0x02, 0x20, 0x30, 0xff, 0xda, 0x00,
+        0x08, 0x01, 0x02, 0x01, 0x01, 0x3f, 0x01, 0xc6, 0x31, 0x89, 0x12, 0x24, 0x48, 0xc6, 0x31, 0x8c,
+        0x63, 0x18, 0xc4, 0x89, 0x12, 0x24, 0x63, 0x18, 0xc6, 0x39, 0x72, 0xe5, 0xca, 0x79, 0x4f, 0x29,
+        0xe5, 0x3c, 0xb9, 0x72, 0xe5, 0xcb, 0x97, 0x2e, 0x5c, 0xb9, 0x4f, 0x29, 0xe5, 0x3c, 0xa7, 0x97,
+        0x2e, 0x5c, 0xb9, 0x72, 0xc6, 0x31, 0x89, 0x12, 0x24, 0x48, 0xc6, 0x31, 0x8c, 0xf9, 0x88, 0x89,
+        0xf9, 0x44, 0x44, 0xfa, 0xdf, 0x88, 0x89, 0x51, 0xad, 0x6b, 0x5a, 0xd6, 0xb5, 0xa9, 0x52, 0xa5,
+        0x4a, 0xd6, 0xb5, 0xad, 0xf9, 0x88, 0x89, 0xf5, 0xff, 0xc4, 0x00, 0x14, 0x10, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xff, 0xda,
+        0x00, 0x08, 0x01, 0x01, 0x00, 0x06, 0x3f, 0x02, 0x77, 0x7f, 0xff, 0xc4, 0x00, 0x19, 0x10, 0x01,
+        0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x11, 0x30, 0x10, 0x20, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x3f, 0x21, 0x22,
+        0x38, 0x33, 0x33, 0xc0, 0x88, 0x8f, 0x08, 0x8e, 0x0c, 0xcc, 0xf0, 0x22, 0x23, 0xc1, 0x86, 0x1b,
+        0x6d, 0xb6, 0xdb, 0x6d, 0xb6, 0x59, 0x65, 0x96, 0xdb, 0x6d, 0xb6, 0xdb, 0x6d, 0x86, 0x18, 0x61,
+        0xb6, 0x18, 0x61, 0xb6, 0xdb, 0x6d, 0xb6, 0xdb, 0x65, 0x96, 0x59, 0x6d, 0xb6, 0xdb, 0x6d, 0xb6,
+        0xd8, 0x61, 0x86, 0x1b, 0x61, 0x86, 0x1b, 0x6d, 0xb6, 0xdb, 0x6d, 0xb6, 0x59, 0x65, 0x96, 0xdb,
+        0x6d, 0xb6, 0xdb, 0x6d, 0x86, 0x18, 0x61, 0xb6, 0x21, 0x0e, 0x00, 0x0c, 0x63, 0x1e, 0x00, 0x04,
+        0x21, 0x07, 0xc0, 0xc3, 0x0d, 0xb6, 0xf8, 0xdf, 0x4d, 0x98, 0xb3, 0x1f, 0x0d, 0xf1, 0xbf, 0x00,
+        0x61, 0x86, 0x3c, 0x06, 0x18, 0x6d, 0xb6, 0xdb, 0x6d, 0xb6, 0xd9, 0x65, 0x96, 0x5b, 0x6d, 0xb6,
+        0xdb, 0x6d, 0xb6, 0x18, 0x61, 0x86, 0xd8, 0x61, 0x86, 0xdb, 0x6d, 0xb6, 0xdb, 0x6d, 0x96, 0x59,
+        0x65, 0xb6, 0xdb, 0x6d, 0xb6, 0xdb, 0x61, 0x86, 0x18, 0x6d, 0x86, 0x18, 0x6d, 0xb6, 0xdb, 0x6d,
+        0xb6, 0xd9, 0x65, 0x96, 0x5b, 0x6d, 0xb6, 0xdb, 0x6d, 0xb6, 0x18, 0x61, 0x86, 0xd8, 0x88, 0xe0,
+        0xcc, 0xcf, 0x02, 0x22, 0x3c, 0x22, 0x38, 0x33, 0x33, 0xc0, 0x88, 0x8f, 0x08, 0x8e, 0x0c, 0xcc,
+        0xf0, 0x22, 0x23, 0xc0, 0x82, 0x0b, 0x2c, 0xb2, 0xcb, 0x2c, 0xb2, 0x49, 0x24, 0x92, 0xcb, 0x2c,
+        0xb2, 0xcb, 0x2c, 0x82, 0x08, 0x20, 0xb2, 0x08, 0x20, 0xb2, 0xcb, 0x2c, 0xb2, 0xcb, 0x24, 0x92,
+        0x49, 0x2c, 0xb2, 0xcb, 0x2c, 0xb2, 0xc8, 0x20, 0x82, 0x0b, 0x22, 0x10, 0x99, 0xe9, 0x96, 0x59,
+        0x64, 0x92, 0x49, 0x33, 0x3e, 0xc0, 0x21, 0x08, 0x4c, 0x88, 0x43, 0x80, 0x03, 0x18, 0xc7, 0x80,
+        0x01, 0x08, 0x43, 0xc0, 0x84, 0x38, 0x00, 0x31, 0x8c, 0x78, 0x00, 0x10, 0x84, 0x3c, 0x08, 0x8e,
+        0x0c, 0xcc, 0xcf, 0x02, 0x23, 0xcf, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x00, 0x03,
+        0x00, 0x00, 0x00, 0x10, 0x54, 0x0a, 0x2a, 0xac, 0x10, 0x94, 0x53, 0x8a, 0xfe, 0x09, 0xbc, 0x4e,
+        0x31, 0x93, 0xf2, 0x99, 0xa9, 0x8d, 0x6c, 0xce, 0x8c, 0xde, 0x59, 0x0e, 0x3d, 0xbe, 0xb7, 0x92,
+        0x9f, 0x1a, 0xc4, 0xe3, 0x1b, 0x3b, 0x39, 0xdb, 0x94, 0xc6, 0x8d, 0xa3, 0xdd, 0x16, 0xdb, 0xcf,
+        0xe9, 0xa5, 0x15, 0xa2, 0xdd, 0x9f, 0xcc, 0x99, 0xd3, 0x3d, 0xa1, 0x99, 0xe7, 0x60, 0xf8, 0x2f,
+        0xc9, 0x29, 0x7c, 0xb5, 0xb8, 0xd3, 0x52, 0x4c, 0x58, 0x0a, 0xd9, 0xea, 0x34, 0x85, 0x18, 0xd2,
+        0xee, 0xde, 0xa4, 0xbf, 0x36, 0xb7, 0xc2, 0x5c, 0xa5, 0x5d, 0xe8, 0xfe, 0x20, 0x3f, 0x7e, 0x0f,
+        0xc0, 0x7e, 0x27, 0xfc, 0x87, 0xcf, 0xff, 0xc4, 0x00, 0x19, 0x11, 0x01, 0x01, 0x01, 0x01, 0x01,
+        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10, 0x20, 0x21,
+        0x31, 0xff, 0xda, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01, 0x3f, 0x10, 0x11, 0x82, 0x48, 0xc2, 0x11,
+        0x92, 0x08, 0xc2, 0x3e, 0x6b, 0x95, 0xeb, 0xae, 0x9b, 0xdf, 0x3d, 0x62, 0xbd, 0x75, 0xc3, 0x6b,
+        0xe7, 0xae, 0x57, 0xae, 0xba, 0x6f, 0x7c, 0xf4, 0x88, 0xf4, 0x82, 0x0d, 0x07, 0x96, 0xa4, 0xf3,
+        0x2c, 0x6d, 0xf3, 0xa4, 0x47, 0xa4, 0x10, 0x6a, 0x3c, 0xb5, 0xca, 0xf5, 0xd7, 0x4d, 0xaf, 0x9e,
+        0x91, 0x1e, 0x50, 0x4c, 0x35, 0x1e, 0x5a, 0x93, 0xd4, 0x8d, 0xbe, 0x6f, 0xff, 0xc4, 0x00, 0x18,
+        0x11, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x01, 0x00, 0x20, 0x11, 0x10, 0xff, 0xda, 0x00, 0x08, 0x01, 0x02, 0x01, 0x01, 0x3f, 0x10,
+        0xf0, 0x21, 0x90, 0x01, 0x0d, 0x06, 0x53, 0x35, 0x52, 0x9a, 0xf0, 0x86, 0x40, 0x04, 0x34, 0x01,
+        0x0c, 0x80, 0x08, 0x68, 0x32, 0x99, 0xaa, 0x94, 0xc7, 0xf2, 0xe4, 0x10, 0x42, 0x10, 0x84, 0x10,
+        0x5c, 0xb9, 0x73, 0xd2, 0x32, 0x04, 0x65, 0xd8, 0x61, 0x94, 0xbc, 0x14, 0x43, 0x40, 0x10, 0xc8,
+        0x00, 0x86, 0x80, 0x8c, 0x81, 0x18, 0xff, 0xc4, 0x00, 0x1a, 0x10, 0x01, 0x01, 0x01, 0x01, 0x01,
+        0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x20, 0x10, 0x11,
+        0x30, 0x21, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x3f, 0x10, 0xe8, 0x23, 0xac, 0xce,
+        0x41, 0x99, 0xe9, 0x19, 0x02, 0x52, 0x94, 0x30, 0xc3, 0x7b, 0x2c, 0xb2, 0xca, 0x52, 0x94, 0xb2,
+        0xcb, 0x7b, 0x7b, 0x0c, 0x32, 0x94, 0xa5, 0x7b, 0x80, 0x08, 0x74, 0x31, 0x8e, 0x40, 0x0c, 0x63,
+        0xd0, 0x43, 0xe2, 0x00, 0x2a, 0x53, 0x1e, 0xd7, 0x35, 0x56, 0xb5, 0xef, 0x29, 0x9a, 0xa9, 0x8a,
+        0xa5, 0x3b, 0xda, 0xd7, 0x35, 0x56, 0xb5, 0xef, 0x29, 0xf1, 0xaa, 0xc0, 0x21, 0x80, 0x63, 0x90,
+        0x03, 0x18, 0xf4, 0x10, 0xc8, 0x04, 0xfc, 0x61, 0x52, 0x9d, 0xac, 0x63, 0x98, 0x83, 0x1a, 0xf5,
+        0x10, 0xf8, 0x95, 0x0a, 0x94, 0xa7, 0x36, 0xb5, 0xcd, 0x55, 0xad, 0x7b, 0xca, 0x66, 0xaa, 0x62,
+        0xa1, 0x0e, 0x86, 0x31, 0xcc, 0x01, 0x8d, 0x7a, 0x88, 0x64, 0x28, 0x60, 0x01, 0x0e, 0x86, 0x31,
+        0xc8, 0x01, 0x8c, 0x7a, 0x08, 0x68, 0x00, 0x52, 0x94, 0x30, 0xde, 0xde, 0xcb, 0x2c, 0xb2, 0x94,
+        0xa5, 0x2c, 0xb2, 0xde, 0xde, 0xc3, 0x0c, 0xa5, 0x29, 0x43, 0xf9, 0x80, 0x44, 0x71, 0x99, 0xc8,
+        0x33, 0x3d, 0x23, 0x40, 0x21, 0x08, 0x20, 0xbc, 0xbc, 0xbc, 0x92, 0x48, 0x42, 0x10, 0x92, 0x49,
+        0x2f, 0x2f, 0x20, 0x82, 0x10, 0x84, 0x20, 0xc0, 0x04, 0x3a, 0x18, 0xc7, 0x20, 0x06, 0x31, 0xe8,
+        0x21, 0x90, 0x01, 0x82, 0xa5, 0x29, 0xcd, 0xad, 0x73, 0x55, 0x6b, 0x5e, 0xf2, 0x99, 0xaa, 0x98,
+        0x80, 0x53, 0x06, 0xd7, 0x35, 0x46, 0xb1, 0xe8, 0x21, 0x90, 0x01, 0x88, 0x04, 0x3a, 0x18, 0xc7,
+        0x20, 0x06, 0x31, 0xe8, 0x21, 0x90, 0x01, 0x80, 0x04, 0x3a, 0x18, 0xc7, 0x20, 0x06, 0x31, 0xe8,
+        0x21, 0xa0, 0x00, 0x10, 0x20, 0x41, 0x01, 0x78, 0x5e, 0x17, 0x84, 0x84, 0x84, 0x08, 0x10, 0x20,
+        0x40, 0x90, 0x90, 0xbc, 0x2f, 0x08, 0x08, 0x08, 0x08, 0x10, 0x20, 0x41, 0x7f, 0xff, 0xd9,
+};
+
+#endif //SEETA_AIP_TEST_PROGRESSIVE_JPEG_H
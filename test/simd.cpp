@@ -0,0 +1,230 @@
+#include "seeta_aip_image.h"
+#include "seeta_aip_simd.h"
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstring>
+
+using UImageConverter = void (*)(const seeta::aip::Executor &, const uint8_t *, uint8_t *, int32_t);
+
+struct Case {
+    const char *name;
+    int in_channels;
+    int out_channels;
+    UImageConverter scalar;
+    seeta::aip::simd::UImageKernel seeta::aip::simd::UImageKernels::*kernel;
+};
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * run SIMD kernel and scalar code for the rest, same as convert does
+ */
+static void run_simd(const Case &c, seeta::aip::simd::UImageKernel kernel,
+                     const uint8_t *src, uint8_t *dst, int32_t N) {
+    auto done = kernel(src, dst, N);
+    c.scalar(1, src + done * c.in_channels, dst + done * c.out_channels, N - done);
+}
+
+int main() {
+    using namespace seeta::aip;
+    namespace cvt = seeta::aip::_;
+    using K = simd::UImageKernels;
+
+    std::vector<Case> cases = {
+            {"bgr2rgb",   3, 3, cvt::convert_uimage_bgr2rgb,   &K::bgr2rgb},
+            {"bgr2bgra",  3, 4, cvt::convert_uimage_bgr2bgra,  &K::bgr2bgra},
+            {"bgr2rgba",  3, 4, cvt::convert_uimage_bgr2rgba,  &K::bgr2rgba},
+            {"bgra2bgr",  4, 3, cvt::convert_uimage_bgra2bgr,  &K::bgra2bgr},
+            {"bgra2rgb",  4, 3, cvt::convert_uimage_bgra2rgb,  &K::bgra2rgb},
+            {"bgra2rgba", 4, 4, cvt::convert_uimage_bgra2rgba, &K::bgra2rgba},
+            {"y2bgr",     1, 3, cvt::convert_uimage_y2bgr,     &K::y2bgr},
+            {"y2bgra",    1, 4, cvt::convert_uimage_y2bgra,    &K::y2bgra},
+            {"bgr2y",     3, 1, cvt::convert_uimage_bgr2y,     &K::bgr2y},
+            {"bgra2y",    4, 1, cvt::convert_uimage_bgra2y,    &K::bgra2y},
+            {"rgb2y",     3, 1, cvt::convert_uimage_rgb2y,     &K::rgb2y},
+            {"rgba2y",    4, 1, cvt::convert_uimage_rgba2y,    &K::rgba2y},
+    };
+
+    std::cout << "Detected SIMD: " << simd::level_string(simd::level()) << std::endl;
+
+    std::vector<simd::Level> levels;
+    for (int level = simd::SSE41; level <= int(simd::level()); ++level) {
+        if (simd::uimage_kernels(simd::Level(level))) levels.push_back(simd::Level(level));
+    }
+
+    std::mt19937 rand(4399);
+    const int32_t N = 1920 * 1080;
+    std::vector<uint8_t> src(N * 4);
+    for (auto &v : src) v = uint8_t(rand());
+    std::vector<uint8_t> expected(N * 4);
+    std::vector<uint8_t> got(N * 4);
+
+    int failed = 0;
+    for (auto &c : cases) {
+        // correctness, including sizes with tails
+        for (auto level : levels) {
+            auto kernel = simd::uimage_kernels(level)->*c.kernel;
+            for (int32_t n : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, N}) {
+                c.scalar(1, src.data(), expected.data(), n);
+                std::fill(got.begin(), got.end(), 0xcd);
+                run_simd(c, kernel, src.data(), got.data(), n);
+                if (!std::equal(expected.begin(), expected.begin() + n * c.out_channels, got.begin())) {
+                    std::cout << "[FAILED] " << c.name << " " << simd::level_string(level) << " N=" << n << std::endl;
+                    ++failed;
+                }
+            }
+        }
+
+        // throughput
+        const int times = 20;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < times; ++i) c.scalar(1, src.data(), expected.data(), N);
+        auto scalar_ms = seconds(start) * 1000 / times;
+        std::cout << c.name << ": scalar " << scalar_ms << "ms";
+        for (auto level : levels) {
+            auto kernel = simd::uimage_kernels(level)->*c.kernel;
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < times; ++i) run_simd(c, kernel, src.data(), got.data(), N);
+            auto simd_ms = seconds(start) * 1000 / times;
+            std::cout << ", " << simd::level_string(level) << " " << simd_ms << "ms (x" << scalar_ms / simd_ms << ")";
+        }
+        std::cout << std::endl;
+    }
+
+    // resize kernels against scalar code, same fixed point so results must be equal
+    for (auto level : levels) {
+        auto kernels = simd::resize_kernels(level);
+        if (!kernels) continue;
+        for (auto method : {RESIZE_LINEAR, RESIZE_AREA}) {
+            for (int32_t C : {3, 4}) {
+                for (int32_t width : {1, 7, 64, 641, 1920}) {
+                    int32_t resized = width * 2 / 3 + 1;
+                    auto table = cvt::resize_table(method, width, resized);
+                    std::vector<int32_t> want(resized * C + 4);
+                    std::vector<int32_t> row(resized * C + 4);
+                    auto kernel = C == 3 ? kernels->c3 : kernels->c4;
+                    auto done = kernel(src.data(), width, row.data(), resized,
+                                       table->index.data(), table->fixed.data(), table->taps);
+                    if (C == 3) {
+                        cvt::resize_row_x<3>(src.data(), row.data(), *table, done, resized, C);
+                        cvt::resize_row_x<3>(src.data(), want.data(), *table, 0, resized, C);
+                    } else {
+                        cvt::resize_row_x<4>(src.data(), row.data(), *table, done, resized, C);
+                        cvt::resize_row_x<4>(src.data(), want.data(), *table, 0, resized, C);
+                    }
+                    if (!std::equal(want.begin(), want.begin() + resized * C, row.begin())) {
+                        std::cout << "[FAILED] resize row " << simd::level_string(level)
+                                  << " C=" << C << " width=" << width << std::endl;
+                        ++failed;
+                    }
+
+                    std::vector<const int32_t *> rows(table->taps, want.data());
+                    auto weight = table->fixed.data() + (resized / 2) * table->taps;
+                    std::vector<uint8_t> column(resized * C);
+                    done = kernels->column(rows.data(), weight, table->taps, column.data(), resized * C);
+                    for (int32_t i = 0; i < done; ++i) {
+                        // rows are same and weights sum to 1, so value is row rounded
+                        if (column[i] != uint8_t(std::min((want[i] + 1024) >> 11, 255))) {
+                            std::cout << "[FAILED] resize column " << simd::level_string(level) << std::endl;
+                            ++failed;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // orient kernels move bytes only, so results must be equal to plain loops
+    for (auto level : levels) {
+        auto kernels = simd::orient_kernels(level);
+        if (!kernels) continue;
+        for (int32_t pixel = 1; pixel <= 4; ++pixel) {
+            if (!kernels->transpose[pixel] || !kernels->reverse[pixel]) continue;
+            // 8x8 block from rows of 16 pixels, written into rows of 12 pixels
+            std::vector<uint8_t> want(8 * 12 * pixel, 0);
+            std::vector<uint8_t> block(8 * 12 * pixel, 0);
+            for (int32_t y = 0; y < 8; ++y) {
+                for (int32_t x = 0; x < 8; ++x) {
+                    std::memcpy(&want[(y * 12 + x) * pixel], &src[(x * 16 + y) * pixel], pixel);
+                }
+            }
+            kernels->transpose[pixel](src.data(), 16 * pixel, block.data(), 12 * pixel);
+            if (want != block) {
+                std::cout << "[FAILED] orient transpose " << simd::level_string(level)
+                          << " pixel=" << pixel << std::endl;
+                ++failed;
+            }
+            for (int32_t n : {0, 1, 7, 16, 33, 1000}) {
+                std::vector<uint8_t> reversed(n * pixel + 1, 0xcd);
+                auto done = kernels->reverse[pixel](src.data() + pixel, reversed.data(), n);
+                for (int32_t i = 0; i < done; ++i) {
+                    if (std::memcmp(&reversed[i * pixel], &src[(n - i) * pixel], pixel) != 0) {
+                        std::cout << "[FAILED] orient reverse " << simd::level_string(level)
+                                  << " pixel=" << pixel << " N=" << n << std::endl;
+                        ++failed;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // blend kernels must be same as scalar (dst * (255 - a) + color * a) / 255
+    for (auto level : levels) {
+        auto kernels = simd::blend_kernels(level);
+        if (!kernels) continue;
+        const uint8_t color[4] = {250, 7, 128, 255};
+        const int32_t n = 1000;
+        for (int32_t channels = 1; channels <= 4; ++channels) {
+            for (int32_t alpha : {0, 1, 77, 254, 255}) {
+                std::vector<uint8_t> blended(src.begin(), src.begin() + n * channels);
+                std::vector<uint8_t> masked = blended;
+                std::vector<uint8_t> filled(n * channels, 0);
+                auto done = kernels->blend[channels](blended.data(), n, color, alpha);
+                auto done_mask = kernels->blend_mask[channels](masked.data(), n, color, alpha, src.data());
+                auto done_fill = kernels->fill[channels](filled.data(), n, color);
+                bool ok = true;
+                for (int32_t i = 0; i < done * channels; ++i) {
+                    auto c = color[i % channels];
+                    ok &= blended[i] == (src[i] * (255 - alpha) + c * alpha) / 255;
+                }
+                for (int32_t i = 0; i < done_mask * channels; ++i) {
+                    auto c = color[i % channels];
+                    auto a = alpha * src[i / channels] / 255;
+                    ok &= masked[i] == (src[i] * (255 - a) + c * a) / 255;
+                }
+                for (int32_t i = 0; i < done_fill * channels; ++i) {
+                    ok &= filled[i] == color[i % channels];
+                }
+                if (!ok || done < n - 15 || done_mask < n - 15 || done_fill < n - 15) {
+                    std::cout << "[FAILED] blend " << simd::level_string(level)
+                              << " channels=" << channels << " alpha=" << alpha << std::endl;
+                    ++failed;
+                }
+            }
+        }
+    }
+
+    // convert goes through dispatched kernels
+    ImageData bgr(SEETA_AIP_FORMAT_U8BGR, 1, 641, 481, 3, src.data());
+    auto gray = convert(1, SEETA_AIP_FORMAT_U8Y, bgr);
+    cvt::convert_uimage_bgr2y(1, bgr.data<uint8_t>(), expected.data(), 641 * 481);
+    if (!std::equal(expected.begin(), expected.begin() + gray.bytes(), gray.data<uint8_t>())) {
+        std::cout << "[FAILED] convert U8BGR to U8Y" << std::endl;
+        ++failed;
+    }
+
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+
+    return 0;
+}
@@ -5,6 +5,10 @@
 #include "seeta_aip_struct.h"
 #include "seeta_aip_shape.h"
 #include "seeta_aip_dll.h"
+#include "seeta_aip_image.h"
+
+#include <cstring>
+#include <thread>
 
 
 void plot_shape(const seeta::aip::Shape &shape) {
@@ -24,6 +28,122 @@ void plot_shape(const seeta::aip::Shape &shape) {
     std::cout << std::endl;
 }
 
+static uint8_t clamp_u8(int x) { return uint8_t(x < 0 ? 0 : (x > 255 ? 255 : x)); }
+
+/**
+ * Pack same Y, U, V planes in NV12, NV21 and I420,
+ * each must survive export/import and convert to same BGR as BT.601 limited range reference.
+ */
+int check_yuv() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    const uint32_t W = 6, H = 4;
+    std::vector<uint8_t> Y(W * H), U(W * H / 4), V(W * H / 4);
+    for (uint32_t i = 0; i < Y.size(); ++i) Y[i] = uint8_t(16 + i * 9);
+    for (uint32_t i = 0; i < U.size(); ++i) U[i] = uint8_t(60 + i * 23);
+    for (uint32_t i = 0; i < V.size(); ++i) V[i] = uint8_t(200 - i * 19);
+
+    ImageData expected(SEETA_AIP_FORMAT_U8BGR, 1, W, H, 3);
+    for (uint32_t y = 0; y < H; ++y) {
+        for (uint32_t x = 0; x < W; ++x) {
+            auto uv = (y / 2) * (W / 2) + x / 2;
+            int c = 298 * (Y[y * W + x] - 16), d = U[uv] - 128, e = V[uv] - 128;
+            auto bgr = expected.data<uint8_t>() + (y * W + x) * 3;
+            bgr[0] = clamp_u8((c + 516 * d + 128) >> 8);
+            bgr[1] = clamp_u8((c - 100 * d - 208 * e + 128) >> 8);
+            bgr[2] = clamp_u8((c + 409 * e + 128) >> 8);
+        }
+    }
+
+    SEETA_AIP_IMAGE_FORMAT formats[] = {SEETA_AIP_FORMAT_U8NV12, SEETA_AIP_FORMAT_U8NV21, SEETA_AIP_FORMAT_U8I420};
+    const char *names[] = {"NV12", "NV21", "I420"};
+    for (int f = 0; f < 3; ++f) {
+        auto format = formats[f];
+        ImageData yuv(format, 1, W, H, 1);
+        if (yuv.bytes() != W * H * 3 / 2 || ImageData::GetBytes(*yuv.raw()) != W * H * 3 / 2) {
+            std::cout << "[FAILED] " << names[f] << " bytes " << yuv.bytes() << std::endl;
+            ++failed;
+            continue;
+        }
+        auto data = yuv.data<uint8_t>();
+        std::memcpy(data, Y.data(), Y.size());
+        auto chroma = data + W * H;
+        for (uint32_t i = 0; i < U.size(); ++i) {
+            switch (format) {
+                default:
+                case SEETA_AIP_FORMAT_U8NV12: chroma[2 * i] = U[i]; chroma[2 * i + 1] = V[i]; break;
+                case SEETA_AIP_FORMAT_U8NV21: chroma[2 * i] = V[i]; chroma[2 * i + 1] = U[i]; break;
+                case SEETA_AIP_FORMAT_U8I420: chroma[i] = U[i]; chroma[U.size() + i] = V[i]; break;
+            }
+        }
+
+        // round trip through C struct, all planes must be copied
+        ImageData imported;
+        imported.raw(*yuv.raw());
+        if (imported.bytes() != yuv.bytes() || std::memcmp(imported.data(), yuv.data(), yuv.bytes()) != 0) {
+            std::cout << "[FAILED] " << names[f] << " export/import lost chroma planes." << std::endl;
+            ++failed;
+        }
+
+        auto bgr = convert(1, SEETA_AIP_FORMAT_U8BGR, imported);
+        if (std::memcmp(bgr.data(), expected.data(), expected.bytes()) != 0) {
+            std::cout << "[FAILED] " << names[f] << " to BGR mismatch reference." << std::endl;
+            ++failed;
+        }
+        auto gray = convert(1, SEETA_AIP_FORMAT_U8Y, imported);
+        if (std::memcmp(gray.data(), Y.data(), Y.size()) != 0) {
+            std::cout << "[FAILED] " << names[f] << " to Y mismatch Y plane." << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+/**
+ * Strided view exported from many threads at once is packed once, copies of view share the packed pixels,
+ * and a new view of same image is packed again.
+ */
+int check_roi_export() {
+    using namespace seeta::aip;
+    int failed = 0;
+
+    ImageData image(SEETA_AIP_FORMAT_U8RGB, 1, 7, 5, 3);
+    for (uint32_t i = 0; i < image.bytes(); ++i) image.data<uint8_t>()[i] = uint8_t(i);
+    auto roi = image.roi(2, 1, 4, 3);
+    auto packed = roi.compact();
+
+    std::vector<const void *> exported(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < exported.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            auto raw = *static_cast<const ImageData &>(roi).raw();
+            exported[i] = raw.data;
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    for (auto data : exported) {
+        if (data != exported[0] || data == roi.data() || std::memcmp(data, packed.data(), packed.bytes()) != 0) {
+            std::cout << "[FAILED] roi exported from threads not packed once." << std::endl;
+            ++failed;
+            break;
+        }
+    }
+
+    auto copy = roi;
+    if (copy.raw()->data != exported[0] || roi.raw()->data != exported[0]) {
+        std::cout << "[FAILED] roi packed again at export." << std::endl;
+        ++failed;
+    }
+
+    image.data<uint8_t>()[(1 * 7 + 2) * 3] = 255;
+    auto again = image.roi(2, 1, 4, 3);
+    if (again.raw()->data == exported[0] || static_cast<const uint8_t *>(again.raw()->data)[0] != 255) {
+        std::cout << "[FAILED] new roi got packed pixels of old one." << std::endl;
+        ++failed;
+    }
+    return failed;
+}
 
 int main() {
     std::cout << "Hello, World!" << std::endl;
@@ -49,5 +169,13 @@ int main() {
     std::cout << seeta::aip::Circle({1, 2}, 10) << std::endl;
     std::cout << seeta::aip::Cube({1, 2}, {3, 4}, {5, 6}) << std::endl;
 
+    auto failed = check_yuv();
+    failed += check_roi_export();
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "seeta_aip_affine.h"
+#include "seeta_aip_image.h"
+#include "seeta_aip_alignment.h"
+#include "seeta_aip_warp.h"
+
+#include <iostream>
+#include <random>
+#include <cmath>
+
+/**
+ * per pixel float path, which affine_sample2d used before fixed point fast path
+ */
+static seeta::aip::ImageData exact_sample2d(const float *M, const seeta::aip::ImageData &image, int width, int height) {
+    seeta::aip::ImageData dst(image.format(), 1, width, height, image.channels());
+    auto C = int(image.channels());
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            auto x = M[0] * i + M[1] * j + M[2];
+            auto y = M[3] * i + M[4] * j + M[5];
+            seeta::aip::sample_uint8_pixel(image, x, y, dst.data<uint8_t>() + (j * width + i) * C, 0);
+        }
+    }
+    return dst;
+}
+
+static bool same_bytes(const seeta::aip::ImageData &a, const seeta::aip::ImageData &b) {
+    return a.bytes() == b.bytes() && std::equal(a.data<uint8_t>(), a.data<uint8_t>() + a.bytes(), b.data<uint8_t>());
+}
+
+/**
+ * @return smooth BGR image with noise, so neighbor pixels differ
+ */
+static seeta::aip::ImageData source(int width, int height) {
+    std::mt19937 rand(4399);
+    seeta::aip::ImageData image(SEETA_AIP_FORMAT_U8BGR, 1, width, height, 3);
+    auto data = image.data<uint8_t>();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            auto pixel = data + (y * width + x) * 3;
+            pixel[0] = uint8_t(127 + 90 * std::sin(x / 13.0) + int(rand() % 31) - 15);
+            pixel[1] = uint8_t(127 + 90 * std::cos(y / 17.0) + int(rand() % 31) - 15);
+            pixel[2] = uint8_t((x * 3 + y * 5) % 256);
+        }
+    }
+    return image;
+}
+
+/**
+ * Fixed point fast path must be within one of per pixel float path, and WarpMap same as fast path.
+ */
+static int check_fast_path(const seeta::aip::ImageData &image) {
+    using namespace seeta::aip;
+    int failed = 0;
+    auto W = int(image.width());
+    auto H = int(image.height());
+    auto M = affine::identity<float>();
+    stack(M, affine::translate<float>(-float(W / 2), -float(H / 2)));
+    stack(M, affine::rotate<float>(30));
+    stack(M, affine::translate<float>(W / 2, H / 2));
+    auto inv = affine::inverse(M);
+
+    auto fast = affine_sample2d(1, inv.data(), image, 0, 0, W, H);
+    auto exact = exact_sample2d(inv.data(), image, W, H);
+    int diff = 0;
+    for (size_t i = 0; i < fast.bytes(); ++i) {
+        diff = std::max(diff, std::abs(int(fast.data<uint8_t>()[i]) - int(exact.data<uint8_t>()[i])));
+    }
+    // fixed point weights may round differently by one
+    if (diff > 1) {
+        std::cout << "[FAILED] affine fast path differs from exact path by " << diff << std::endl;
+        ++failed;
+    }
+    if (!same_bytes(affine_sample2d(4, inv.data(), image, 0, 0, W, H), fast)) {
+        std::cout << "[FAILED] affine with 4 threads differs from 1 thread" << std::endl;
+        ++failed;
+    }
+
+    // compiled warp for repeated frames, same result, also when applied again into same output
+    WarpMap map(inv, W, H, W, H);
+    auto mapped = map.apply(1, image);
+    if (!same_bytes(mapped, fast)) {
+        std::cout << "[FAILED] warp map differs from affine_sample2d" << std::endl;
+        ++failed;
+    }
+    map.apply(1, image, mapped);
+    if (!same_bytes(mapped, fast)) {
+        std::cout << "[FAILED] warp map differs when applied into output" << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+/**
+ * FLOAT32 is sampled natively, INT32 with nearest pixel, and CHW plane by plane same as HWC.
+ */
+static int check_types(const seeta::aip::ImageData &image) {
+    using namespace seeta::aip;
+    int failed = 0;
+    auto M = affine::identity<float>();
+    stack(M, affine::rotate<float>(30));
+    auto inv = affine::inverse(M);
+    auto W = int(image.width());
+    auto H = int(image.height());
+    auto C = int(image.channels());
+
+    ImageData f32(SEETA_AIP_FORMAT_F32RAW, image.number(), image.width(), image.height(), image.channels());
+    for (size_t i = 0; i < image.bytes(); ++i) f32.data<float>()[i] = image.data<uint8_t>()[i];
+    auto bytes = affine_sample2d(1, inv.data(), image, 0, 0, W, H);
+    auto floats = affine_sample2d(1, inv.data(), f32, 0, 0, W, H);
+    float diff = 0;
+    for (size_t i = 0; i < bytes.bytes(); ++i) {
+        diff = std::max(diff, std::fabs(floats.data<float>()[i] - bytes.data<uint8_t>()[i]));
+    }
+    // byte path rounds to nearest and uses fixed point weights
+    if (diff > 1.5f) {
+        std::cout << "[FAILED] affine float differs from byte by " << diff << std::endl;
+        ++failed;
+    }
+
+    // int image sampled with nearest pixel, 0 outside
+    ImageData i32(SEETA_AIP_FORMAT_I32RAW, image.number(), image.width(), image.height(), image.channels());
+    for (size_t i = 0; i < image.bytes(); ++i) i32.data<int32_t>()[i] = int32_t(image.data<uint8_t>()[i]) * 1000;
+    auto ints = affine_sample2d(1, inv.data(), i32, 0, 0, W, H);
+    int mismatch = 0;
+    for (int j = 0; j < H; ++j) {
+        for (int i = 0; i < W; ++i) {
+            auto x = double(inv[0]) * i + double(inv[1]) * j + double(inv[2]) + 0.5;
+            auto y = double(inv[3]) * i + double(inv[4]) * j + double(inv[5]) + 0.5;
+            // fixed point may round other way on pixel border
+            if (std::fabs(x - std::floor(x)) < 1e-4 || std::fabs(y - std::floor(y)) < 1e-4) continue;
+            auto sx = int(std::floor(x));
+            auto sy = int(std::floor(y));
+            auto inside = sx >= 0 && sx < W && sy >= 0 && sy < H;
+            for (int c = 0; c < C; ++c) {
+                auto expected = inside ? i32.data<int32_t>()[(sy * W + sx) * C + c] : 0;
+                if (ints.data<int32_t>()[(j * W + i) * C + c] != expected) ++mismatch;
+            }
+        }
+    }
+    if (mismatch) {
+        std::cout << "[FAILED] affine int got " << mismatch << " values differ from nearest" << std::endl;
+        ++failed;
+    }
+
+    // CHW image warped plane by plane, same as HWC
+    auto chw_format = SEETA_AIP_IMAGE_FORMAT(image.format() | 0x80000);
+    auto chw = affine_sample2d(1, inv.data(), convert(1, chw_format, image), 0, 0, W, H);
+    if (chw.format() != chw_format || !same_bytes(convert(1, image.format(), chw), bytes)) {
+        std::cout << "[FAILED] affine CHW differs from HWC" << std::endl;
+        ++failed;
+    }
+
+    ImageData chw_f32(SEETA_AIP_FORMAT_CHW_F32RAW, image.number(), image.width(), image.height(), image.channels());
+    for (int c = 0; c < C; ++c) {
+        for (int k = 0; k < W * H; ++k) chw_f32.data<float>()[c * W * H + k] = f32.data<float>()[k * C + c];
+    }
+    auto chw_floats = affine_sample2d(1, inv.data(), chw_f32, 0, 0, W, H);
+    float chw_diff = 0;
+    for (int c = 0; c < C; ++c) {
+        for (int k = 0; k < W * H; ++k) {
+            chw_diff = std::max(chw_diff, std::fabs(chw_floats.data<float>()[c * W * H + k] -
+                                                    floats.data<float>()[k * C + c]));
+        }
+    }
+    if (chw_diff > 1e-4f) {
+        std::cout << "[FAILED] affine CHW float differs from HWC by " << chw_diff << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+/**
+ * Batched alignment crop must be same as per face affine_sample2d.
+ */
+static int check_alignment_crop(const seeta::aip::ImageData &image) {
+    using namespace seeta::aip;
+    int failed = 0;
+    float points[] = {38.3f, 51.7f, 73.5f, 51.5f, 56.0f, 71.7f, 41.5f, 92.4f, 70.7f, 92.2f};
+    std::vector<SeetaAIPPoint> landmarks;
+    for (int n = 0; n < 2; ++n) {
+        for (int i = 0; i < 5; ++i) {
+            landmarks.push_back({points[i * 2] * (1.5f + n) + 20, points[i * 2 + 1] * (1.5f + n) + 10});
+        }
+    }
+    std::vector<SeetaAIPObject> objects(2, SeetaAIPObject());
+    for (int n = 0; n < 2; ++n) {
+        objects[n].shape.landmarks.data = &landmarks[n * 5];
+        objects[n].shape.landmarks.size = 5;
+    }
+    ImageData batch(image.format(), 2, 112, 112, image.channels());
+    float M[18];
+    alignment_crop(2, image, objects.data(), 2, points, 5, batch, M);
+    for (int n = 0; n < 2; ++n) {
+        auto crop = affine_sample2d(1, &M[n * 9], image, 0, 0, 112, 112);
+        if (!std::equal(crop.data<uint8_t>(), crop.data<uint8_t>() + crop.bytes(),
+                        batch.data<uint8_t>() + n * crop.bytes())) {
+            std::cout << "[FAILED] alignment crop " << n << " differs from affine_sample2d" << std::endl;
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+    for (auto size : {std::make_pair(320, 240), std::make_pair(97, 131)}) {
+        auto image = source(size.first, size.second);
+        failed += check_fast_path(image);
+        failed += check_types(image);
+        failed += check_alignment_crop(image);
+    }
+    if (failed) {
+        std::cout << failed << " checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return 0;
+}